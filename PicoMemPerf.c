@@ -23,12 +23,32 @@ SOFTWARE.
 */
 
 #include "hardware/clocks.h"
+#include "hardware/structs/m33.h"
 #include "hardware/structs/qmi.h"
 #include "hardware/structs/xip_ctrl.h"
 #include "hardware/sync.h"
 #include "pico/stdlib.h"
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#endif
 #include <stdio.h>
+#include <stdlib.h>
 #include <malloc.h>
+#include <string.h>
+
+#include "PicoMemPerf.h"
+#include "alloc_bench.h"
+#include "psram_bench.h"
+#include "latency_hist.h"
+#include "isolation.h"
+#include "bench_shell.h"
+#include "bench_plan.h"
+#include "run_header.h"
+#include "result_log.h"
+#include "bench_check.h"
+#include "bench_monitor.h"
+#include "bench_shmoo.h"
+#include "bench_checkpoint.h"
 
 
 //  PSRAM setup routines from Waveshare Core2350B demo code
@@ -83,37 +103,59 @@ SOFTWARE.
 // from psram datasheet - max Freq at 3.3v
 #define PSRAM_MAX_SCK_HZ 109000000.f
 
-// Location /address where PSRAM starts
-#define PSRAM_LOCATION          _u(0x11000000)      //  0x11000000
-#define PSRAM_LOCATION_NOCAHE   _u(0x14000000)      //  0x14000000
-                                   
-static size_t _psram_size = 0;
+size_t _psram_size = 0;
+uint8_t s_psram_kgd = 0;
+uint8_t s_psram_eid = 0;
 
 
-static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
+void psram_timing_default(uint32_t clock_hz, int *clock_divider, int *rxdelay)
 {
-    gpio_set_function(psram_cs_pin, GPIO_FUNC_XIP_CS1);
-
-    size_t psram_size = 0;
-
     const int max_psram_freq = 133000000;
-    const int clock_hz = clock_get_hz(clk_sys);
     int clockDivider = (clock_hz + max_psram_freq - 1) / max_psram_freq;
     if (clockDivider == 1 && clock_hz > 100000000) {
         clockDivider = 2;
     }
-    int rxdelay = clockDivider;
+    *clock_divider = clockDivider;
+    *rxdelay = clockDivider;
     if (clock_hz / clockDivider > 100000000) {
-        rxdelay += 1;
+        *rxdelay += 1;
     }
+}
 
+uint32_t psram_timing(uint32_t clock_hz, int clock_divider, int rxdelay)
+{
     // - Max select must be <= 8us.  The value is given in multiples of 64 system clocks.
     // - Min deselect must be >= 18ns.  The value is given in system clock cycles - ceil(divisor / 2).
     const int clock_period_fs = 1000000000000000ll / clock_hz;
-    const int maxSelect = (125 * 1000000) / clock_period_fs;  // 125 = 8000ns / 64
-    const int minDeselect = (18 * 1000000 + (clock_period_fs - 1)) / clock_period_fs - (clockDivider + 1) / 2;
+    int maxSelect = (125 * 1000000) / clock_period_fs;  // 125 = 8000ns / 64
+    int minDeselect = (18 * 1000000 + (clock_period_fs - 1)) / clock_period_fs - (clock_divider + 1) / 2;
+
+    //  Only matters away from the defaults, e.g. a shmoo
+    maxSelect = (maxSelect > 63) ? 63 : maxSelect;
+    minDeselect = (minDeselect < 0) ? 0 : (minDeselect > 31) ? 31 : minDeselect;
+
+    return (QMI_M1_TIMING_PAGEBREAK_VALUE_1024 << QMI_M1_TIMING_PAGEBREAK_LSB) | // Break between pages.
+        (1 << QMI_M1_TIMING_COOLDOWN_LSB) | (rxdelay << QMI_M1_TIMING_RXDELAY_LSB) |
+        (maxSelect << QMI_M1_TIMING_MAX_SELECT_LSB) |  // In units of 64 system clock cycles. PSRAM says 8us max. 8 / 0.00752 /64
+                                              // = 16.62
+        (minDeselect << QMI_M1_TIMING_MIN_DESELECT_LSB) | // In units of system clock cycles. PSRAM says 50ns.50 / 7.52 = 6.64
+        (clock_divider << QMI_M1_TIMING_CLKDIV_LSB);
+}
+
+static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
+{
+    gpio_set_function(psram_cs_pin, GPIO_FUNC_XIP_CS1);
+
+    size_t psram_size = 0;
 
-    stdio_printf("Max Select: %d, Min Deselect: %d, clock divider: %d\n", maxSelect, minDeselect, clockDivider);
+    const int clock_hz = clock_get_hz(clk_sys);
+    int clockDivider, rxdelay;
+    psram_timing_default(clock_hz, &clockDivider, &rxdelay);
+    const uint32_t timing = psram_timing(clock_hz, clockDivider, rxdelay);
+
+    stdio_printf("Max Select: %d, Min Deselect: %d, clock divider: %d\n",
+                 (int)((timing & QMI_M1_TIMING_MAX_SELECT_BITS) >> QMI_M1_TIMING_MAX_SELECT_LSB),
+                 (int)((timing & QMI_M1_TIMING_MIN_DESELECT_BITS) >> QMI_M1_TIMING_MIN_DESELECT_LSB), clockDivider);
 
     uint32_t intr_stash = save_and_disable_interrupts();
 
@@ -221,13 +263,7 @@ static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
     // Disable direct csr.
     qmi_hw->direct_csr &= ~(QMI_DIRECT_CSR_ASSERT_CS1N_BITS | QMI_DIRECT_CSR_EN_BITS);
 
-    qmi_hw->m[1].timing =
-        (QMI_M1_TIMING_PAGEBREAK_VALUE_1024 << QMI_M1_TIMING_PAGEBREAK_LSB) | // Break between pages.
-        (1 << QMI_M1_TIMING_COOLDOWN_LSB) | (rxdelay << QMI_M1_TIMING_RXDELAY_LSB) |
-        (maxSelect << QMI_M1_TIMING_MAX_SELECT_LSB) |  // In units of 64 system clock cycles. PSRAM says 8us max. 8 / 0.00752 /64
-                                              // = 16.62
-        (minDeselect << QMI_M1_TIMING_MIN_DESELECT_LSB) | // In units of system clock cycles. PSRAM says 50ns.50 / 7.52 = 6.64
-        (clockDivider << QMI_M1_TIMING_CLKDIV_LSB);
+    qmi_hw->m[1].timing = timing;
     
     qmi_hw->m[1].rfmt = (QMI_M1_RFMT_PREFIX_WIDTH_VALUE_Q << QMI_M1_RFMT_PREFIX_WIDTH_LSB) |
                          (QMI_M1_RFMT_ADDR_WIDTH_VALUE_Q << QMI_M1_RFMT_ADDR_WIDTH_LSB) |
@@ -267,6 +303,8 @@ static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
     xip_ctrl_hw->ctrl |= XIP_CTRL_WRITABLE_M1_BITS;
     restore_interrupts(intr_stash);
     printf("PSRAM ID: %x %x\n", kgd, eid);
+    s_psram_kgd = kgd;
+    s_psram_eid = eid;
     return psram_size;
 }
 
@@ -288,140 +326,410 @@ uint32_t getFreeHeap(void)
 }
 
 
+//  PSRAM sections
 
-//  Test structures
+extern uint8_t __psram_data_start__[], __psram_data_end__[], __psram_data_source__[];
+extern uint8_t __psram_bss_start__[], __psram_bss_end__[], __psram_heap_start__[];
+
+bool psram_sections_init(void)
+{
+    //  Linker script assumes 8 MiB, make sure the part we found is big enough
+    if ((uint32_t)(__psram_heap_start__ - (uint8_t *)PSRAM_LOCATION) > _psram_size)
+    {
+        printf("PSRAM sections don't fit: %d > %d\n", (int)(__psram_heap_start__ - (uint8_t *)PSRAM_LOCATION), (int)_psram_size);
+        return false;
+    }
+
+    memcpy(__psram_data_start__, __psram_data_source__, __psram_data_end__ - __psram_data_start__);
+    memset(__psram_bss_start__, 0, __psram_bss_end__ - __psram_bss_start__);
+
+    return true;
+}
+
+
+//  PSRAM heap functions
+
+static tlsf_heap s_psram_heap;
+
+//  TLSF over the detected PSRAM after the PSRAM sections, control structure in SRAM
+bool psram_heap_init(void)
+{
+    size_t sections_size = __psram_heap_start__ - (uint8_t *)PSRAM_LOCATION;
+    if (_psram_size <= sections_size)
+    {
+        return false;
+    }
+
+    return tlsf_create(&s_psram_heap, __psram_heap_start__, _psram_size - sections_size);
+}
+
+void *psram_malloc(size_t size)
+{
+    return tlsf_malloc(&s_psram_heap, size);
+}
+
+void psram_free(void *ptr)
+{
+    tlsf_free(&s_psram_heap, ptr);
+}
+
+void *psram_realloc(void *ptr, size_t size)
+{
+    return tlsf_realloc(&s_psram_heap, ptr, size);
+}
+
+void psram_heap_stats(tlsf_stats *stats)
+{
+    tlsf_get_stats(&s_psram_heap, stats);
+}
+
+// total size of PSRAM heap
+uint32_t getTotalPsramHeap(void)
+{
+    tlsf_stats stats;
+    tlsf_get_stats(&s_psram_heap, &stats);
+    return stats.total_size;
+}
+
+// available PSRAM heap size
+uint32_t getFreePsramHeap(void)
+{
+    return getTotalPsramHeap() - s_psram_heap.used_size;
+}
 
-#define TEST_SIZE (16 * 1024)       //  16 * 4 = 64K
-#define LOOP_SCALE (200)            //  LOOP_SCALE * 100
+
+
+//  Test structures
 
 uint32_t s_test_memory[TEST_SIZE];      
 const uint32_t s_testROM[TEST_SIZE];
+uint32_t s_psram_test_memory[TEST_SIZE] __psram;
 
+#define PSRAM_TEST_MEMORY           s_psram_test_memory
+#define PSRAM_TEST_MEMORY_NOCACHE   ((uint32_t *)PSRAM_NOCACHE(s_psram_test_memory))
 
-typedef struct 
-{
-    uint32_t *buffer;
-    uint32_t buffer_size;
-    int loop_scale;
-    bool read;
-    bool random;
-    char * test_name;
-    uint64_t result;
-} memory_test_config;
 
 memory_test_config s_memory_test_config[] = 
 {
     //  Sequential Read
     { s_test_memory, TEST_SIZE, LOOP_SCALE, true, false, "SEQ SRAM READ", 0 },
     { (uint32_t *)s_testROM, TEST_SIZE, LOOP_SCALE, true, false, "SEQ ROM READ", 0 },
-    { (uint32_t *)PSRAM_LOCATION, TEST_SIZE, LOOP_SCALE, true, false, "SEQ PSRAM READ", 0 },
-    { (uint32_t *)PSRAM_LOCATION_NOCAHE, TEST_SIZE, LOOP_SCALE, true, false, "SEQ PSRAM NOCACHE READ", 0 },
+    { PSRAM_TEST_MEMORY, TEST_SIZE, LOOP_SCALE, true, false, "SEQ PSRAM READ", 0 },
+    { PSRAM_TEST_MEMORY_NOCACHE, TEST_SIZE, LOOP_SCALE, true, false, "SEQ PSRAM NOCACHE READ", 0 },
 
     //  Random Read
     { s_test_memory, TEST_SIZE, LOOP_SCALE, true, true, "RND SRAM READ", 0 },
     { (uint32_t *)s_testROM, TEST_SIZE, LOOP_SCALE, true, true, "RND ROM READ", 0 },
-    { (uint32_t *)PSRAM_LOCATION, TEST_SIZE, LOOP_SCALE, true, true, "RND PSRAM READ", 0 },
-    { (uint32_t *)PSRAM_LOCATION_NOCAHE, TEST_SIZE, LOOP_SCALE, true, true, "RND PSRAM NOCACHE READ", 0 },
+    { PSRAM_TEST_MEMORY, TEST_SIZE, LOOP_SCALE, true, true, "RND PSRAM READ", 0 },
+    { PSRAM_TEST_MEMORY_NOCACHE, TEST_SIZE, LOOP_SCALE, true, true, "RND PSRAM NOCACHE READ", 0 },
 
 
     { s_test_memory, TEST_SIZE, LOOP_SCALE, false, false, "SEQ SRAM WRITE", 0 },
-    { (uint32_t *)PSRAM_LOCATION, TEST_SIZE, LOOP_SCALE, false, false, "SEQ PSRAM WRITE", 0 },
-    { (uint32_t *)PSRAM_LOCATION_NOCAHE, TEST_SIZE, LOOP_SCALE, false, false, "SEQ PSRAM NOCACHE WRITE", 0 },
+    { PSRAM_TEST_MEMORY, TEST_SIZE, LOOP_SCALE, false, false, "SEQ PSRAM WRITE", 0 },
+    { PSRAM_TEST_MEMORY_NOCACHE, TEST_SIZE, LOOP_SCALE, false, false, "SEQ PSRAM NOCACHE WRITE", 0 },
 
     { s_test_memory, TEST_SIZE, LOOP_SCALE, false, true, "RND SRAM WRITE", 0 },
-    { (uint32_t *)PSRAM_LOCATION, TEST_SIZE, LOOP_SCALE, false, true, "RND PSRAM WRITE", 0 },
-    { (uint32_t *)PSRAM_LOCATION_NOCAHE, TEST_SIZE, LOOP_SCALE, false, true, "RND PSRAM NOCACHE WRITE", 0 }
+    { PSRAM_TEST_MEMORY, TEST_SIZE, LOOP_SCALE, false, true, "RND PSRAM WRITE", 0 },
+    { PSRAM_TEST_MEMORY_NOCACHE, TEST_SIZE, LOOP_SCALE, false, true, "RND PSRAM NOCACHE WRITE", 0 },
+
+    //  Non power of two size, and a window in the middle of PSRAM (read only, it's in the heap)
+    { PSRAM_TEST_MEMORY, 12 * 1024, LOOP_SCALE, true, true, "RND PSRAM READ 48K", 0, 0, 0 },
+    { (uint32_t *)PSRAM_LOCATION, TEST_SIZE, LOOP_SCALE, true, true, "RND PSRAM READ +4M", 0, 0, 4 * 1024 * 1024 }
 
 };
 
-uint32_t s_value = 0;
+const int s_memory_test_count = sizeof(s_memory_test_config) / sizeof(memory_test_config);
+
+//  Start of the test window, NULL if it runs off the end of the PSRAM we found
+uint32_t *test_window(const memory_test_config *config)
+{
+    uint8_t *window = (uint8_t *)config->buffer + config->buffer_offset;
+    uintptr_t psram = ((uintptr_t)window) & ~XIP_NOCACHE_OFFSET;
+
+    if ((psram >= PSRAM_LOCATION) && (psram < PSRAM_LOCATION + 0x01000000) &&
+        ((psram - PSRAM_LOCATION) + (config->buffer_size * sizeof(uint32_t)) > _psram_size))
+    {
+        return NULL;
+    }
+
+    return (uint32_t *)window;
+}
+
+void __time_critical_func(run_test)(memory_test_config *config)
+{
+    uint32_t *window = test_window(config);
+
+    if (window == NULL)
+    {
+        printf("Skipped Test, %s\n", config->test_name);
+        return;
+    }
+
+    isolate_begin();
+    config->overhead = calibrate_overhead(config->buffer_size, config->loop_scale, config->read, config->random);
+    config->result = memory_test(window, config->buffer_size, config->loop_scale, config->read, config->random);
+    isolate_end();
+
+    uint64_t corrected = (config->result > config->overhead) ? (config->result - config->overhead) : 0;
+    result_record record;
+
+    result_begin(&record, "Test");
+    result_str(&record, "test", config->test_name);
+    result_hex(&record, "window", (uint32_t)(uintptr_t)window);
+    result_u64(&record, "size", config->buffer_size);
+    result_u64(&record, "result", config->result);
+    result_label(&record, "overhead");
+    result_u64(&record, "overhead", config->overhead);
+    result_label(&record, "corrected");
+    result_u64(&record, "corrected", corrected);
+    result_end(&record);
+}
+
+void __time_critical_func(run_tests)(void)
+{
+    for (int i = 0; i < s_memory_test_count; i++)
+    {
+        run_test(&s_memory_test_config[i]);
+    }
+}
+
+//  Cycle counter
 
-uint64_t __time_critical_func(memory_test)(uint32_t *buffer, uint32_t buffer_size, int loop_scale, bool read, bool rnd)
+void cycle_counter_init(void)
 {
-    uint64_t start = time_us_64();
-    int loop_count = 100 * loop_scale;
+    m33_hw->demcr |= M33_DEMCR_TRCENA_BITS;
+    m33_hw->dwt_cyccnt = 0;
+    m33_hw->dwt_ctrl |= M33_DWT_CTRL_CYCCNTENA_BITS;
+}
+
+//  Cycles taken by back to back counter reads, subtracted from every sample
+uint32_t __time_critical_func(cycle_counter_overhead)(void)
+{
+    uint32_t overhead = 0xFFFFFFFF;
+
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t start = cycle_count();
+        __asm volatile("" ::: "memory");
+        uint32_t cycles = cycle_count() - start;
+        if (cycles < overhead)
+        {
+            overhead = cycles;
+        }
+    }
+
+    return overhead;
+}
+
+
+//  Per access latency sampling
+
+static latency_hist s_latency_hist;
+
+//  Times samples batches of batch accesses with the cycle counter, indices are
+//  worked out before the timed region so the LCG isn't in the samples
+void __time_critical_func(latency_test)(uint32_t *buffer, uint32_t buffer_size, uint32_t samples, uint32_t batch, bool read, bool rnd, latency_hist *hist)
+{
+    uint32_t indices[LATENCY_MAX_BATCH];
+    uint32_t seed_value = 0xDEADBEEF;
+    uint32_t position = 0;
     uint32_t value = 0;
+    uint32_t timer_overhead = cycle_counter_overhead();
 
-    if (rnd)
+    if ((batch == 0) || (batch > LATENCY_MAX_BATCH))
     {
-        uint32_t seed_value = 0xDEADBEEF;
+        batch = LATENCY_MAX_BATCH;
+    }
+
+    latency_hist_reset(hist);
+
+    for (uint32_t sample = 0; sample < samples; sample++)
+    {
+        for (uint32_t b = 0; b < batch; b++)
+        {
+            if (rnd)
+            {
+                seed_value = (seed_value * 1103515245U + 12345U);
+                indices[b] = is_power_of_two(buffer_size) ? (seed_value & (buffer_size - 1)) : range_reduce(seed_value, buffer_size);
+            }
+            else
+            {
+                indices[b] = position;
+                position = (position + 1 < buffer_size) ? position + 1 : 0;
+            }
+        }
+
+        __asm volatile("" ::: "memory");
+        uint32_t start = cycle_count();
 
-        //  Random
         if (read)
         {
-            //  Read
-            for (int loop = 0; loop < loop_count; loop++)
+            for (uint32_t b = 0; b < batch; b++)
             {
-                for (int i = 0; i < buffer_size; i++)
-                {
-                    seed_value = (seed_value * 1103515245U + 12345U);
-                    value += buffer[seed_value & (buffer_size - 1)];
-                }
+                value += buffer[indices[b]];
             }
         }
         else
         {
-            //  Write
-            for (int loop = 0; loop < loop_count; loop++)
+            for (uint32_t b = 0; b < batch; b++)
             {
-                for (int i = 0; i < buffer_size; i++)
-                {
-                    seed_value = (seed_value * 1103515245U + 12345U);
-                    buffer[seed_value & (buffer_size - 1)] = value++;
-                }
+                buffer[indices[b]] = value++;
             }
         }
+
+        //  The loads have to land before the end stamp
+        KEEP_REGISTER(value);
+        __asm volatile("" ::: "memory");
+        uint32_t cycles = cycle_count() - start;
+
+        latency_hist_add(hist, ((cycles > timer_overhead) ? (cycles - timer_overhead) : 0) / batch);
     }
-    else
+
+    s_value = value;
+}
+
+void print_latency_hist(const char *name, const latency_hist *hist, uint32_t batch)
+{
+    result_record record;
+
+    result_begin(&record, "Latency");
+    result_str(&record, "test", name);
+    result_u64(&record, "samples", hist->count);
+    result_u64(&record, "batch", batch);
+    result_u64(&record, "min", hist->min);
+    result_u64(&record, "p50", latency_hist_percentile(hist, 0.5f));
+    result_u64(&record, "p99", latency_hist_percentile(hist, 0.99f));
+    result_u64(&record, "p99_9", latency_hist_percentile(hist, 0.999f));
+    result_u64(&record, "max", hist->max);
+    result_u64(&record, "mean", latency_hist_mean(hist));
+    result_end(&record);
+
+    for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS; i++)
     {
-        //  Seqential
-        if (read)
+        if (hist->counts[i] != 0)
         {
-            //  Read
-            for (int loop = 0; loop < loop_count; loop++)
-            {
-                for (int i = 0; i < buffer_size; i++)
-                {
-                    value += buffer[i];
-                }
-            }
+            result_begin(&record, "Latency bucket");
+            result_str(&record, "test", name);
+            result_u64(&record, "low", latency_hist_bucket_low(i));
+            result_u64(&record, "high", latency_hist_bucket_high(i));
+            result_u64(&record, "count", hist->counts[i]);
+            result_end(&record);
         }
-        else
+    }
+}
+
+void run_latency_test(const memory_test_config *config, uint32_t samples, uint32_t batch)
+{
+    uint32_t *window = test_window(config);
+
+    if (window == NULL)
+    {
+        return;
+    }
+
+    isolate_begin();
+    latency_test(window, config->buffer_size, samples, batch, config->read, config->random, &s_latency_hist);
+    isolate_end();
+    print_latency_hist(config->test_name, &s_latency_hist, batch);
+}
+
+void print_latency_header(void)
+{
+    result_csv_line("Latency, test, samples, batch, min, p50, p99, p99.9, max, mean, cycles at, %d\n", (int)clock_get_hz(clk_sys));
+}
+
+void run_latency_tests(uint32_t samples, uint32_t batch)
+{
+    print_latency_header();
+
+    for (int i = 0; i < s_memory_test_count; i++)
+    {
+        run_latency_test(&s_memory_test_config[i], samples, batch);
+    }
+}
+
+//  A/B report of how much stdio / interrupt activity perturbs each test, normal
+//  runs and isolated runs alternate so any drift hits both the same way
+#define ISOLATION_AB_MAX_TESTS      32
+
+void run_isolation_ab(uint32_t flags, int loop_scale, int repetitions)
+{
+    static uint64_t normal[ISOLATION_AB_MAX_TESTS];
+    static uint64_t isolated[ISOLATION_AB_MAX_TESTS];
+    uint32_t previous_mode = isolation_get_mode();
+    int count = s_memory_test_count;
+
+    if (count > ISOLATION_AB_MAX_TESTS)
+    {
+        count = ISOLATION_AB_MAX_TESTS;
+    }
+
+    memset(normal, 0, sizeof(normal));
+    memset(isolated, 0, sizeof(isolated));
+
+    for (int rep = 0; rep < repetitions; rep++)
+    {
+        for (int i = 0; i < count; i++)
         {
-            //  Write
-            for (int loop = 0; loop < loop_count; loop++)
+            memory_test_config *config = &s_memory_test_config[i];
+            uint32_t *window = test_window(config);
+
+            if (window == NULL)
             {
-                for (int i = 0; i < buffer_size; i++)
-                {
-                    buffer[i] = value++;
-                }
+                continue;
             }
+
+            //  A, output goes straight out between tests
+            isolation_set_mode(0);
+            normal[i] += memory_test(window, config->buffer_size, loop_scale, config->read, config->random);
+            printf("Isolation A, %s, %d\n", config->test_name, rep);
+
+            //  B, isolated
+            isolation_set_mode(flags);
+            isolate_begin();
+            isolated[i] += memory_test(window, config->buffer_size, loop_scale, config->read, config->random);
+            isolate_end();
         }
     }
 
-    uint64_t delta = time_us_64() - start;
+    isolation_set_mode(previous_mode);
 
-    s_value = value;
+    printf("Isolation AB, test, normal, isolated, removed, removed_pct_x100, mode, 0x%02lX, loop_scale, %d\n", (long unsigned int)flags, loop_scale);
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t normal_us = normal[i] / repetitions;
+        uint64_t isolated_us = isolated[i] / repetitions;
+        int64_t removed = (int64_t)normal_us - (int64_t)isolated_us;
 
-    return delta;
+        printf("Isolation AB, %s, %d, %d, %d, %d\n", s_memory_test_config[i].test_name, (int)normal_us, (int)isolated_us, (int)removed,
+               (normal_us != 0) ? (int)((removed * 10000) / (int64_t)normal_us) : 0);
+    }
+    isolation_flush();
 }
 
-void __time_critical_func(run_tests)(void)
+//  True if the window lies in a buffer that is only ever used for tests
+static bool test_window_writable(const uint32_t *window, uint32_t words)
 {
-    for (int i = 0; i < (sizeof(s_memory_test_config) / sizeof(memory_test_config)); i++)
-    {
-        s_memory_test_config[i].result = memory_test(s_memory_test_config[i].buffer, s_memory_test_config[i].buffer_size, s_memory_test_config[i].loop_scale, s_memory_test_config[i].read, s_memory_test_config[i].random);
+    const uint32_t *buffers[] = { s_test_memory, s_psram_test_memory, PSRAM_TEST_MEMORY_NOCACHE };
 
-        printf("Test, %s, 0x%08lX, %d, %d\n", s_memory_test_config[i].test_name, (long unsigned int)s_memory_test_config[i].buffer, (int)(s_memory_test_config[i].buffer_size), (int)(s_memory_test_config[i].result));
+    for (int i = 0; i < (sizeof(buffers) / sizeof(buffers[0])); i++)
+    {
+        if ((window >= buffers[i]) && (window + words <= buffers[i] + TEST_SIZE))
+        {
+            return true;
+        }
     }
+    return false;
 }
 
 void __time_critical_func(test_mem)(void)
 {
-    for (int i = 0; i < (sizeof(s_memory_test_config) / sizeof(memory_test_config)); i++)
+    for (int i = 0; i < s_memory_test_count; i++)
     {
-        //  Skip tests in Flash memory space
-        if ((s_memory_test_config[i].buffer < (uint32_t *)0x10000000) || (s_memory_test_config[i].buffer >= (uint32_t *)0x10000000))
+        uint32_t *window = test_window(&s_memory_test_config[i]);
+
+        //  Skip flash, and windows over the PSRAM heap or anything else that's live
+        if ((window != NULL) && test_window_writable(window, s_memory_test_config[i].buffer_size))
         {
             uint32_t value = 0xDEADBEEF;
             uint32_t buffer_size = s_memory_test_config[i].buffer_size;
@@ -429,8 +737,8 @@ void __time_critical_func(test_mem)(void)
 
             for (int x = 0; x < buffer_size; x++)
             {
-                s_memory_test_config[i].buffer[x] = value;
-                if (s_memory_test_config[i].buffer[x] != value)
+                window[x] = value;
+                if (window[x] != value)
                 {
                     result = false;
                     break;
@@ -455,11 +763,99 @@ void __time_critical_func(test_mem)(void)
 
 #define VREG_VSEL         VREG_VOLTAGE_1_20
 
+//  Set to 1 to run the random kernels from a precomputed SRAM index table
+#define USE_INDEX_TABLE   0
+
+//  ISOLATE_* flags for the timed regions, 0 to print as we go
+#define ISOLATION_MODE      0
+
+//  Result records as csv, json or binary, the "format" shell command changes it
+#define RESULT_FORMAT       RESULT_FORMAT_CSV
+
+//  Result records straight to stdio, binary ones without CRLF translation
+static void result_stdio_write(const void *data, size_t length)
+{
+    stdio_put_string((const char *)data, (int)length, false, result_get_format() != RESULT_FORMAT_BINARY);
+}
+
+//  Keep every result in the flash log as well, the "log" shell command turns it on / off
+#define RESULT_LOG_ENABLE   1
+
+//  Wait this long for a USB terminal before carrying on without one
+#define CONNECT_TIMEOUT_MS  30000
+
+//  Run everything once at start up, before the shell prompt
+#define SHELL_AUTORUN       1
+
+//  Self check against the golden baseline at start up, when there is one
+#define SELF_CHECK_AUTORUN  1
+
+//  Background monitoring from start up, for soaks, see bench_monitor.h
+#define MONITOR_AUTOSTART   0
+
+//  After a watchdog reset, report the point that hung and finish its sweep
+static bool resume_sweep(void)
+{
+    uint8_t data[CHECKPOINT_DATA_SIZE];
+    checkpoint_kind kind;
+    uint32_t point;
+
+    if (!checkpoint_pending(&kind, &point, data, sizeof(data)))
+    {
+        return false;
+    }
+
+    checkpoint_report_hang(kind, point);
+    switch (kind)
+    {
+        case CHECKPOINT_SHMOO:  bench_shmoo_resume(data, point); break;
+        case CHECKPOINT_PLAN:   bench_plan_resume(data, point); break;
+        case CHECKPOINT_SWEEP:  bench_plan_resume_sweep(data, point); break;
+        case CHECKPOINT_BER:    break;                  //  Passes before the hang are in the log
+        default:                break;
+    }
+    return true;
+}
+
+//  The full benchmark run, the "all" shell command
+void run_all(void)
+{
+    print_run_header();
+
+    //  Run the tests
+    isolation_set_mode(ISOLATION_MODE);
+    run_tests();
+
+    //  Tail latency of the same tests
+    run_latency_tests(LATENCY_SAMPLES, LATENCY_BATCH);
+    isolation_set_mode(0);
+
+    //  How much the isolation changes the results
+    run_isolation_ab(ISOLATION_AB_MODE, ISOLATION_AB_LOOPS, ISOLATION_AB_REPS);
+
+    //  Allocator benchmarks
+    run_alloc_bench();
+    run_tier_bench();
+    run_pool_bench();
+
+    //  PSRAM access strategies
+    run_page_cache_bench();
+    run_stream_bench();
+    run_write_combine_bench();
+
+    //  PSRAM address heatmap
+    heatmap_config heatmap = { HEATMAP_WINDOW_WORDS, HEATMAP_STEP_BYTES, HEATMAP_LOOP_SCALE, true };
+    run_heatmap(&heatmap);
+}
+
 int __time_critical_func(main)()
 {
     stdio_init_all();
     printf("stdio_init_all\n");
 
+    result_set_writer(result_stdio_write);
+    result_set_format(RESULT_FORMAT);
+
 #if 0
     //  If we want to try different Sys Clocks
 
@@ -475,14 +871,20 @@ int __time_critical_func(main)()
     printf("Sys Clock changed!\n");
 #endif
 
-    //  Wait a bit so we can connect to serial monitor
-    sleep_ms(4000);
+    //  Wait for the serial monitor to connect, or give up and run anyway
+#if LIB_PICO_STDIO_USB
+    absolute_time_t connect_timeout = make_timeout_time_ms(CONNECT_TIMEOUT_MS);
+    while (!stdio_usb_connected() && !time_reached(connect_timeout))
+    {
+        sleep_ms(100);
+    }
+#endif
     printf("Starting!\n");
-    sleep_ms(1000);
 
     //  Get the basic system info
     int clock_hz = clock_get_hz(clk_sys);
     _psram_size = setup_psram(RP2350_XIP_CSI_PIN);
+    psram_sections_init();
 
     size_t free_heap = getFreeHeap();
     //  If we want to test malloc'd memory
@@ -491,16 +893,59 @@ int __time_critical_func(main)()
 
     printf("_psram_size, %d, clock_hz, %d, free_heap, %d, free_heap_after, %d\n", _psram_size, clock_hz, free_heap, free_heap_after);
 
+    if (psram_heap_init())
+    {
+        printf("psram_heap, %d, free_psram_heap, %d\n", (int)getTotalPsramHeap(), (int)getFreePsramHeap());
+    }
+    else
+    {
+        printf("psram_heap, none\n");
+    }
+
     //  Check memory
     test_mem();
 
-    //  Run the tests
-    run_tests();
+#if USE_INDEX_TABLE
+    //  Random kernels read their indices from SRAM instead of running the LCG
+    index_table_init(TEST_SIZE);
+#endif
+
+    cycle_counter_init();
+    result_log_init(RESULT_LOG_ENABLE);
 
-    //  Loop
-    while (true)
+    //  A sweep the watchdog stopped carries on after the point that hung, and
+    //  the board goes straight to the shell afterwards
+    bool resumed = resume_sweep();
+
+#if SELF_CHECK_AUTORUN
+    static golden_baseline s_golden;
+    if (!resumed && bench_check_load(&s_golden))
     {
-        printf("Loop!\n");
-        sleep_ms(10000);
+        self_check_bands bands = { SELF_CHECK_DEGRADED_PCT, SELF_CHECK_FAIL_PCT };
+        bench_check_run(&bands);
+    }
+#endif
+
+#if SHELL_AUTORUN
+    //  A plan saved to flash replaces the built in run
+    if (!resumed)
+    {
+        if (bench_plan_load_flash(&s_bench_plan))
+        {
+            bench_plan_run(&s_bench_plan);
+        }
+        else
+        {
+            run_all();
+        }
     }
+#endif
+    result_log_flush();
+
+#if MONITOR_AUTOSTART
+    bench_monitor_start(MONITOR_INTERVAL_S);
+#endif
+
+    //  Commands from the terminal, and the monitor when it's on
+    bench_shell_run();
 }
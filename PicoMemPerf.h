@@ -0,0 +1,140 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Shared definitions between PicoMemPerf.c and the benchmark modules
+
+#ifndef PICOMEMPERF_H
+#define PICOMEMPERF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "hardware/structs/m33.h"
+#include "tlsf.h"
+#include "mem_kernels.h"
+#include "isolation.h"
+#include "result_out.h"
+
+// Location /address where PSRAM starts
+#define PSRAM_LOCATION          _u(0x11000000)      //  0x11000000
+#define PSRAM_LOCATION_NOCAHE   (PSRAM_LOCATION + XIP_NOCACHE_OFFSET)      //  0x15000000
+
+//  Same XIP address seen through the uncached window (0x10... -> 0x14...)
+#define XIP_NOCACHE_OFFSET      _u(0x04000000)
+#define PSRAM_NOCACHE(ptr)      ((void *)((uint8_t *)(ptr) + XIP_NOCACHE_OFFSET))
+
+//  Globals placed in PSRAM by psram_sections.ld, only valid after setup_psram()
+//  and psram_sections_init()
+#define __psram                 __attribute__((section(".psram_bss")))
+#define __psram_data            __attribute__((section(".psram_data")))
+
+extern size_t _psram_size;
+extern uint8_t s_psram_kgd;             //  Read ID known good die / EID bytes
+extern uint8_t s_psram_eid;
+
+//  QMI M1 timing setup_psram() programs for a clock, and the divider and RX
+//  delay it picks.  Anything else is for trying the margins, see bench_shmoo.h
+void psram_timing_default(uint32_t clock_hz, int *clock_divider, int *rxdelay);
+uint32_t psram_timing(uint32_t clock_hz, int clock_divider, int rxdelay);
+
+//  Test structures
+
+#define TEST_SIZE (16 * 1024)       //  16 * 4 = 64K
+#define LOOP_SCALE (200)            //  LOOP_SCALE * 100
+
+extern uint32_t s_test_memory[TEST_SIZE];
+extern const uint32_t s_testROM[TEST_SIZE];
+extern uint32_t s_psram_test_memory[TEST_SIZE];
+
+typedef struct 
+{
+    uint32_t *buffer;
+    uint32_t buffer_size;
+    int loop_scale;
+    bool read;
+    bool random;
+    char * test_name;
+    uint64_t result;
+    uint64_t overhead;                  //  Loop / index arithmetic included in result
+    uint32_t buffer_offset;             //  Bytes from buffer to the start of the test window
+} memory_test_config;
+
+extern memory_test_config s_memory_test_config[];
+extern const int s_memory_test_count;
+
+//  Start of the test window, NULL if it runs off the end of the PSRAM we found
+uint32_t *test_window(const memory_test_config *config);
+
+//  Calibrate, time and print one test / the whole table
+void run_test(memory_test_config *config);
+void run_tests(void);
+
+#define LATENCY_SAMPLES     100000
+#define LATENCY_BATCH       1               //  Accesses timed together
+#define LATENCY_MAX_BATCH   16
+
+//  Latency histogram of one test / the whole table, the header goes before the first
+void print_latency_header(void);
+void run_latency_test(const memory_test_config *config, uint32_t samples, uint32_t batch);
+void run_latency_tests(uint32_t samples, uint32_t batch);
+
+//  Plain vs isolated runs of the table, flags are ISOLATE_*
+#define ISOLATION_AB_MODE       (ISOLATE_DEFER_OUTPUT | ISOLATE_NO_IRQ)
+#define ISOLATION_AB_LOOPS      10
+#define ISOLATION_AB_REPS       3
+
+void run_isolation_ab(uint32_t flags, int loop_scale, int repetitions);
+
+//  Write / read back every test window
+void test_mem(void);
+
+//  Everything, in the order main() runs it
+void run_all(void);
+
+//  DWT cycle counter, cycle_counter_init() before use
+void cycle_counter_init(void);
+uint32_t cycle_counter_overhead(void);
+
+static inline uint32_t cycle_count(void)
+{
+    return m33_hw->dwt_cyccnt;
+}
+
+//  Copy .psram_data and zero .psram_bss
+bool psram_sections_init(void);
+
+//  SRAM heap
+uint32_t getTotalHeap(void);
+uint32_t getFreeHeap(void);
+
+//  PSRAM heap
+bool psram_heap_init(void);
+void *psram_malloc(size_t size);
+void psram_free(void *ptr);
+void *psram_realloc(void *ptr, size_t size);
+void psram_heap_stats(tlsf_stats *stats);
+uint32_t getTotalPsramHeap(void);
+uint32_t getFreePsramHeap(void);
+
+#endif
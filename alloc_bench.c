@@ -0,0 +1,460 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/xip_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "PicoMemPerf.h"
+#include "alloc_bench.h"
+#include "mem_tier.h"
+#include "mem_pool.h"
+
+#define ALLOC_BENCH_SLOTS       64                  //  Live allocations
+#define ALLOC_BENCH_MAX_SIZE    512                 //  64 * 512 = 32K max live
+#define ALLOC_BENCH_OPS         20000               //  Alloc + free pairs
+#define ALLOC_BENCH_SRAM_POOL   (64 * 1024)
+#define ALLOC_BENCH_PSRAM_POOL  (1024 * 1024)
+
+typedef struct
+{
+    tlsf_heap *heap;            //  NULL for newlib malloc
+    char * test_name;
+    uint64_t result;
+} alloc_bench_config;
+
+static void *s_alloc_bench_slots[ALLOC_BENCH_SLOTS];
+
+uint64_t __time_critical_func(alloc_bench)(tlsf_heap *heap)
+{
+    uint32_t seed_value = 0xDEADBEEF;
+
+    for (int i = 0; i < ALLOC_BENCH_SLOTS; i++)
+    {
+        s_alloc_bench_slots[i] = NULL;
+    }
+
+    uint64_t start = time_us_64();
+
+    //  Replace a random slot each time, steady state is half full
+    for (int op = 0; op < ALLOC_BENCH_OPS; op++)
+    {
+        seed_value = (seed_value * 1103515245U + 12345U);
+        int slot = (seed_value >> 8) & (ALLOC_BENCH_SLOTS - 1);
+        size_t size = 8 + ((seed_value >> 16) % (ALLOC_BENCH_MAX_SIZE - 8));
+
+        if (heap != NULL)
+        {
+            tlsf_free(heap, s_alloc_bench_slots[slot]);
+            s_alloc_bench_slots[slot] = tlsf_malloc(heap, size);
+        }
+        else
+        {
+            free(s_alloc_bench_slots[slot]);
+            s_alloc_bench_slots[slot] = malloc(size);
+        }
+    }
+
+    return time_us_64() - start;
+}
+
+void alloc_bench_release(tlsf_heap *heap)
+{
+    for (int i = 0; i < ALLOC_BENCH_SLOTS; i++)
+    {
+        if (heap != NULL)
+        {
+            tlsf_free(heap, s_alloc_bench_slots[i]);
+        }
+        else
+        {
+            free(s_alloc_bench_slots[i]);
+        }
+        s_alloc_bench_slots[i] = NULL;
+    }
+}
+
+static void print_heap_stats(char *name, tlsf_stats *stats)
+{
+    printf("Heap, %s, total, %d, used, %d, free, %d, largest, %d, free_blocks, %d, frag, %.3f\n", name,
+           (int)stats->total_size, (int)stats->used_size, (int)stats->free_size, (int)stats->largest_free,
+           (int)stats->free_blocks, stats->fragmentation);
+}
+
+void run_alloc_bench(void)
+{
+    tlsf_heap sram_meta_sram;
+    tlsf_heap psram_meta_sram;
+    tlsf_heap psram_nocache_meta_sram;
+
+    uint8_t *sram_pool = malloc(ALLOC_BENCH_SRAM_POOL);
+    uint8_t *psram_pool = psram_malloc(ALLOC_BENCH_PSRAM_POOL);
+
+    if ((sram_pool == NULL) || (psram_pool == NULL))
+    {
+        printf("Alloc bench, failed to get pools\n");
+        free(sram_pool);
+        psram_free(psram_pool);
+        return;
+    }
+
+    tlsf_create(&sram_meta_sram, sram_pool, ALLOC_BENCH_SRAM_POOL);
+
+    //  Each PSRAM variant gets a fresh pool so earlier runs don't leave fragmentation behind
+    alloc_bench_config configs[] =
+    {
+        { NULL, "NEWLIB SRAM", 0 },
+        { &sram_meta_sram, "TLSF SRAM META SRAM", 0 },
+        { &psram_meta_sram, "TLSF PSRAM META SRAM", 0 },
+        { NULL, "TLSF PSRAM META PSRAM", 0 },
+        { &psram_nocache_meta_sram, "TLSF PSRAM NOCACHE META SRAM", 0 },
+        { NULL, "TLSF PSRAM NOCACHE META PSRAM", 0 },
+    };
+
+    for (int i = 0; i < (sizeof(configs) / sizeof(alloc_bench_config)); i++)
+    {
+        switch (i)
+        {
+            case 2: tlsf_create(configs[i].heap, psram_pool, ALLOC_BENCH_PSRAM_POOL); break;
+            case 3: configs[i].heap = tlsf_create_in_place(psram_pool, ALLOC_BENCH_PSRAM_POOL); break;
+            case 4:
+                //  Dirty lines from the cached runs would be written back over the uncached heap
+                xip_cache_clean_all();
+                xip_cache_invalidate_all();
+                tlsf_create(configs[i].heap, PSRAM_NOCACHE(psram_pool), ALLOC_BENCH_PSRAM_POOL);
+                break;
+            case 5: configs[i].heap = tlsf_create_in_place(PSRAM_NOCACHE(psram_pool), ALLOC_BENCH_PSRAM_POOL); break;
+            default: break;
+        }
+
+        if ((i != 0) && (configs[i].heap == NULL))
+        {
+            printf("Alloc bench, %s, failed to create heap\n", configs[i].test_name);
+            continue;
+        }
+
+        configs[i].result = alloc_bench(configs[i].heap);
+
+        printf("Alloc, %s, %d, %d\n", configs[i].test_name, ALLOC_BENCH_OPS, (int)(configs[i].result));
+
+        //  Fragmentation with the steady state allocations still live
+        if (configs[i].heap != NULL)
+        {
+            tlsf_stats stats;
+            tlsf_get_stats(configs[i].heap, &stats);
+            print_heap_stats(configs[i].test_name, &stats);
+        }
+
+        alloc_bench_release(configs[i].heap);
+    }
+
+    free(sram_pool);
+    psram_free(psram_pool);
+
+    tlsf_stats stats;
+    psram_heap_stats(&stats);
+    print_heap_stats("PSRAM HEAP", &stats);
+}
+
+
+//  Tiered allocator trace replay
+
+typedef enum
+{
+    TRACE_ALLOC,
+    TRACE_FREE,
+    TRACE_READ,
+    TRACE_WRITE
+} mem_trace_op;
+
+typedef struct
+{
+    uint8_t op;
+    uint8_t id;
+    uint8_t hint;               //  TRACE_ALLOC
+    bool random;                //  TRACE_READ / TRACE_WRITE
+    uint32_t size;              //  TRACE_ALLOC: bytes, TRACE_READ / TRACE_WRITE: loop scale
+} mem_trace_event;
+
+#define TRACE_ALLOC(id, size, hint)     { TRACE_ALLOC, id, hint, false, size }
+#define TRACE_FREE(id)                  { TRACE_FREE, id, 0, false, 0 }
+#define TRACE_READ(id, rnd, scale)      { TRACE_READ, id, 0, rnd, scale }
+#define TRACE_WRITE(id, rnd, scale)     { TRACE_WRITE, id, 0, rnd, scale }
+
+#define TRACE_BUFFERS           8
+#define TIER_BENCH_SRAM_BUDGET  (96 * 1024)
+
+//  Audio style workload: small hot state and a random access wavetable, large
+//  streamed sample buffers and a cold event log.  Buffer sizes are powers of
+//  two so the random kernels can mask.
+static const mem_trace_event s_tier_trace[] =
+{
+    TRACE_ALLOC(0, 16 * 1024, MEM_HINT_HOT),            //  Voice state
+    TRACE_ALLOC(1, 64 * 1024, MEM_HINT_STREAMING),      //  Input samples
+    TRACE_ALLOC(2, 32 * 1024, MEM_HINT_LATENCY),        //  Wavetable
+    TRACE_ALLOC(3, 128 * 1024, MEM_HINT_COLD),          //  Event log
+    TRACE_WRITE(3, false, 1),
+    TRACE_READ(1, false, 2),
+    TRACE_READ(2, true, 4),
+    TRACE_WRITE(0, true, 4),
+    TRACE_FREE(3),
+    TRACE_ALLOC(4, 32 * 1024, MEM_HINT_HOT),            //  Filter state
+    TRACE_ALLOC(5, 64 * 1024, MEM_HINT_STREAMING),      //  Output samples
+    TRACE_READ(1, false, 2),
+    TRACE_WRITE(5, false, 2),
+    TRACE_READ(2, true, 4),
+    TRACE_READ(4, true, 4),
+    TRACE_WRITE(0, true, 2),
+    TRACE_FREE(1),
+    TRACE_FREE(5),
+    TRACE_FREE(0),
+    TRACE_FREE(2),
+    TRACE_FREE(4),
+};
+
+#define TIER_ORDER_ALL(a, b, c)     { { a, b, c }, { a, b, c }, { a, b, c }, { a, b, c } }
+
+static const mem_tier_policy s_tier_bench_policies[] =
+{
+    {
+        "HINTED",
+        {
+            [MEM_HINT_HOT]       = { MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE },
+            [MEM_HINT_LATENCY]   = { MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE },
+            [MEM_HINT_COLD]      = { MEM_TIER_PSRAM_NOCACHE, MEM_TIER_PSRAM, MEM_TIER_SRAM },
+            [MEM_HINT_STREAMING] = { MEM_TIER_PSRAM_NOCACHE, MEM_TIER_PSRAM, MEM_TIER_SRAM },
+        },
+        TIER_BENCH_SRAM_BUDGET
+    },
+    {
+        "HINTED CACHED",
+        {
+            [MEM_HINT_HOT]       = { MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE },
+            [MEM_HINT_LATENCY]   = { MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE },
+            [MEM_HINT_COLD]      = { MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE, MEM_TIER_SRAM },
+            [MEM_HINT_STREAMING] = { MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE, MEM_TIER_SRAM },
+        },
+        TIER_BENCH_SRAM_BUDGET
+    },
+    { "SRAM FIRST", TIER_ORDER_ALL(MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE), TIER_BENCH_SRAM_BUDGET },
+    { "PSRAM ONLY", TIER_ORDER_ALL(MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE, MEM_TIER_NONE), TIER_BENCH_SRAM_BUDGET },
+};
+
+//  Returns the time spent in the access events, total time in *total_time
+uint64_t tier_trace_replay(const mem_trace_event *trace, int count, uint64_t *total_time)
+{
+    void *buffers[TRACE_BUFFERS] = { NULL };
+    uint32_t sizes[TRACE_BUFFERS] = { 0 };
+    uint64_t access_time = 0;
+    uint64_t start = time_us_64();
+
+    for (int i = 0; i < count; i++)
+    {
+        const mem_trace_event *event = &trace[i];
+
+        switch (event->op)
+        {
+            case TRACE_ALLOC:
+                buffers[event->id] = mem_tier_malloc(event->size, (mem_hint)event->hint);
+                sizes[event->id] = event->size;
+                break;
+
+            case TRACE_FREE:
+                mem_tier_free(buffers[event->id]);
+                buffers[event->id] = NULL;
+                break;
+
+            case TRACE_READ:
+            case TRACE_WRITE:
+                if (buffers[event->id] != NULL)
+                {
+                    access_time += memory_test(buffers[event->id], sizes[event->id] / sizeof(uint32_t), event->size, event->op == TRACE_READ, event->random);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    *total_time = time_us_64() - start;
+
+    return access_time;
+}
+
+void run_tier_bench(void)
+{
+    for (int i = 0; i < (sizeof(s_tier_bench_policies) / sizeof(mem_tier_policy)); i++)
+    {
+        const mem_tier_policy *policy = &s_tier_bench_policies[i];
+        mem_tier_stats stats;
+        uint64_t total_time;
+
+        mem_tier_set_policy(policy);
+        mem_tier_reset_stats();
+
+        uint64_t access_time = tier_trace_replay(s_tier_trace, sizeof(s_tier_trace) / sizeof(mem_trace_event), &total_time);
+
+        mem_tier_get_stats(&stats);
+
+        printf("Tier, %s, %d, %d\n", policy->policy_name, (int)access_time, (int)total_time);
+        printf("Tier placement, %s, %s, %d, %s, %d, %s, %d, fallbacks, %d, failures, %d\n", policy->policy_name,
+               mem_tier_name(MEM_TIER_SRAM), (int)stats.allocs[MEM_TIER_SRAM],
+               mem_tier_name(MEM_TIER_PSRAM), (int)stats.allocs[MEM_TIER_PSRAM],
+               mem_tier_name(MEM_TIER_PSRAM_NOCACHE), (int)stats.allocs[MEM_TIER_PSRAM_NOCACHE],
+               (int)stats.fallbacks, (int)stats.failures);
+    }
+
+    mem_tier_set_policy(NULL);
+}
+
+
+//  Pool / arena vs heap object traversal
+
+#define POOL_BENCH_NODES        4096
+#define POOL_BENCH_PASSES       50
+#define POOL_BENCH_MAX_FILLER   1024
+
+typedef struct pool_bench_node
+{
+    struct pool_bench_node *next;
+    uint32_t payload[6];
+} pool_bench_node;
+
+typedef enum
+{
+    POOL_BENCH_HEAP,
+    POOL_BENCH_POOL,
+    POOL_BENCH_ARENA
+} pool_bench_source;
+
+uint64_t __time_critical_func(pool_bench_traverse)(pool_bench_node *head)
+{
+    uint64_t start = time_us_64();
+    uint32_t value = 0;
+
+    for (int pass = 0; pass < POOL_BENCH_PASSES; pass++)
+    {
+        for (pool_bench_node *node = head; node != NULL; node = node->next)
+        {
+            value += node->payload[0];
+        }
+    }
+
+    uint64_t delta = time_us_64() - start;
+
+    s_value = value;
+
+    return delta;
+}
+
+void run_pool_bench(void)
+{
+    static const char *names[] = { "HEAP PSRAM", "POOL PSRAM", "ARENA PSRAM" };
+    size_t region_size = ((POOL_BENCH_NODES / (MEM_PAGE_SIZE / 32)) + 1) * MEM_PAGE_SIZE;
+
+    void **fillers = malloc(POOL_BENCH_NODES * sizeof(void *));
+    void *region = psram_malloc(region_size);
+
+    if ((fillers == NULL) || (region == NULL))
+    {
+        printf("Pool bench, failed to get buffers\n");
+        free(fillers);
+        psram_free(region);
+        return;
+    }
+
+    for (int source = POOL_BENCH_HEAP; source <= POOL_BENCH_ARENA; source++)
+    {
+        mem_pool pool;
+        mem_arena arena;
+        pool_bench_node *head = NULL;
+        pool_bench_node *tail = NULL;
+        uintptr_t low = UINTPTR_MAX;
+        uintptr_t high = 0;
+        uint32_t seed_value = 0xDEADBEEF;
+
+        mem_pool_init(&pool, region, region_size, sizeof(pool_bench_node));
+        mem_arena_init(&arena, region, region_size);
+
+        //  Every node allocation is followed by an unrelated heap allocation, as
+        //  it would be in a real program
+        for (int i = 0; i < POOL_BENCH_NODES; i++)
+        {
+            pool_bench_node *node;
+
+            switch (source)
+            {
+                case POOL_BENCH_POOL:   node = mem_pool_alloc(&pool); break;
+                case POOL_BENCH_ARENA:  node = mem_arena_alloc(&arena, sizeof(pool_bench_node)); break;
+                default:                node = psram_malloc(sizeof(pool_bench_node)); break;
+            }
+
+            seed_value = (seed_value * 1103515245U + 12345U);
+            fillers[i] = psram_malloc(16 + ((seed_value >> 16) % (POOL_BENCH_MAX_FILLER - 16)));
+
+            if (node == NULL)
+            {
+                continue;
+            }
+
+            node->next = NULL;
+            node->payload[0] = i;
+            if (tail != NULL)
+            {
+                tail->next = node;
+            }
+            else
+            {
+                head = node;
+            }
+            tail = node;
+
+            low = ((uintptr_t)node < low) ? (uintptr_t)node : low;
+            high = ((uintptr_t)node > high) ? (uintptr_t)node : high;
+        }
+
+        uint64_t result = pool_bench_traverse(head);
+
+        printf("Pool, %s, %d, %d, span, %d\n", names[source], POOL_BENCH_NODES, (int)result, (int)(high - low + sizeof(pool_bench_node)));
+
+        for (int i = 0; i < POOL_BENCH_NODES; i++)
+        {
+            psram_free(fillers[i]);
+        }
+        if (source == POOL_BENCH_HEAP)
+        {
+            while (head != NULL)
+            {
+                pool_bench_node *next = head->next;
+                psram_free(head);
+                head = next;
+            }
+        }
+    }
+
+    free(fillers);
+    psram_free(region);
+}
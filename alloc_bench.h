@@ -0,0 +1,42 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Allocator benchmarks
+
+#ifndef ALLOC_BENCH_H
+#define ALLOC_BENCH_H
+
+//  Alloc / free throughput of newlib malloc vs TLSF with the pool and the
+//  control structure in SRAM, PSRAM and uncached PSRAM
+void run_alloc_bench(void);
+
+//  Replays an allocation trace through mem_tier under several placement
+//  policies and compares the total access time
+void run_tier_bench(void);
+
+//  Linked list traversal with the nodes from the PSRAM heap (interleaved with
+//  other allocations) vs a line / page packed pool and arena
+void run_pool_bench(void);
+
+#endif
@@ -0,0 +1,315 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/qmi.h"
+#include "hardware/sync.h"
+#include "hardware/xip_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "PicoMemPerf.h"
+#include "run_header.h"
+#include "result_out.h"
+#include "result_log.h"
+#include "ber_stats.h"
+#include "bench_checkpoint.h"
+#include "bench_shmoo.h"
+#include "bench_ber.h"
+
+#define BER_PASS_CSV_HEADER     "BER pass, pass, pattern, inverted, bits, errors, ms\n"
+#define BER_PATTERN_CSV_HEADER  "BER pattern, pattern, inverted, bits, errors, per_gbit, upper_per_gbit\n"
+#define BER_BIT_CSV_HEADER      "BER bit, bit, rise, fall\n"
+#define BER_CSV_HEADER          "BER, clock_mhz, clkdiv, rxdelay, sck_mhz, bytes, passes, bits, errors, per_gbit, lower_per_gbit, upper_per_gbit, confidence, target_per_gbit, bits_needed, meets\n"
+
+#define BER_CHUNK_BYTES         (BER_CHUNK_WORDS * sizeof(uint32_t))
+#define BER_SEED_STEP           0x9E3779B9  //  A different start in the sequence every pass
+
+static ber_prbs s_ber_prbs;
+static ber_counts s_ber_pattern_counts[BER_PATTERN_COUNT][2];
+
+void bench_ber_default(ber_config *config)
+{
+    int clkdiv, rxdelay;
+
+    psram_timing_default(clock_get_hz(clk_sys), &clkdiv, &rxdelay);
+    memset(config, 0, sizeof(ber_config));
+    config->clkdiv = (uint8_t)clkdiv;
+    config->rxdelay = (uint8_t)rxdelay;
+    config->passes = BER_PASSES;
+    config->confidence_pct = BER_CONFIDENCE_PCT;
+}
+
+const char *bench_ber_check(const ber_config *config)
+{
+    if (_psram_size == 0)
+    {
+        return "no PSRAM";
+    }
+    if ((config->clkdiv == 0) || (config->clkdiv > SHMOO_CLKDIV_MAX))
+    {
+        return "clkdiv is 1 to 15";
+    }
+    if (config->rxdelay > SHMOO_RXDELAY_LAST)
+    {
+        return "rxdelay is 0 to 7";
+    }
+    if ((config->passes == 0) || (config->passes > BER_MAX_PASSES))
+    {
+        return "1 to 1000 passes";
+    }
+    if ((config->confidence_pct < 50) || (config->confidence_pct > 99))
+    {
+        return "confidence is 50 to 99%";
+    }
+    if (!(config->target_per_gbit >= 0.0f))
+    {
+        return "target can't be negative";
+    }
+    return NULL;
+}
+
+//  Both run with interrupts off and nothing dirty in the XIP cache, so the
+//  only PSRAM accesses at the test timing are these, through the uncached window
+static void __not_in_flash_func(ber_write_chunk)(volatile uint32_t *window, uint32_t invert, uint32_t timing, uint32_t safe_timing)
+{
+    xip_cache_clean_all();
+    uint32_t irq = save_and_disable_interrupts();
+    qmi_hw->m[1].timing = timing;
+    __dsb();
+
+    for (uint32_t i = 0; i < BER_CHUNK_WORDS; i++)
+    {
+        window[i] = ber_prbs_word(&s_ber_prbs) ^ invert;
+    }
+    (void)window[0];                        //  Waits for the writes
+
+    qmi_hw->m[1].timing = safe_timing;
+    __dsb();
+    restore_interrupts(irq);
+}
+
+static void __not_in_flash_func(ber_verify_chunk)(volatile uint32_t *window, uint32_t invert, uint32_t timing, uint32_t safe_timing, ber_counts *counts)
+{
+    xip_cache_clean_all();
+    uint32_t irq = save_and_disable_interrupts();
+    qmi_hw->m[1].timing = timing;
+    __dsb();
+
+    for (uint32_t i = 0; i < BER_CHUNK_WORDS; i++)
+    {
+        uint32_t expected = ber_prbs_word(&s_ber_prbs) ^ invert;
+        uint32_t actual = window[i];
+        if (actual != expected)
+        {
+            ber_count_word(counts, expected, actual);
+        }
+    }
+
+    qmi_hw->m[1].timing = safe_timing;
+    __dsb();
+    restore_interrupts(irq);
+
+    counts->bits += (uint64_t)BER_CHUNK_WORDS * 32;
+}
+
+//  Write the whole region, then read it all back, so every word sits in the PSRAM a while
+static void ber_pass(uint32_t *region, uint32_t chunks, uint32_t pass, uint32_t timing, uint32_t safe_timing)
+{
+    volatile uint32_t *window = (volatile uint32_t *)PSRAM_NOCACHE(region);
+    ber_pattern pattern = (ber_pattern)(pass % BER_PATTERN_COUNT);
+    uint32_t inverted = (pass / BER_PATTERN_COUNT) & 1;
+    uint32_t invert = inverted ? 0xFFFFFFFF : 0;
+    uint32_t seed = (pass + 1) * BER_SEED_STEP;
+    uint32_t point = pass * chunks * 2;
+    ber_counts counts;
+    result_record record;
+
+    ber_counts_clear(&counts);
+    uint64_t start = time_us_64();
+
+    ber_prbs_init(&s_ber_prbs, pattern, seed);
+    for (uint32_t chunk = 0; chunk < chunks; chunk++)
+    {
+        checkpoint_point(point++, 0);
+        ber_write_chunk(window + (chunk * BER_CHUNK_WORDS), invert, timing, safe_timing);
+    }
+
+    ber_prbs_init(&s_ber_prbs, pattern, seed);
+    for (uint32_t chunk = 0; chunk < chunks; chunk++)
+    {
+        checkpoint_point(point++, 0);
+        ber_verify_chunk(window + (chunk * BER_CHUNK_WORDS), invert, timing, safe_timing, &counts);
+    }
+
+    result_begin(&record, "BER pass");
+    result_u64(&record, "pass", pass);
+    result_str(&record, "pattern", ber_pattern_name(pattern));
+    result_u64(&record, "inverted", inverted);
+    result_u64(&record, "bits", counts.bits);
+    result_u64(&record, "errors", counts.errors);
+    result_u64(&record, "ms", (time_us_64() - start) / 1000);
+    result_end(&record);
+
+    ber_counts_add(&s_ber_pattern_counts[pattern][inverted], &counts);
+}
+
+static void ber_summary(const ber_config *config, uint32_t bytes)
+{
+    result_record record;
+    ber_counts total;
+    ber_interval interval;
+    double confidence = config->confidence_pct / 100.0;
+    uint32_t mhz = (clock_get_hz(clk_sys) + 500000) / 1000000;
+
+    ber_counts_clear(&total);
+
+    result_csv_line(BER_PATTERN_CSV_HEADER);
+    for (int pattern = 0; pattern < BER_PATTERN_COUNT; pattern++)
+    {
+        for (int inverted = 0; inverted < 2; inverted++)
+        {
+            const ber_counts *counts = &s_ber_pattern_counts[pattern][inverted];
+
+            if (counts->bits == 0)
+            {
+                continue;
+            }
+            ber_counts_add(&total, counts);
+            ber_interval_per_gbit(counts->errors, counts->bits, confidence, &interval);
+
+            result_begin(&record, "BER pattern");
+            result_str(&record, "pattern", ber_pattern_name((ber_pattern)pattern));
+            result_u64(&record, "inverted", inverted);
+            result_u64(&record, "bits", counts->bits);
+            result_u64(&record, "errors", counts->errors);
+            result_f32(&record, "per_gbit", (float)interval.rate);
+            result_f32(&record, "upper_per_gbit", (float)interval.upper);
+            result_end(&record);
+        }
+    }
+
+    //  Only the bits that flipped, a bad data line or a marginal strobe shows up here
+    if (total.errors != 0)
+    {
+        result_csv_line(BER_BIT_CSV_HEADER);
+        for (int bit = 0; bit < 32; bit++)
+        {
+            if ((total.rise[bit] == 0) && (total.fall[bit] == 0))
+            {
+                continue;
+            }
+            result_begin(&record, "BER bit");
+            result_u64(&record, "bit", bit);
+            result_u64(&record, "rise", total.rise[bit]);
+            result_u64(&record, "fall", total.fall[bit]);
+            result_end(&record);
+        }
+    }
+
+    //  Met if the upper bound is under the target, missed if the lower bound is over it
+    ber_interval_per_gbit(total.errors, total.bits, confidence, &interval);
+    const char *meets = "-";
+    if (config->target_per_gbit > 0.0f)
+    {
+        meets = (interval.upper <= config->target_per_gbit) ? "yes" : (interval.lower > config->target_per_gbit) ? "no" : "unproven";
+    }
+
+    result_csv_line(BER_CSV_HEADER);
+    result_begin(&record, "BER");
+    result_u64(&record, "clock_mhz", mhz);
+    result_u64(&record, "clkdiv", config->clkdiv);
+    result_u64(&record, "rxdelay", config->rxdelay);
+    result_f32(&record, "sck_mhz", (float)mhz / config->clkdiv);
+    result_u64(&record, "bytes", bytes);
+    result_u64(&record, "passes", config->passes);
+    result_u64(&record, "bits", total.bits);
+    result_u64(&record, "errors", total.errors);
+    result_f32(&record, "per_gbit", (float)interval.rate);
+    result_f32(&record, "lower_per_gbit", (float)interval.lower);
+    result_f32(&record, "upper_per_gbit", (float)interval.upper);
+    result_u64(&record, "confidence", config->confidence_pct);
+    result_f32(&record, "target_per_gbit", config->target_per_gbit);
+    result_u64(&record, "bits_needed", (uint64_t)ber_bits_needed(config->target_per_gbit, confidence));
+    result_str(&record, "meets", meets);
+    result_end(&record);
+}
+
+bool bench_ber_run(const ber_config *config)
+{
+    const char *error = bench_ber_check(config);
+    tlsf_stats stats;
+    uint32_t *region = NULL;
+
+    if (error != NULL)
+    {
+        printf("Error, ber, %s\n", error);
+        return false;
+    }
+
+    //  As much of the PSRAM as the heap will give, whole chunks
+    psram_heap_stats(&stats);
+    size_t bytes = (stats.largest_free / BER_CHUNK_BYTES) * BER_CHUNK_BYTES;
+    while ((bytes != 0) && ((region = psram_malloc(bytes)) == NULL))
+    {
+        bytes -= BER_CHUNK_BYTES;
+    }
+    if (region == NULL)
+    {
+        printf("Error, ber, no free PSRAM\n");
+        return false;
+    }
+
+    uint32_t chunks = bytes / BER_CHUNK_BYTES;
+    uint32_t safe_timing = qmi_hw->m[1].timing;
+    uint32_t timing = psram_timing(clock_get_hz(clk_sys), config->clkdiv, config->rxdelay);
+
+    memset(s_ber_pattern_counts, 0, sizeof(s_ber_pattern_counts));
+
+    print_run_header();
+    checkpoint_begin(CHECKPOINT_BER, config, sizeof(ber_config));
+
+    result_csv_line(BER_PASS_CSV_HEADER);
+    for (uint32_t pass = 0; pass < config->passes; pass++)
+    {
+        ber_pass(region, chunks, pass, timing, safe_timing);
+        result_log_flush();
+    }
+
+    checkpoint_end();
+
+    ber_summary(config, bytes);
+
+    //  Nothing stale left cached from the test timing
+    xip_cache_clean_all();
+    xip_cache_invalidate_all();
+    psram_free(region);
+
+    if (timing != safe_timing)
+    {
+        printf("BER, PSRAM was written at a test timing, reset before trusting its contents\n");
+    }
+    return true;
+}
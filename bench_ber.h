@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  PSRAM bit error rate
+//
+//  Characterises one QMI timing (clock divider and RX delay at the current
+//  clk_sys) for the reliability numbers a shmoo can't give.  Each pass
+//  writes a PRBS (ber_stats.h) through the whole of the free PSRAM heap at
+//  the test timing and reads it back, counting bit flips by position,
+//  direction and pattern.  Passes cycle through PRBS9, 15, 23 and 31, then
+//  the same again inverted.  The summary gives errors per Gbit with a
+//  confidence interval, and against a target whether it's met and how many
+//  error free bits it takes to show it.
+//
+//  Like the shmoo the accesses run from SRAM with interrupts off, a chunk
+//  at a time, with the start up timing back in between so USB and the
+//  result log keep working.  Every chunk is a checkpoint, a hang is
+//  reported after the watchdog reset but the run isn't carried on.
+//
+//  A failing timing may write anywhere in PSRAM, reset the board before
+//  trusting anything kept there.
+
+#ifndef BENCH_BER_H
+#define BENCH_BER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BER_CHUNK_WORDS         (16 * 1024)     //  64K with interrupts off at a time
+#define BER_PASSES              8               //  Every pattern and its inverse
+#define BER_MAX_PASSES          1000
+#define BER_CONFIDENCE_PCT      95
+
+typedef struct
+{
+    uint8_t clkdiv;
+    uint8_t rxdelay;
+    uint16_t passes;
+    uint8_t confidence_pct;
+    float target_per_gbit;              //  0 for none
+} ber_config;
+
+//  Start up timing for the current clock, BER_PASSES, no target
+void bench_ber_default(ber_config *config);
+
+//  NULL if it can be run, otherwise what's wrong
+const char *bench_ber_check(const ber_config *config);
+
+bool bench_ber_run(const ber_config *config);
+
+#endif
@@ -0,0 +1,263 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "PicoMemPerf.h"
+#include "isolation.h"
+#include "result_out.h"
+#include "bench_check.h"
+
+//  The profile, by name from s_memory_test_config
+static const char * const s_self_check_tests[] =
+{
+    "SEQ SRAM READ",
+    "SEQ PSRAM READ",
+    "SEQ PSRAM NOCACHE READ",
+    "RND PSRAM READ",
+    "RND PSRAM NOCACHE READ",
+    "SEQ PSRAM WRITE",
+    "SEQ PSRAM NOCACHE WRITE",
+    "RND PSRAM WRITE",
+    "RND PSRAM NOCACHE WRITE",
+};
+#define SELF_CHECK_TESTS    (sizeof(s_self_check_tests) / sizeof(s_self_check_tests[0]))
+
+//  Page padded copy for programming
+static uint8_t s_golden_page[(sizeof(golden_baseline) + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1)];
+
+static const memory_test_config *check_config(const char *name)
+{
+    for (int i = 0; i < s_memory_test_count; i++)
+    {
+        if (strcmp(s_memory_test_config[i].test_name, name) == 0)
+        {
+            return &s_memory_test_config[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t check_psram_id(void)
+{
+    return (s_psram_kgd << 8) | s_psram_eid;
+}
+
+//  Best of reps over the first size words of the window, overhead corrected,
+//  false if the test can't run here
+static bool __time_critical_func(check_measure)(const memory_test_config *config, uint32_t size, uint32_t loop_scale, int reps, uint64_t *us)
+{
+    uint32_t *window = ((config != NULL) && (size <= config->buffer_size)) ? test_window(config) : NULL;
+    uint64_t best = UINT64_MAX;
+
+    if (window == NULL)
+    {
+        return false;
+    }
+
+    isolate_begin();
+    uint64_t overhead = calibrate_overhead(size, loop_scale, config->read, config->random);
+    for (int rep = 0; rep < reps; rep++)
+    {
+        uint64_t result = memory_test(window, size, loop_scale, config->read, config->random);
+        best = (result < best) ? result : best;
+    }
+    isolate_end();
+
+    *us = (best > overhead) ? (best - overhead) : 0;
+    return true;
+}
+
+bool bench_check_measure(const char *name, uint32_t loop_scale, int reps, uint64_t *us)
+{
+    const memory_test_config *config = check_config(name);
+
+    return (config != NULL) && check_measure(config, config->buffer_size, loop_scale, reps, us);
+}
+
+static void __not_in_flash_func(golden_flash_program)(void *param)
+{
+    flash_range_erase(GOLDEN_FLASH_OFFSET, GOLDEN_FLASH_SIZE);
+    if (param != NULL)
+    {
+        flash_range_program(GOLDEN_FLASH_OFFSET, s_golden_page, sizeof(s_golden_page));
+    }
+}
+
+bool bench_check_capture(void)
+{
+    static golden_baseline s_golden;
+    uint64_t us;
+
+    golden_init(&s_golden, clock_get_hz(clk_sys), _psram_size, check_psram_id());
+
+    for (size_t i = 0; i < SELF_CHECK_TESTS; i++)
+    {
+        const memory_test_config *config = check_config(s_self_check_tests[i]);
+
+        if (!check_measure(config, SELF_CHECK_SIZE, SELF_CHECK_LOOP_SCALE, SELF_CHECK_REPS, &us) ||
+            !golden_add(&s_golden, s_self_check_tests[i], SELF_CHECK_SIZE, SELF_CHECK_LOOP_SCALE, us))
+        {
+            isolation_flush();
+            printf("Error, golden, %s\n", s_self_check_tests[i]);
+            return false;
+        }
+    }
+    isolation_flush();
+    golden_seal(&s_golden);
+
+    memset(s_golden_page, 0xFF, sizeof(s_golden_page));
+    memcpy(s_golden_page, &s_golden, sizeof(s_golden));
+
+    int result = flash_safe_execute(golden_flash_program, s_golden_page, GOLDEN_FLASH_TIMEOUT_MS);
+    if (result != PICO_OK)
+    {
+        printf("Error, golden flash write, %d\n", result);
+        return false;
+    }
+
+    bench_check_show();
+    return true;
+}
+
+bool bench_check_load(golden_baseline *golden)
+{
+    memcpy(golden, (const void *)(XIP_BASE + GOLDEN_FLASH_OFFSET), sizeof(golden_baseline));
+    return golden_valid(golden);
+}
+
+void bench_check_show(void)
+{
+    static golden_baseline s_golden;
+    result_record record;
+
+    if (!bench_check_load(&s_golden))
+    {
+        printf("Error, no golden baseline\n");
+        return;
+    }
+
+    result_begin(&record, "Golden board");
+    result_u64(&record, "clock_hz", s_golden.clock_hz);
+    result_u64(&record, "psram_size", s_golden.psram_size);
+    result_hex(&record, "psram_id", s_golden.psram_id);
+    result_end(&record);
+
+    for (uint32_t i = 0; i < s_golden.count; i++)
+    {
+        const golden_entry *entry = &s_golden.entries[i];
+
+        result_begin(&record, "Golden");
+        result_str(&record, "test", entry->name);
+        result_u64(&record, "size", entry->size);
+        result_u64(&record, "loop_scale", entry->loop_scale);
+        result_u64(&record, "result", entry->us);
+        result_end(&record);
+    }
+}
+
+self_check_grade bench_check_run(const self_check_bands *bands)
+{
+    static golden_baseline s_golden;
+    static uint64_t s_us[SELF_CHECK_TESTS];
+    static bool s_measured[SELF_CHECK_TESTS];
+    result_record record;
+
+    if (!bench_check_load(&s_golden))
+    {
+        printf("Error, no golden baseline, run \"check capture\" on a good board\n");
+        return SELF_CHECK_FAIL;
+    }
+
+    //  Measure everything first, the records would get in the way of the timing
+    uint64_t start = time_us_64();
+    for (size_t i = 0; i < SELF_CHECK_TESTS; i++)
+    {
+        s_measured[i] = check_measure(check_config(s_self_check_tests[i]), SELF_CHECK_SIZE, SELF_CHECK_LOOP_SCALE, SELF_CHECK_REPS, &s_us[i]);
+    }
+    uint32_t elapsed_ms = (uint32_t)((time_us_64() - start) / 1000);
+    isolation_flush();
+
+    uint32_t clock_hz = clock_get_hz(clk_sys);
+    self_check_grade board = self_check_grade_board(&s_golden, clock_hz, _psram_size, check_psram_id());
+    self_check_grade overall = board;
+    int degraded = 0, failed = 0;
+
+    result_begin(&record, "Check board");
+    result_u64(&record, "clock_hz", clock_hz);
+    result_u64(&record, "golden_clock_hz", s_golden.clock_hz);
+    result_u64(&record, "psram_size", _psram_size);
+    result_u64(&record, "golden_psram_size", s_golden.psram_size);
+    result_hex(&record, "psram_id", check_psram_id());
+    result_hex(&record, "golden_psram_id", s_golden.psram_id);
+    result_str(&record, "grade", self_check_grade_name(board));
+    result_end(&record);
+
+    for (size_t i = 0; i < SELF_CHECK_TESTS; i++)
+    {
+        const golden_entry *entry = golden_find(&s_golden, s_self_check_tests[i]);
+        int32_t deviation = 0;
+        self_check_grade grade = s_measured[i] ? self_check_grade_result(entry, s_us[i], bands, &deviation) : SELF_CHECK_FAIL;
+
+        //  A baseline taken over another window or loop scale isn't comparable
+        if ((entry != NULL) && ((entry->size != SELF_CHECK_SIZE) || (entry->loop_scale != SELF_CHECK_LOOP_SCALE)))
+        {
+            grade = SELF_CHECK_FAIL;
+        }
+
+        degraded += (grade == SELF_CHECK_DEGRADED) ? 1 : 0;
+        failed += (grade == SELF_CHECK_FAIL) ? 1 : 0;
+        overall = self_check_worse(overall, grade);
+
+        result_begin(&record, "Check");
+        result_str(&record, "test", s_self_check_tests[i]);
+        result_u64(&record, "golden", (entry != NULL) ? entry->us : 0);
+        result_u64(&record, "result", s_measured[i] ? s_us[i] : 0);
+        result_i64(&record, "deviation_permille", deviation);
+        result_str(&record, "grade", self_check_grade_name(grade));
+        result_end(&record);
+    }
+
+    result_begin(&record, "Check result");
+    result_str(&record, "grade", self_check_grade_name(overall));
+    result_u64(&record, "tests", SELF_CHECK_TESTS);
+    result_u64(&record, "degraded", degraded);
+    result_u64(&record, "failed", failed);
+    result_u64(&record, "degraded_pct", bands->degraded_pct);
+    result_u64(&record, "fail_pct", bands->fail_pct);
+    result_u64(&record, "ms", elapsed_ms);
+    result_end(&record);
+
+    return overall;
+}
+
+bool bench_check_erase(void)
+{
+    return flash_safe_execute(golden_flash_program, NULL, GOLDEN_FLASH_TIMEOUT_MS) == PICO_OK;
+}
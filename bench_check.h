@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Self check against a golden baseline kept in flash
+//
+//  "check capture" on a known good board runs the short profile below and
+//  keeps its times in a flash sector under the result log.  "check"
+//  (and start up, with SELF_CHECK_AUTORUN) runs the profile again and
+//  grades each test and the board as pass / degraded / fail, see
+//  self_check.h.  The profile is the PSRAM tests plus SRAM as a control,
+//  each over a 4K window for 100 passes, about a second all told going by
+//  the per access times in results/ (the Check result record has the ms).
+//  The cached PSRAM windows fit in the XIP cache, it's the uncached tests
+//  that see the PSRAM itself.
+
+#ifndef BENCH_CHECK_H
+#define BENCH_CHECK_H
+
+#include "PicoMemPerf.h"
+#include "result_log.h"
+#include "self_check.h"
+
+//  Golden baseline sector, just below the result log
+#define GOLDEN_FLASH_SIZE       FLASH_SECTOR_SIZE
+#define GOLDEN_FLASH_OFFSET     (RESULT_LOG_FLASH_OFFSET - GOLDEN_FLASH_SIZE)
+#define GOLDEN_FLASH_TIMEOUT_MS 1000
+
+#define SELF_CHECK_SIZE         1024            //  Words from the start of each test window
+#define SELF_CHECK_LOOP_SCALE   1               //  100 passes, the least memory_test() does
+#define SELF_CHECK_REPS         3               //  Best of, so an interrupt doesn't fail a board
+
+//  Run the profile and keep it as the baseline
+bool bench_check_capture(void);
+
+//  Baseline from flash, false if there isn't a good one
+bool bench_check_load(golden_baseline *golden);
+
+//  Run the profile and grade it, "Check" records for each test and the board
+self_check_grade bench_check_run(const self_check_bands *bands);
+
+//  One test from s_memory_test_config by name, best of reps and overhead
+//  corrected.  Leaves output deferred, isolation_flush() when done timing.
+bool bench_check_measure(const char *name, uint32_t loop_scale, int reps, uint64_t *us);
+
+void bench_check_show(void);
+bool bench_check_erase(void);
+
+#endif
@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/watchdog.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "result_out.h"
+#include "mem_kernels.h"
+#include "bench_checkpoint.h"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t kind;
+    uint32_t point;                     //  About to run
+    uint8_t data[CHECKPOINT_DATA_SIZE];
+    uint32_t checksum;                  //  FNV-1a of everything before it
+} checkpoint_state;
+
+//  Not zeroed at start up, so it's still there after a watchdog reset
+static checkpoint_state __uninitialized_ram(s_checkpoint);
+
+//  What watchdog_enable() loaded, 1us ticks
+static uint32_t s_watchdog_load;
+
+static const char * const s_checkpoint_kind_names[CHECKPOINT_KINDS] = { "none", "shmoo", "plan", "sweep", "ber" };
+
+static uint32_t checkpoint_checksum(const checkpoint_state *state)
+{
+    const uint8_t *data = (const uint8_t *)state;
+    uint32_t hash = 0x811C9DC5;
+
+    for (size_t i = 0; i < offsetof(checkpoint_state, checksum); i++)
+    {
+        hash = (hash ^ data[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+const char *checkpoint_kind_name(checkpoint_kind kind)
+{
+    return (kind < CHECKPOINT_KINDS) ? s_checkpoint_kind_names[kind] : "unknown";
+}
+
+//  Every kernel pass.  watchdog_update() is in flash and the pass may be
+//  timing flash, so reload the counter from here.
+static void __not_in_flash_func(checkpoint_feed)(void)
+{
+    watchdog_hw->load = s_watchdog_load;
+}
+
+void checkpoint_begin(checkpoint_kind kind, const void *data, size_t size)
+{
+    memset(&s_checkpoint, 0, sizeof(s_checkpoint));
+    s_checkpoint.magic = CHECKPOINT_MAGIC;
+    s_checkpoint.kind = kind;
+    memcpy(s_checkpoint.data, data, (size < CHECKPOINT_DATA_SIZE) ? size : CHECKPOINT_DATA_SIZE);
+    s_checkpoint.checksum = checkpoint_checksum(&s_checkpoint);
+}
+
+void checkpoint_point(uint32_t point, uint32_t estimate_us)
+{
+    uint64_t timeout_ms = CHECKPOINT_WATCHDOG_MS + (estimate_us / 1000);
+
+    s_checkpoint.point = point;
+    s_checkpoint.checksum = checkpoint_checksum(&s_checkpoint);
+
+    //  Enabling again starts the count from the top
+    if (timeout_ms <= CHECKPOINT_WATCHDOG_MAX_MS)
+    {
+        watchdog_enable((uint32_t)timeout_ms, true);
+        s_watchdog_load = (uint32_t)timeout_ms * 1000;
+        mem_kernel_set_pass_hook(checkpoint_feed);
+    }
+    else
+    {
+        watchdog_disable();
+        mem_kernel_set_pass_hook(NULL);
+    }
+}
+
+void checkpoint_end(void)
+{
+    mem_kernel_set_pass_hook(NULL);
+    watchdog_disable();
+    s_checkpoint.magic = 0;
+}
+
+bool checkpoint_pending(checkpoint_kind *kind, uint32_t *point, void *data, size_t size)
+{
+    bool pending = watchdog_enable_caused_reboot() && (s_checkpoint.magic == CHECKPOINT_MAGIC) &&
+                   (s_checkpoint.checksum == checkpoint_checksum(&s_checkpoint)) && (s_checkpoint.kind < CHECKPOINT_KINDS);
+
+    if (pending)
+    {
+        *kind = (checkpoint_kind)s_checkpoint.kind;
+        *point = s_checkpoint.point;
+        memcpy(data, s_checkpoint.data, (size < CHECKPOINT_DATA_SIZE) ? size : CHECKPOINT_DATA_SIZE);
+    }
+
+    s_checkpoint.magic = 0;
+    return pending;
+}
+
+void checkpoint_report_hang(checkpoint_kind kind, uint32_t point)
+{
+    result_record record;
+
+    result_begin(&record, "Hang");
+    result_str(&record, "sweep", checkpoint_kind_name(kind));
+    result_u64(&record, "point", point);
+    result_end(&record);
+}
+
+uint32_t checkpoint_estimate_us(uint32_t buffer_size)
+{
+    uint64_t us = ((uint64_t)buffer_size * CHECKPOINT_ACCESS_NS) / 1000;
+
+    return (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
@@ -0,0 +1,87 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Watchdog protected, resumable sweeps
+//
+//  A runner that might hang the board (a shmoo, a plan or sweep at an
+//  aggressive clock or timing) calls checkpoint_begin() with its own
+//  description of the sweep, and checkpoint_point() before every point.
+//  That arms the watchdog for the point and remembers which point it was,
+//  in uninitialised SRAM that a watchdog reset leaves alone.  At start up
+//  checkpoint_pending() hands back the sweep and the point that hung, and
+//  the runner reports it and carries on from the next point.  Results
+//  already out are in the flash result log as well as on the serial port.
+//
+//  While a point runs the memory kernels feed the watchdog before every pass
+//  over the buffer, so however many loops a point has the watchdog only has
+//  to cover one pass, and the calibration, printing and flushing around it.
+//  The watchdog counts at most 16.7s, a pass estimated to take longer than
+//  that (tens of MB, more than the PSRAM) would run unprotected.
+
+#ifndef BENCH_CHECKPOINT_H
+#define BENCH_CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define CHECKPOINT_MAGIC            0x54504B43      //  "CKPT"
+#define CHECKPOINT_DATA_SIZE        64
+#define CHECKPOINT_WATCHDOG_MS      5000            //  Allowed on top of a point's estimate
+#define CHECKPOINT_WATCHDOG_MAX_MS  16000
+#define CHECKPOINT_ACCESS_NS        750             //  Worst case kernel access, random ROM / uncached PSRAM in results/
+
+typedef enum
+{
+    CHECKPOINT_NONE,
+    CHECKPOINT_SHMOO,
+    CHECKPOINT_PLAN,
+    CHECKPOINT_SWEEP,
+    CHECKPOINT_BER,
+    CHECKPOINT_KINDS
+} checkpoint_kind;
+
+//  data is the runner's, up to CHECKPOINT_DATA_SIZE bytes, enough to start the sweep again
+void checkpoint_begin(checkpoint_kind kind, const void *data, size_t size);
+
+//  Before each point, estimate_us is the longest it goes without a kernel
+//  pass feeding the watchdog, 0 if it's short
+void checkpoint_point(uint32_t point, uint32_t estimate_us);
+
+//  Sweep finished, watchdog off
+void checkpoint_end(void);
+
+//  After a watchdog reset, the sweep it interrupted and the point that hung.
+//  Forgotten once read, the resumed sweep begins again.
+bool checkpoint_pending(checkpoint_kind *kind, uint32_t *point, void *data, size_t size);
+
+//  "Hang" record for a point that never finished
+void checkpoint_report_hang(checkpoint_kind kind, uint32_t point);
+
+//  One kernel pass over buffer_size words at CHECKPOINT_ACCESS_NS
+uint32_t checkpoint_estimate_us(uint32_t buffer_size);
+
+const char *checkpoint_kind_name(checkpoint_kind kind);
+
+#endif
@@ -0,0 +1,193 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include <stdio.h>
+
+#include "PicoMemPerf.h"
+#include "isolation.h"
+#include "result_out.h"
+#include "result_log.h"
+#include "bench_check.h"
+#include "monitor_trend.h"
+#include "bench_monitor.h"
+
+//  Short tests that see the PSRAM timing, and SRAM as a control
+static const char * const s_monitor_tests[] =
+{
+    "SEQ SRAM READ",
+    "SEQ PSRAM READ",
+    "SEQ PSRAM NOCACHE READ",
+    "RND PSRAM NOCACHE READ",
+    "SEQ PSRAM NOCACHE WRITE",
+};
+#define MONITOR_TESTS       (sizeof(s_monitor_tests) / sizeof(s_monitor_tests[0]))
+
+#define MONITOR_ADC_SAMPLES 16
+
+static bool s_monitor_running = false;
+static bool s_monitor_adc = false;
+static uint32_t s_monitor_interval_us = MONITOR_INTERVAL_S * 1000000;
+static uint64_t s_monitor_next_us = 0;
+static uint32_t s_monitor_samples = 0;
+
+static monitor_trend s_monitor_temp;
+static monitor_trend s_monitor_trends[MONITOR_TESTS];
+static bool s_monitor_failed[MONITOR_TESTS];
+
+float bench_monitor_temperature(void)
+{
+    uint32_t total = 0;
+
+    if (!s_monitor_adc)
+    {
+        adc_init();
+        adc_set_temp_sensor_enabled(true);
+        s_monitor_adc = true;
+    }
+
+    //  The channel is 4 on the RP2350A and 8 on the RP2350B, the SDK knows which
+    adc_select_input(ADC_TEMPERATURE_CHANNEL_NUM);
+    for (int i = 0; i < MONITOR_ADC_SAMPLES; i++)
+    {
+        total += adc_read();
+    }
+
+    //  Datasheet conversion, 0.706V at 27C and -1.721mV per degree
+    float volts = ((float)total / MONITOR_ADC_SAMPLES) * (3.3f / 4096.0f);
+    return 27.0f - ((volts - 0.706f) / 0.001721f);
+}
+
+static void monitor_records(void)
+{
+    result_record record;
+
+    result_begin(&record, "Monitor temp");
+    result_u64(&record, "sample", s_monitor_samples);
+    result_u64(&record, "uptime_s", time_us_64() / 1000000);
+    result_f32(&record, "temp_c", s_monitor_temp.last);
+    result_f32(&record, "ewma", s_monitor_temp.ewma);
+    result_f32(&record, "min", s_monitor_temp.min);
+    result_f32(&record, "max", s_monitor_temp.max);
+    result_f32(&record, "drift", monitor_trend_drift(&s_monitor_temp));
+    result_end(&record);
+
+    for (size_t i = 0; i < MONITOR_TESTS; i++)
+    {
+        const monitor_trend *trend = &s_monitor_trends[i];
+        float drift = monitor_trend_drift_pct(trend);
+
+        if (s_monitor_failed[i])
+        {
+            printf("Error, monitor, %s\n", s_monitor_tests[i]);
+            continue;
+        }
+
+        result_begin(&record, "Monitor");
+        result_u64(&record, "sample", s_monitor_samples);
+        result_str(&record, "test", s_monitor_tests[i]);
+        result_u64(&record, "result", (uint64_t)trend->last);
+        result_f32(&record, "ewma", trend->ewma);
+        result_f32(&record, "min", trend->min);
+        result_f32(&record, "max", trend->max);
+        result_f32(&record, "drift_pct", drift);
+        result_u64(&record, "alert", ((drift > MONITOR_DRIFT_PCT) || (drift < -MONITOR_DRIFT_PCT)) ? 1 : 0);
+        result_end(&record);
+    }
+}
+
+void bench_monitor_sample(void)
+{
+    uint64_t us;
+
+    //  Temperature before the tests warm anything up
+    monitor_trend_add(&s_monitor_temp, bench_monitor_temperature(), MONITOR_EWMA_ALPHA);
+
+    for (size_t i = 0; i < MONITOR_TESTS; i++)
+    {
+        s_monitor_failed[i] = !bench_check_measure(s_monitor_tests[i], MONITOR_LOOP_SCALE, MONITOR_REPS, &us);
+        if (!s_monitor_failed[i])
+        {
+            monitor_trend_add(&s_monitor_trends[i], (float)us, MONITOR_EWMA_ALPHA);
+        }
+    }
+    isolation_flush();
+
+    s_monitor_samples++;
+    monitor_records();
+}
+
+void bench_monitor_start(uint32_t interval_s)
+{
+    s_monitor_interval_us = ((interval_s != 0) ? interval_s : 1) * 1000000;
+    s_monitor_next_us = time_us_64();
+    s_monitor_running = true;
+}
+
+void bench_monitor_stop(void)
+{
+    s_monitor_running = false;
+}
+
+bool bench_monitor_running(void)
+{
+    return s_monitor_running;
+}
+
+void bench_monitor_reset(void)
+{
+    monitor_trend_reset(&s_monitor_temp);
+    for (size_t i = 0; i < MONITOR_TESTS; i++)
+    {
+        monitor_trend_reset(&s_monitor_trends[i]);
+        s_monitor_failed[i] = false;
+    }
+    s_monitor_samples = 0;
+}
+
+void bench_monitor_poll(void)
+{
+    uint64_t now = time_us_64();
+
+    if (!s_monitor_running || (now < s_monitor_next_us))
+    {
+        return;
+    }
+
+    //  From now rather than the last due time, a long command shouldn't make a burst
+    s_monitor_next_us = now + s_monitor_interval_us;
+    bench_monitor_sample();
+    result_log_flush();
+}
+
+void bench_monitor_status(void)
+{
+    printf("Monitor, %s, interval_s, %lu, samples, %lu\n", s_monitor_running ? "on" : "off",
+           (long unsigned int)(s_monitor_interval_us / 1000000), (long unsigned int)s_monitor_samples);
+    if (s_monitor_samples != 0)
+    {
+        monitor_records();
+    }
+}
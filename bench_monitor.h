@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Background monitoring for long soaks
+//
+//  While the shell is idle, every interval the monitor reads the on-chip
+//  temperature sensor and runs a handful of short tests, and keeps a trend
+//  of each (monitor_trend.h).  Every sample is a "Monitor temp" record and
+//  a "Monitor" record per test with the EWMA, min, max and drift from the
+//  first few samples, alert is set once a test drifts more than
+//  MONITOR_DRIFT_PCT either way.  With the flash result log on a soak can
+//  run with nothing attached.
+
+#ifndef BENCH_MONITOR_H
+#define BENCH_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MONITOR_INTERVAL_S          60
+#define MONITOR_LOOP_SCALE          1
+#define MONITOR_REPS                3
+#define MONITOR_EWMA_ALPHA          0.1f
+#define MONITOR_DRIFT_PCT           5.0f
+
+void bench_monitor_start(uint32_t interval_s);
+void bench_monitor_stop(void);
+bool bench_monitor_running(void);
+
+//  Forget the trends, the next samples make a new baseline
+void bench_monitor_reset(void);
+
+//  Take a sample now, running or not
+void bench_monitor_sample(void);
+
+//  From the idle loop, samples when one is due
+void bench_monitor_poll(void);
+
+//  Latest trends, without sampling
+void bench_monitor_status(void);
+
+//  Die temperature from the ADC
+float bench_monitor_temperature(void);
+
+#endif
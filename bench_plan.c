@@ -0,0 +1,410 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PicoMemPerf.h"
+#include "bench_plan.h"
+#include "run_header.h"
+#include "result_out.h"
+#include "result_log.h"
+#include "bench_checkpoint.h"
+
+test_plan s_bench_plan;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t length;                    //  Text bytes after the header
+    uint32_t checksum;                  //  FNV-1a of the text
+    uint32_t reserved;
+} plan_flash_header;
+
+void bench_plan_limits(plan_limits *limits)
+{
+    limits->buffer_words = TEST_SIZE;
+    limits->psram_bytes = _psram_size;
+}
+
+plan_region bench_plan_region_of(const memory_test_config *config)
+{
+    if (config->buffer == s_test_memory)
+    {
+        return PLAN_REGION_SRAM;
+    }
+    if (config->buffer == (uint32_t *)s_testROM)
+    {
+        return PLAN_REGION_ROM;
+    }
+    return (((uintptr_t)config->buffer) & XIP_NOCACHE_OFFSET) ? PLAN_REGION_NOCACHE : PLAN_REGION_PSRAM;
+}
+
+//  Windows that fit stay in the test buffers, larger PSRAM reads run from the
+//  start of PSRAM (test_window() checks the end).  Anything that would write
+//  outside a test buffer is refused.
+bool bench_plan_place(memory_test_config *config, plan_region region)
+{
+    plan_limits limits;
+    plan_entry entry = { .region = region, .kernel = PLAN_KERNEL_LCG, .read = config->read, .random = config->random,
+                         .size_first = config->buffer_size, .size_last = config->buffer_size,
+                         .loop_scale = (uint32_t)config->loop_scale, .offset = config->buffer_offset, .repetitions = 1 };
+
+    //  Same rules as the host validator
+    bench_plan_limits(&limits);
+    const char *error = test_plan_check_entry(&entry, &limits);
+    if (error != NULL)
+    {
+        printf("Error, %s, %s\n", config->test_name, error);
+        return false;
+    }
+
+    bool fits = (config->buffer_offset + (config->buffer_size * sizeof(uint32_t))) <= (TEST_SIZE * sizeof(uint32_t));
+
+    switch (region)
+    {
+        case PLAN_REGION_SRAM:
+            config->buffer = s_test_memory;
+            break;
+        case PLAN_REGION_ROM:
+            config->buffer = (uint32_t *)s_testROM;
+            break;
+        case PLAN_REGION_PSRAM:
+            config->buffer = fits ? s_psram_test_memory : (uint32_t *)PSRAM_LOCATION;
+            break;
+        default:
+            config->buffer = fits ? (uint32_t *)PSRAM_NOCACHE(s_psram_test_memory) : (uint32_t *)PSRAM_LOCATION_NOCAHE;
+            break;
+    }
+
+    return true;
+}
+
+//  Where a run is, for skipping to and past the point a watchdog reset interrupted
+typedef struct
+{
+    uint32_t point;                     //  Every repetition of every size is one
+    uint32_t first;
+    uint32_t hung;                      //  UINT32_MAX for none
+} plan_progress;
+
+static void bench_plan_run_entry(const test_plan *plan, const plan_entry *entry, plan_progress *progress)
+{
+    uint32_t size = entry->size_first;
+
+    do
+    {
+        memory_test_config config = { NULL, size, (int)entry->loop_scale, entry->read, entry->random, (char *)entry->name, 0, 0, entry->offset };
+        uint32_t *window;
+
+        //  Already done before the reset
+        if (progress->point + entry->repetitions <= progress->first)
+        {
+            progress->point += entry->repetitions;
+            continue;
+        }
+
+        if (!bench_plan_place(&config, entry->region) || ((window = test_window(&config)) == NULL))
+        {
+            printf("Plan skipped, %s, %s, %lu\n", plan->name, entry->name, (long unsigned int)size);
+            progress->point += entry->repetitions;
+            continue;
+        }
+
+        //  The kernels use the index table whenever one of the right size exists
+        if (entry->kernel == PLAN_KERNEL_TABLE)
+        {
+            if (!index_table_init(size))
+            {
+                printf("Plan skipped, %s, %s, %lu, no memory for the index table\n", plan->name, entry->name, (long unsigned int)size);
+                progress->point += entry->repetitions;
+                continue;
+            }
+        }
+        else
+        {
+            index_table_free();
+        }
+
+        for (uint32_t rep = 0; rep < entry->repetitions; rep++, progress->point++)
+        {
+            if (progress->point < progress->first)
+            {
+                continue;
+            }
+            if (progress->point == progress->hung)
+            {
+                isolation_flush();
+                printf("Plan hang, %s, %s, %lu, %lu\n", plan->name, entry->name, (long unsigned int)size, (long unsigned int)rep);
+                continue;
+            }
+
+            checkpoint_point(progress->point, checkpoint_estimate_us(size));
+            isolate_begin();
+            config.overhead = calibrate_overhead(size, config.loop_scale, config.read, config.random);
+            config.result = memory_test(window, size, config.loop_scale, config.read, config.random);
+            isolate_end();
+
+            uint64_t corrected = (config.result > config.overhead) ? (config.result - config.overhead) : 0;
+
+            plan_result(plan, entry, size, rep, (uint32_t)(uintptr_t)window, config.result, config.overhead, corrected);
+        }
+
+        index_table_free();
+
+        //  What's done so far survives a hang in the next size
+        isolation_flush();
+        result_log_flush();
+    }
+    while (test_plan_next_size(entry, &size));
+}
+
+static void bench_plan_run_from(const test_plan *plan, uint32_t first, uint32_t hung)
+{
+    plan_progress progress = { 0, first, hung };
+    uint32_t id = bench_plan_id(plan);
+
+    print_run_header();
+    result_csv_line(PLAN_RESULT_CSV_HEADER);
+
+    checkpoint_begin(CHECKPOINT_PLAN, &id, sizeof(id));
+    for (int i = 0; i < plan->count; i++)
+    {
+        bench_plan_run_entry(plan, &plan->entries[i], &progress);
+    }
+    checkpoint_end();
+    isolation_flush();
+}
+
+void bench_plan_run(const test_plan *plan)
+{
+    bench_plan_run_from(plan, 0, UINT32_MAX);
+}
+
+void bench_plan_resume(const void *data, uint32_t hung)
+{
+    uint32_t id;
+
+    //  Only a plan kept in flash is still around after the reset
+    memcpy(&id, data, sizeof(id));
+    if (!bench_plan_load_flash(&s_bench_plan) || (bench_plan_id(&s_bench_plan) != id))
+    {
+        printf("Error, resume, the plan isn't the one in flash\n");
+        test_plan_init(&s_bench_plan);
+        return;
+    }
+
+    bench_plan_run_from(&s_bench_plan, hung, hung);
+}
+
+
+//  One test over a range of sizes, the "sweep" shell command
+
+typedef struct
+{
+    uint32_t test;                      //  Index in s_memory_test_config
+    uint32_t region;
+    uint32_t last;
+    uint32_t factor;
+    int32_t loop_scale;                 //  The rest of the test as "set" left it
+    uint32_t buffer_offset;
+    uint8_t read;
+    uint8_t random;
+} plan_sweep;
+
+//  From size first, hung is the size a watchdog reset interrupted (or 0)
+static void bench_plan_sweep_run(const plan_sweep *sweep, uint32_t first, uint32_t hung)
+{
+    memory_test_config config = s_memory_test_config[sweep->test];
+
+    config.loop_scale = sweep->loop_scale;
+    config.buffer_offset = sweep->buffer_offset;
+    config.read = sweep->read;
+    config.random = sweep->random;
+
+    checkpoint_begin(CHECKPOINT_SWEEP, sweep, sizeof(plan_sweep));
+    for (uint64_t size = first; size <= sweep->last; size *= sweep->factor)
+    {
+        memory_test_config point = config;
+
+        if (size == hung)
+        {
+            printf("Sweep hang, %s, %lu\n", config.test_name, (long unsigned int)size);
+            continue;
+        }
+
+        point.buffer_size = (uint32_t)size;
+        if (!bench_plan_place(&point, (plan_region)sweep->region))
+        {
+            break;
+        }
+        checkpoint_point((uint32_t)size, checkpoint_estimate_us(point.buffer_size));
+        run_test(&point);
+        isolation_flush();
+        result_log_flush();
+    }
+    checkpoint_end();
+}
+
+void bench_plan_sweep(const memory_test_config *config, uint32_t first, uint32_t last, uint32_t factor)
+{
+    plan_sweep sweep = { (uint32_t)(config - s_memory_test_config), bench_plan_region_of(config), last, factor,
+                         config->loop_scale, config->buffer_offset, config->read, config->random };
+
+    bench_plan_sweep_run(&sweep, first, 0);
+}
+
+void bench_plan_resume_sweep(const void *data, uint32_t hung)
+{
+    plan_sweep sweep;
+
+    memcpy(&sweep, data, sizeof(plan_sweep));
+    if ((sweep.test >= (uint32_t)s_memory_test_count) || (sweep.factor < 2) || (hung == 0))
+    {
+        return;
+    }
+
+    bench_plan_sweep_run(&sweep, hung, hung);
+}
+
+
+//  Flash plan partition
+
+static uint32_t plan_checksum(const uint8_t *data, uint32_t length)
+{
+    uint32_t hash = 0x811C9DC5;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+uint32_t bench_plan_id(const test_plan *plan)
+{
+    size_t length = test_plan_format(plan, NULL, 0);
+    char *text = malloc(length + 1);
+    uint32_t id = 0;
+
+    if (text != NULL)
+    {
+        test_plan_format(plan, text, length + 1);
+        id = plan_checksum((const uint8_t *)text, length);
+        free(text);
+    }
+    return id;
+}
+
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t length;                    //  Multiple of FLASH_PAGE_SIZE, 0 to just erase
+} plan_flash_write;
+
+//  Runs with the other core and interrupts locked out.  The SDK flash routines
+//  put the QMI CS1 (PSRAM) setup back afterwards.
+static void __not_in_flash_func(plan_flash_program)(void *param)
+{
+    const plan_flash_write *write = (const plan_flash_write *)param;
+
+    flash_range_erase(PLAN_FLASH_OFFSET, PLAN_FLASH_SIZE);
+    if (write->length != 0)
+    {
+        flash_range_program(PLAN_FLASH_OFFSET, write->data, write->length);
+    }
+}
+
+bool bench_plan_save(const test_plan *plan)
+{
+    size_t text_length = test_plan_format(plan, NULL, 0);
+    uint32_t length = (sizeof(plan_flash_header) + text_length + 1 + (FLASH_PAGE_SIZE - 1)) & ~(FLASH_PAGE_SIZE - 1);
+
+    if (length > PLAN_FLASH_SIZE)
+    {
+        printf("Error, plan too big for flash, %d\n", (int)text_length);
+        return false;
+    }
+
+    uint8_t *data = malloc(length);
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    memset(data, 0xFF, length);
+    plan_flash_header *header = (plan_flash_header *)data;
+    char *text = (char *)(data + sizeof(plan_flash_header));
+
+    test_plan_format(plan, text, text_length + 1);
+    header->magic = PLAN_FLASH_MAGIC;
+    header->length = text_length;
+    header->checksum = plan_checksum((const uint8_t *)text, text_length);
+    header->reserved = 0;
+
+    plan_flash_write write = { data, length };
+    int result = flash_safe_execute(plan_flash_program, &write, PLAN_FLASH_TIMEOUT_MS);
+    free(data);
+
+    if (result != PICO_OK)
+    {
+        printf("Error, plan flash write, %d\n", result);
+        return false;
+    }
+
+    return true;
+}
+
+bool bench_plan_erase(void)
+{
+    plan_flash_write write = { NULL, 0 };
+
+    return flash_safe_execute(plan_flash_program, &write, PLAN_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+bool bench_plan_load_flash(test_plan *plan)
+{
+    const plan_flash_header *header = (const plan_flash_header *)(XIP_BASE + PLAN_FLASH_OFFSET);
+    const char *text = (const char *)(header + 1);
+    plan_limits limits;
+
+    if ((header->magic != PLAN_FLASH_MAGIC) || (header->length > (PLAN_FLASH_SIZE - sizeof(plan_flash_header))) ||
+        (header->checksum != plan_checksum((const uint8_t *)text, header->length)))
+    {
+        return false;
+    }
+
+    bench_plan_limits(&limits);
+    if (!test_plan_parse(plan, text, header->length, &limits))
+    {
+        printf("Plan error, flash, %d, %s\n", plan->error_line, plan->error);
+        return false;
+    }
+
+    return true;
+}
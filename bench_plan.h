@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Running test plans on the board, and the flash plan partition
+
+#ifndef BENCH_PLAN_H
+#define BENCH_PLAN_H
+
+#include "PicoMemPerf.h"
+#include "test_plan.h"
+
+//  Plan partition, the last PLAN_FLASH_SIZE bytes of flash.  Keep the image
+//  out of it.
+#define PLAN_FLASH_SIZE         (16 * 1024)
+#define PLAN_FLASH_OFFSET       (PICO_FLASH_SIZE_BYTES - PLAN_FLASH_SIZE)
+#define PLAN_FLASH_MAGIC        0x4E414C50      //  "PLAN"
+#define PLAN_FLASH_TIMEOUT_MS   1000
+
+//  The plan the shell loads / runs and the one run from flash at start up
+extern test_plan s_bench_plan;
+
+//  TEST_SIZE buffers and the PSRAM that was found
+void bench_plan_limits(plan_limits *limits);
+
+//  Point a test at a region, picks the test buffer or (large PSRAM reads) the
+//  start of PSRAM.  Prints why and returns false if it can't.
+bool bench_plan_place(memory_test_config *config, plan_region region);
+plan_region bench_plan_region_of(const memory_test_config *config);
+
+//  Every entry, size and repetition, one "Plan" CSV row each.  Each
+//  repetition is a checkpoint (bench_checkpoint.h), after a hang
+//  bench_plan_resume() carries on from the next one if the plan is in flash.
+void bench_plan_run(const test_plan *plan);
+void bench_plan_resume(const void *data, uint32_t hung);
+
+//  FNV-1a of the plan as text, tells a resumed run it has the same plan
+uint32_t bench_plan_id(const test_plan *plan);
+
+//  One test over sizes first, first * factor ... last, a checkpoint per size
+void bench_plan_sweep(const memory_test_config *config, uint32_t first, uint32_t last, uint32_t factor);
+void bench_plan_resume_sweep(const void *data, uint32_t hung);
+
+//  Plan partition, stored as text
+bool bench_plan_save(const test_plan *plan);
+bool bench_plan_load_flash(test_plan *plan);
+bool bench_plan_erase(void);
+
+#endif
@@ -0,0 +1,676 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PicoMemPerf.h"
+#include "alloc_bench.h"
+#include "psram_bench.h"
+#include "isolation.h"
+#include "shell.h"
+#include "test_plan.h"
+#include "bench_plan.h"
+#include "result_log.h"
+#include "bench_check.h"
+#include "bench_monitor.h"
+#include "bench_shmoo.h"
+#include "bench_ber.h"
+#include "run_header.h"
+#include "bench_shell.h"
+
+static const char * const s_pattern_names[] = { "seq", "rnd" };
+static const char * const s_op_names[] = { "write", "read" };
+
+//  By index, or by name with '_' for the spaces
+static memory_test_config *find_test(const char *text)
+{
+    uint32_t index;
+
+    if (shell_parse_uint(text, &index))
+    {
+        return (index < s_memory_test_count) ? &s_memory_test_config[index] : NULL;
+    }
+
+    for (int i = 0; i < s_memory_test_count; i++)
+    {
+        const char *name = s_memory_test_config[i].test_name;
+        int c;
+
+        for (c = 0; (name[c] != 0) && (text[c] != 0); c++)
+        {
+            char a = (name[c] == ' ') ? '_' : name[c];
+            char b = text[c];
+            if ((a | 0x20) != (b | 0x20))
+            {
+                break;
+            }
+        }
+        if ((name[c] == 0) && (text[c] == 0))
+        {
+            return &s_memory_test_config[i];
+        }
+    }
+
+    printf("Error, no test, %s\n", text);
+    return NULL;
+}
+
+static void print_test(int index, const memory_test_config *config)
+{
+    printf("List, %d, %s, %s, %s, %s, %d, %d, %lu, 0x%08lX\n", index, config->test_name,
+           test_plan_region_name(bench_plan_region_of(config)), s_pattern_names[config->random ? 1 : 0], s_op_names[config->read ? 1 : 0],
+           (int)config->buffer_size, config->loop_scale, (long unsigned int)config->buffer_offset, (long unsigned int)test_window(config));
+}
+
+
+//  Commands
+
+static int cmd_help(shell *sh, int argc, char **argv)
+{
+    shell_help(sh);
+    return SHELL_OK;
+}
+
+static int cmd_info(shell *sh, int argc, char **argv)
+{
+    printf("Info, clock_hz, %d, psram_size, %d, free_heap, %d, free_psram_heap, %d, isolation, 0x%02lX\n",
+           (int)clock_get_hz(clk_sys), (int)_psram_size, (int)getFreeHeap(), (int)getFreePsramHeap(), (long unsigned int)isolation_get_mode());
+    return SHELL_OK;
+}
+
+static int cmd_header(shell *sh, int argc, char **argv)
+{
+    print_run_header();
+    return SHELL_OK;
+}
+
+static int cmd_list(shell *sh, int argc, char **argv)
+{
+    printf("List, index, test, region, pattern, op, size, loops, offset, window\n");
+    for (int i = 0; i < s_memory_test_count; i++)
+    {
+        print_test(i, &s_memory_test_config[i]);
+    }
+    return SHELL_OK;
+}
+
+static int cmd_set(shell *sh, int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        return SHELL_USAGE;
+    }
+
+    memory_test_config *config = find_test(argv[1]);
+    if (config == NULL)
+    {
+        return SHELL_ERROR;
+    }
+
+    //  Work on a copy so a refused change leaves the test as it was
+    memory_test_config changed = *config;
+    plan_region region = bench_plan_region_of(config);
+    uint32_t value;
+    int match;
+
+    if (strcmp(argv[2], "size") == 0)
+    {
+        if (!shell_parse_uint(argv[3], &value))
+        {
+            return SHELL_USAGE;
+        }
+        changed.buffer_size = value;
+    }
+    else if (strcmp(argv[2], "loops") == 0)
+    {
+        if (!shell_parse_uint(argv[3], &value) || (value == 0) || (value > INT32_MAX))
+        {
+            return SHELL_USAGE;
+        }
+        changed.loop_scale = (int)value;
+    }
+    else if (strcmp(argv[2], "offset") == 0)
+    {
+        if (!shell_parse_uint(argv[3], &value) || ((value % sizeof(uint32_t)) != 0))
+        {
+            return SHELL_USAGE;
+        }
+        changed.buffer_offset = value;
+    }
+    else if (strcmp(argv[2], "region") == 0)
+    {
+        if ((match = test_plan_region_match(argv[3])) < 0)
+        {
+            return SHELL_USAGE;
+        }
+        region = (plan_region)match;
+    }
+    else if (strcmp(argv[2], "pattern") == 0)
+    {
+        if ((match = shell_match(argv[3], s_pattern_names, 2)) < 0)
+        {
+            return SHELL_USAGE;
+        }
+        changed.random = (match == 1);
+    }
+    else if (strcmp(argv[2], "op") == 0)
+    {
+        if ((match = shell_match(argv[3], s_op_names, 2)) < 0)
+        {
+            return SHELL_USAGE;
+        }
+        changed.read = (match == 1);
+    }
+    else
+    {
+        return SHELL_USAGE;
+    }
+
+    if (!bench_plan_place(&changed, region))
+    {
+        return SHELL_ERROR;
+    }
+
+    changed.result = 0;
+    changed.overhead = 0;
+    *config = changed;
+    print_test((int)(config - s_memory_test_config), config);
+
+    return SHELL_OK;
+}
+
+static int cmd_run(shell *sh, int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        return SHELL_USAGE;
+    }
+
+    if (strcmp(argv[1], "all") == 0)
+    {
+        run_tests();
+        isolation_flush();
+        return SHELL_OK;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        memory_test_config *config = find_test(argv[i]);
+        if (config == NULL)
+        {
+            return SHELL_ERROR;
+        }
+        run_test(config);
+    }
+    isolation_flush();
+
+    return SHELL_OK;
+}
+
+//  Doubles (or multiplies by factor) the size from first to last, the test
+//  itself is left as it was
+static int cmd_sweep(shell *sh, int argc, char **argv)
+{
+    uint32_t first, last, factor = 2;
+
+    if ((argc < 4) || (argc > 5) ||
+        !shell_parse_uint(argv[2], &first) || !shell_parse_uint(argv[3], &last) ||
+        ((argc == 5) && !shell_parse_uint(argv[4], &factor)) || (first == 0) || (factor < 2))
+    {
+        return SHELL_USAGE;
+    }
+
+    memory_test_config *config = find_test(argv[1]);
+    if (config == NULL)
+    {
+        return SHELL_ERROR;
+    }
+
+    bench_plan_sweep(config, first, last, factor);
+
+    return SHELL_OK;
+}
+
+static int cmd_latency(shell *sh, int argc, char **argv)
+{
+    uint32_t samples = LATENCY_SAMPLES;
+    uint32_t batch = LATENCY_BATCH;
+
+    if ((argc < 2) || (argc > 4) ||
+        ((argc > 2) && !shell_parse_uint(argv[2], &samples)) ||
+        ((argc > 3) && (!shell_parse_uint(argv[3], &batch) || (batch == 0) || (batch > LATENCY_MAX_BATCH))))
+    {
+        return SHELL_USAGE;
+    }
+
+    print_latency_header();
+
+    if (strcmp(argv[1], "all") == 0)
+    {
+        for (int i = 0; i < s_memory_test_count; i++)
+        {
+            run_latency_test(&s_memory_test_config[i], samples, batch);
+        }
+    }
+    else
+    {
+        memory_test_config *config = find_test(argv[1]);
+        if (config == NULL)
+        {
+            return SHELL_ERROR;
+        }
+        run_latency_test(config, samples, batch);
+    }
+    isolation_flush();
+
+    return SHELL_OK;
+}
+
+static int cmd_results(shell *sh, int argc, char **argv)
+{
+    printf("Result, test, window, size, result, overhead, corrected\n");
+    for (int i = 0; i < s_memory_test_count; i++)
+    {
+        const memory_test_config *config = &s_memory_test_config[i];
+
+        if (config->result != 0)
+        {
+            uint64_t corrected = (config->result > config->overhead) ? (config->result - config->overhead) : 0;
+            printf("Result, %s, 0x%08lX, %d, %d, %d, %d\n", config->test_name, (long unsigned int)test_window(config),
+                   (int)config->buffer_size, (int)config->result, (int)config->overhead, (int)corrected);
+        }
+    }
+    return SHELL_OK;
+}
+
+static int cmd_isolation(shell *sh, int argc, char **argv)
+{
+    uint32_t flags;
+
+    if ((argc != 2) || !shell_parse_uint(argv[1], &flags))
+    {
+        return SHELL_USAGE;
+    }
+
+    isolation_set_mode(flags);
+    return SHELL_OK;
+}
+
+static int cmd_format(shell *sh, int argc, char **argv)
+{
+    int format;
+
+    if (argc == 1)
+    {
+        printf("Format, %s\n", result_format_name(result_get_format()));
+        return SHELL_OK;
+    }
+    if ((argc != 2) || ((format = result_format_match(argv[1])) < 0))
+    {
+        return SHELL_USAGE;
+    }
+
+    result_set_format((result_format)format);
+    return SHELL_OK;
+}
+
+static int cmd_bench(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "alloc", "tier", "pool", "cache", "stream", "wc", "heatmap", "ab", "memtest", "all" };
+
+    if (argc != 2)
+    {
+        return SHELL_USAGE;
+    }
+
+    switch (shell_match(argv[1], names, sizeof(names) / sizeof(names[0])))
+    {
+        case 0:  run_alloc_bench(); break;
+        case 1:  run_tier_bench(); break;
+        case 2:  run_pool_bench(); break;
+        case 3:  run_page_cache_bench(); break;
+        case 4:  run_stream_bench(); break;
+        case 5:  run_write_combine_bench(); break;
+        case 6:
+        {
+            heatmap_config heatmap = { HEATMAP_WINDOW_WORDS, HEATMAP_STEP_BYTES, HEATMAP_LOOP_SCALE, true };
+            run_heatmap(&heatmap);
+            break;
+        }
+        case 7:  run_isolation_ab(ISOLATION_AB_MODE, ISOLATION_AB_LOOPS, ISOLATION_AB_REPS); break;
+        case 8:  test_mem(); break;
+        case 9:  run_all(); break;
+        default: return SHELL_USAGE;
+    }
+
+    return SHELL_OK;
+}
+
+//  Lines after "plan load" go to the plan parser until "end"
+static int plan_load_line(shell *sh, char *line)
+{
+    static int s_line_number = 0;
+    int result = test_plan_parse_line(&s_bench_plan, line, ++s_line_number);
+    plan_limits limits;
+
+    if (result == PLAN_OK)
+    {
+        return SHELL_OK;
+    }
+
+    s_line_number = 0;
+    shell_capture(sh, NULL);
+
+    bench_plan_limits(&limits);
+    if ((result == PLAN_ERROR) || !test_plan_validate(&s_bench_plan, &limits))
+    {
+        printf("Plan error, %d, %s\n", s_bench_plan.error_line, s_bench_plan.error);
+        test_plan_init(&s_bench_plan);
+        return SHELL_ERROR;
+    }
+
+    printf("Plan loaded, %s, %d\n", s_bench_plan.name, s_bench_plan.count);
+    return SHELL_OK;
+}
+
+static int cmd_plan(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "show", "load", "run", "save", "flash", "erase" };
+    int action = (argc == 1) ? 0 : (argc == 2) ? shell_match(argv[1], names, sizeof(names) / sizeof(names[0])) : -1;
+
+    //  show, run and save need a plan
+    if (((action == 0) || (action == 2) || (action == 3)) && !s_bench_plan.complete)
+    {
+        printf("Error, no plan loaded\n");
+        return SHELL_ERROR;
+    }
+
+    switch (action)
+    {
+        case 0:
+        {
+            size_t length = test_plan_format(&s_bench_plan, NULL, 0);
+            char *text = malloc(length + 1);
+            if (text == NULL)
+            {
+                return SHELL_ERROR;
+            }
+            test_plan_format(&s_bench_plan, text, length + 1);
+            printf("%s", text);
+            free(text);
+            break;
+        }
+        case 1:
+            test_plan_init(&s_bench_plan);
+            shell_capture(sh, plan_load_line);
+            break;
+        case 2:
+            bench_plan_run(&s_bench_plan);
+            break;
+        case 3:
+            if (!bench_plan_save(&s_bench_plan))
+            {
+                return SHELL_ERROR;
+            }
+            break;
+        case 4:
+            if (!bench_plan_load_flash(&s_bench_plan))
+            {
+                printf("Error, no plan in flash\n");
+                test_plan_init(&s_bench_plan);
+                return SHELL_ERROR;
+            }
+            printf("Plan loaded, %s, %d\n", s_bench_plan.name, s_bench_plan.count);
+            break;
+        case 5:
+            if (!bench_plan_erase())
+            {
+                return SHELL_ERROR;
+            }
+            break;
+        default:
+            return SHELL_USAGE;
+    }
+
+    return SHELL_OK;
+}
+
+static int cmd_log(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "status", "dump", "on", "off", "erase" };
+
+    switch ((argc == 1) ? 0 : (argc == 2) ? shell_match(argv[1], names, sizeof(names) / sizeof(names[0])) : -1)
+    {
+        case 0:  result_log_status(); break;
+        case 1:  result_log_dump(); break;
+        case 2:  result_log_enable(true); break;
+        case 3:  result_log_flush(); result_log_enable(false); break;
+        case 4:
+            if (!result_log_erase())
+            {
+                return SHELL_ERROR;
+            }
+            break;
+        default: return SHELL_USAGE;
+    }
+
+    return SHELL_OK;
+}
+
+static int cmd_check(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "run", "capture", "show", "erase" };
+    self_check_bands bands = { SELF_CHECK_DEGRADED_PCT, SELF_CHECK_FAIL_PCT };
+
+    //  check [run] [degraded_pct fail_pct]
+    int command = ((argc == 1) || (argc == 3)) ? 0 : shell_match(argv[1], names, sizeof(names) / sizeof(names[0]));
+    int band_arg = (argc == 3) ? 1 : ((command == 0) && (argc == 4)) ? 2 : 0;
+
+    if (band_arg != 0)
+    {
+        if (!shell_parse_uint(argv[band_arg], &bands.degraded_pct) || !shell_parse_uint(argv[band_arg + 1], &bands.fail_pct) ||
+            (bands.degraded_pct > bands.fail_pct))
+        {
+            return SHELL_USAGE;
+        }
+    }
+    else if ((argc > 2) || (command < 0))
+    {
+        return SHELL_USAGE;
+    }
+
+    switch (command)
+    {
+        case 0:  bench_check_run(&bands); break;
+        case 1:  return bench_check_capture() ? SHELL_OK : SHELL_ERROR;
+        case 2:  bench_check_show(); break;
+        case 3:  return bench_check_erase() ? SHELL_OK : SHELL_ERROR;
+        default: return SHELL_USAGE;
+    }
+
+    return SHELL_OK;
+}
+
+static int cmd_monitor(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "status", "on", "off", "reset", "sample" };
+    uint32_t interval_s = MONITOR_INTERVAL_S;
+
+    int command = (argc == 1) ? 0 : shell_match(argv[1], names, sizeof(names) / sizeof(names[0]));
+    if ((argc > 3) || ((argc == 3) && ((command != 1) || !shell_parse_uint(argv[2], &interval_s) || (interval_s == 0))))
+    {
+        return SHELL_USAGE;
+    }
+
+    switch (command)
+    {
+        case 0:  bench_monitor_status(); break;
+        case 1:  bench_monitor_start(interval_s); break;
+        case 2:  bench_monitor_stop(); break;
+        case 3:  bench_monitor_reset(); break;
+        case 4:  bench_monitor_sample(); break;
+        default: return SHELL_USAGE;
+    }
+
+    return SHELL_OK;
+}
+
+//  shmoo [clkdiv <first> <last>] [rxdelay <first> <last>] [<MHz>...]
+static int cmd_shmoo(shell *sh, int argc, char **argv)
+{
+    shmoo_config config;
+    uint32_t first, last, mhz;
+    int clocks = 0;
+
+    bench_shmoo_default(&config);
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool clkdiv = (strcmp(argv[i], "clkdiv") == 0);
+
+        if (clkdiv || (strcmp(argv[i], "rxdelay") == 0))
+        {
+            if ((i + 2 >= argc) || !shell_parse_uint(argv[i + 1], &first) || !shell_parse_uint(argv[i + 2], &last) ||
+                (first > 255) || (last > 255))
+            {
+                return SHELL_USAGE;
+            }
+            if (clkdiv)
+            {
+                config.clkdiv_first = (uint8_t)first;
+                config.clkdiv_last = (uint8_t)last;
+            }
+            else
+            {
+                config.rxdelay_first = (uint8_t)first;
+                config.rxdelay_last = (uint8_t)last;
+            }
+            i += 2;
+        }
+        else if (shell_parse_uint(argv[i], &mhz) && (clocks < SHMOO_MAX_CLOCKS) && (mhz <= 255))
+        {
+            config.clock_mhz[clocks++] = (uint8_t)mhz;
+            config.clocks = clocks;
+        }
+        else
+        {
+            return SHELL_USAGE;
+        }
+    }
+
+    return bench_shmoo_run(&config) ? SHELL_OK : SHELL_ERROR;
+}
+
+//  ber [clkdiv <n>] [rxdelay <n>] [passes <n>] [target <errors per Gbit>] [confidence <percent>]
+static int cmd_ber(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "clkdiv", "rxdelay", "passes", "target", "confidence" };
+    ber_config config;
+    uint32_t value;
+
+    //  Option value pairs
+    if ((argc % 2) == 0)
+    {
+        return SHELL_USAGE;
+    }
+
+    bench_ber_default(&config);
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        int option = shell_match(argv[i], names, sizeof(names) / sizeof(names[0]));
+
+        if (option == 3)
+        {
+            char *end;
+            config.target_per_gbit = strtof(argv[i + 1], &end);
+            if ((end == argv[i + 1]) || (*end != '\0'))
+            {
+                return SHELL_USAGE;
+            }
+            continue;
+        }
+        if ((option < 0) || !shell_parse_uint(argv[i + 1], &value) || (value > 0xFFFF))
+        {
+            return SHELL_USAGE;
+        }
+        switch (option)
+        {
+            case 0:  config.clkdiv = (uint8_t)((value > 255) ? 255 : value); break;
+            case 1:  config.rxdelay = (uint8_t)((value > 255) ? 255 : value); break;
+            case 2:  config.passes = (uint16_t)value; break;
+            default: config.confidence_pct = (uint8_t)((value > 255) ? 255 : value); break;
+        }
+    }
+
+    return bench_ber_run(&config) ? SHELL_OK : SHELL_ERROR;
+}
+
+static const shell_command s_bench_commands[] =
+{
+    { "help", "", "This list", cmd_help },
+    { "info", "", "Clock, PSRAM size, free heaps, isolation flags", cmd_info },
+    { "header", "", "Build, chip, clock, voltage and QMI setup", cmd_header },
+    { "list", "", "Tests in the table", cmd_list },
+    { "set", "<test> size|loops|offset|region|pattern|op <value>", "Change a test, region sram|rom|psram|nocache, pattern seq|rnd, op read|write", cmd_set },
+    { "run", "<test>... | all", "Run tests by index or name (spaces as _)", cmd_run },
+    { "sweep", "<test> <first> <last> [factor]", "Run a test over a range of sizes in words", cmd_sweep },
+    { "latency", "<test> | all [samples] [batch]", "Per access latency histogram", cmd_latency },
+    { "results", "", "Last result of every test that has run", cmd_results },
+    { "isolation", "<flags>", "ISOLATE_* flags, 1 defer output, 2 no IRQ, 4 park USB", cmd_isolation },
+    { "plan", "[show|load|run|save|flash|erase]", "Test plans, load reads lines up to end, save / flash use the flash plan partition", cmd_plan },
+    { "format", "[csv|json|binary]", "Result record format, binary needs host/result_decode", cmd_format },
+    { "log", "[status|dump|on|off|erase]", "Flash result log, dump is binary frames for host/result_decode", cmd_log },
+    { "check", "[run [degraded% fail%]|capture|show|erase]", "Quick self check against the golden baseline, capture on a good board first", cmd_check },
+    { "monitor", "[status|on [seconds]|off|reset|sample]", "Temperature and short tests while idle, with EWMA / min / max drift", cmd_monitor },
+    { "shmoo", "[clkdiv <first> <last>] [rxdelay <first> <last>] [MHz...]", "PSRAM timing margins, pass / fail and MB/s over clock divider x RX delay x clk_sys", cmd_shmoo },
+    { "ber", "[clkdiv <n>] [rxdelay <n>] [passes <n>] [target <per Gbit>] [confidence <%>]", "PSRAM bit error rate at one timing, PRBS over the free PSRAM, errors per Gbit with bounds", cmd_ber },
+    { "bench", "alloc|tier|pool|cache|stream|wc|heatmap|ab|memtest|all", "Run one of the other benchmarks", cmd_bench },
+};
+
+void bench_shell_run(void)
+{
+    static shell s_shell;
+
+    shell_init(&s_shell, s_bench_commands, sizeof(s_bench_commands) / sizeof(s_bench_commands[0]), BENCH_SHELL_PROMPT, true);
+    shell_prompt(&s_shell);
+
+    while (true)
+    {
+        int c = getchar_timeout_us(BENCH_SHELL_POLL_US);
+        //  The results of a command go to the flash log once it's finished
+        if ((c >= 0) && shell_input_char(&s_shell, c))
+        {
+            result_log_flush();
+        }
+        else if (c < 0)
+        {
+            bench_monitor_poll();
+        }
+    }
+}
@@ -0,0 +1,392 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/qmi.h"
+#include "hardware/sync.h"
+#include "hardware/xip_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "PicoMemPerf.h"
+#include "run_header.h"
+#include "result_out.h"
+#include "result_log.h"
+#include "bench_checkpoint.h"
+#include "bench_shmoo.h"
+
+#define SHMOO_RESULT_CSV_HEADER "Shmoo, clock_mhz, clkdiv, rxdelay, sck_mhz, row, column, status, errors, bit_errors, error_rate, read_MBps, write_MBps\n"
+#define SHMOO_CLOCK_CSV_HEADER  "Shmoo clock, clock_mhz, points, pass, fail, hang, clkdiv, rxdelay, default_status, best_read_MBps\n"
+
+#define SHMOO_PATTERN_STEP      0x9E3779B9  //  Every word different, every bit toggling
+#define SHMOO_PATTERNS          2           //  The pattern and its inverse
+
+typedef enum
+{
+    SHMOO_UNKNOWN,                          //  Ran before a watchdog reset, see the records from then
+    SHMOO_PASS,
+    SHMOO_FAIL,
+    SHMOO_HANG,
+    SHMOO_STATUS_COUNT
+} shmoo_status;
+
+static const char * const s_shmoo_status_names[SHMOO_STATUS_COUNT] = { "unknown", "pass", "fail", "hang" };
+
+typedef struct
+{
+    uint32_t errors;                        //  Words read back wrong
+    uint32_t bit_errors;
+    uint32_t read_cycles;                   //  SHMOO_READ_PASSES over the window
+    uint32_t write_cycles;                  //  One pass
+} shmoo_result;
+
+typedef struct
+{
+    uint8_t status;
+    uint16_t read_mbps;
+} shmoo_cell;
+
+//  The clock being swept
+static shmoo_cell s_shmoo_grid[SHMOO_CLKDIV_MAX][SHMOO_RXDELAY_LAST + 1];
+static uint32_t s_shmoo_counts[SHMOO_STATUS_COUNT];
+
+void bench_shmoo_default(shmoo_config *config)
+{
+    memset(config, 0, sizeof(shmoo_config));
+    config->clock_mhz[0] = (uint8_t)((clock_get_hz(clk_sys) + 500000) / 1000000);
+    config->clocks = 1;
+    config->clkdiv_first = SHMOO_CLKDIV_FIRST;
+    config->clkdiv_last = SHMOO_CLKDIV_LAST;
+    config->rxdelay_first = SHMOO_RXDELAY_FIRST;
+    config->rxdelay_last = SHMOO_RXDELAY_LAST;
+}
+
+const char *bench_shmoo_check(const shmoo_config *config)
+{
+    uint vco, postdiv1, postdiv2;
+
+    if (_psram_size == 0)
+    {
+        return "no PSRAM";
+    }
+    if ((config->clocks == 0) || (config->clocks > SHMOO_MAX_CLOCKS))
+    {
+        return "1 to 4 clocks";
+    }
+    for (int i = 0; i < config->clocks; i++)
+    {
+        if ((config->clock_mhz[i] < SHMOO_MIN_MHZ) || (config->clock_mhz[i] > SHMOO_MAX_MHZ) ||
+            !check_sys_clock_khz(config->clock_mhz[i] * 1000, &vco, &postdiv1, &postdiv2))
+        {
+            return "clock out of range, or the PLL can't make it";
+        }
+    }
+    if ((config->clkdiv_first == 0) || (config->clkdiv_first > config->clkdiv_last) || (config->clkdiv_last > SHMOO_CLKDIV_MAX))
+    {
+        return "clkdiv range is 1 to 15";
+    }
+    if ((config->rxdelay_first > config->rxdelay_last) || (config->rxdelay_last > SHMOO_RXDELAY_LAST))
+    {
+        return "rxdelay range is 0 to 7";
+    }
+    return NULL;
+}
+
+//  Runs with interrupts off and nothing dirty in the XIP cache, so the only
+//  PSRAM accesses at the test timing are these, through the uncached window
+static void __not_in_flash_func(shmoo_point)(uint32_t timing, uint32_t safe_timing, shmoo_result *result)
+{
+    volatile uint32_t *window = (volatile uint32_t *)PSRAM_NOCACHE(s_psram_test_memory);
+    uint32_t sum = 0;
+
+    memset(result, 0, sizeof(shmoo_result));
+
+    xip_cache_clean_all();
+    uint32_t irq = save_and_disable_interrupts();
+    qmi_hw->m[1].timing = timing;
+    __dsb();
+
+    for (int pattern = 0; pattern < SHMOO_PATTERNS; pattern++)
+    {
+        uint32_t seed = (pattern == 0) ? 0 : 0xFFFFFFFF;
+
+        uint32_t start = cycle_count();
+        for (uint32_t i = 0; i < SHMOO_WORDS; i++)
+        {
+            window[i] = (i * SHMOO_PATTERN_STEP) ^ seed;
+        }
+        (void)window[0];                    //  Waits for the writes
+        if (pattern == 0)
+        {
+            result->write_cycles = cycle_count() - start;
+        }
+
+        for (uint32_t i = 0; i < SHMOO_WORDS; i++)
+        {
+            uint32_t bits = window[i] ^ (i * SHMOO_PATTERN_STEP) ^ seed;
+            if (bits != 0)
+            {
+                result->errors++;
+                for (; bits != 0; bits &= bits - 1)
+                {
+                    result->bit_errors++;
+                }
+            }
+        }
+    }
+
+    uint32_t start = cycle_count();
+    for (int pass = 0; pass < SHMOO_READ_PASSES; pass++)
+    {
+        for (uint32_t i = 0; i < SHMOO_WORDS; i += 4)
+        {
+            sum += window[i] + window[i + 1] + window[i + 2] + window[i + 3];
+        }
+    }
+    result->read_cycles = cycle_count() - start;
+
+    qmi_hw->m[1].timing = safe_timing;
+    __dsb();
+    restore_interrupts(irq);
+
+    s_value = sum;
+}
+
+//  Switch clk_sys with PSRAM left alone, and its default timing for the new clock
+static bool shmoo_set_clock(uint32_t khz, uint32_t *safe_timing)
+{
+    int clkdiv, rxdelay;
+
+    xip_cache_clean_all();
+    uint32_t irq = save_and_disable_interrupts();
+    bool set = set_sys_clock_khz(khz, false);
+    uint32_t clock_hz = clock_get_hz(clk_sys);
+    psram_timing_default(clock_hz, &clkdiv, &rxdelay);
+    *safe_timing = psram_timing(clock_hz, clkdiv, rxdelay);
+    qmi_hw->m[1].timing = *safe_timing;
+    __dsb();
+    restore_interrupts(irq);
+
+    return set;
+}
+
+static float shmoo_mbps(uint64_t bytes, uint32_t cycles, uint32_t mhz)
+{
+    //  Bytes per cycle * cycles per us
+    return (cycles != 0) ? (float)(bytes * mhz) / (float)cycles : 0.0f;
+}
+
+static void shmoo_record(uint32_t mhz, int clkdiv, int rxdelay, uint32_t row, shmoo_status status, const shmoo_result *result)
+{
+    result_record record;
+    float read_mbps = shmoo_mbps((uint64_t)SHMOO_WORDS * sizeof(uint32_t) * SHMOO_READ_PASSES, result->read_cycles, mhz);
+
+    result_begin(&record, "Shmoo");
+    result_u64(&record, "clock_mhz", mhz);
+    result_u64(&record, "clkdiv", clkdiv);
+    result_u64(&record, "rxdelay", rxdelay);
+    result_f32(&record, "sck_mhz", (float)mhz / clkdiv);
+    result_u64(&record, "row", row);
+    result_u64(&record, "column", rxdelay);
+    result_str(&record, "status", s_shmoo_status_names[status]);
+    result_u64(&record, "errors", result->errors);
+    result_u64(&record, "bit_errors", result->bit_errors);
+    result_f32(&record, "error_rate", (float)result->bit_errors / (float)(SHMOO_WORDS * 32 * SHMOO_PATTERNS));
+    result_f32(&record, "read_MBps", read_mbps);
+    result_f32(&record, "write_MBps", shmoo_mbps((uint64_t)SHMOO_WORDS * sizeof(uint32_t), result->write_cycles, mhz));
+    result_end(&record);
+
+    s_shmoo_grid[clkdiv - 1][rxdelay].status = status;
+    s_shmoo_grid[clkdiv - 1][rxdelay].read_mbps = (status == SHMOO_PASS) ? (uint16_t)read_mbps : 0;
+    s_shmoo_counts[status]++;
+}
+
+static void shmoo_clock_begin(void)
+{
+    memset(s_shmoo_grid, 0, sizeof(s_shmoo_grid));
+    memset(s_shmoo_counts, 0, sizeof(s_shmoo_counts));
+}
+
+//  Summary of one clock, and the grid in CSV: read MB/s where it passed, x failed, H hung
+static void shmoo_clock_end(const shmoo_config *config, uint32_t mhz)
+{
+    result_record record;
+    int default_clkdiv, default_rxdelay;
+    uint32_t best = 0;
+    char line[128];
+
+    psram_timing_default(mhz * 1000000, &default_clkdiv, &default_rxdelay);
+    bool in_grid = (default_clkdiv >= config->clkdiv_first) && (default_clkdiv <= config->clkdiv_last) &&
+                   (default_rxdelay >= config->rxdelay_first) && (default_rxdelay <= config->rxdelay_last);
+
+    for (int d = config->clkdiv_first; d <= config->clkdiv_last; d++)
+    {
+        for (int r = config->rxdelay_first; r <= config->rxdelay_last; r++)
+        {
+            best = (s_shmoo_grid[d - 1][r].read_mbps > best) ? s_shmoo_grid[d - 1][r].read_mbps : best;
+        }
+    }
+
+    result_csv_line(SHMOO_CLOCK_CSV_HEADER);
+    result_begin(&record, "Shmoo clock");
+    result_u64(&record, "clock_mhz", mhz);
+    result_u64(&record, "points", (config->clkdiv_last - config->clkdiv_first + 1) * (config->rxdelay_last - config->rxdelay_first + 1));
+    result_u64(&record, "pass", s_shmoo_counts[SHMOO_PASS]);
+    result_u64(&record, "fail", s_shmoo_counts[SHMOO_FAIL]);
+    result_u64(&record, "hang", s_shmoo_counts[SHMOO_HANG]);
+    result_u64(&record, "clkdiv", default_clkdiv);
+    result_u64(&record, "rxdelay", default_rxdelay);
+    result_str(&record, "default_status", in_grid ? s_shmoo_status_names[s_shmoo_grid[default_clkdiv - 1][default_rxdelay].status] : "outside");
+    result_u64(&record, "best_read_MBps", best);
+    result_end(&record);
+
+    int length = snprintf(line, sizeof(line), "Shmoo grid, %lu, rxdelay", (long unsigned int)mhz);
+    for (int r = config->rxdelay_first; r <= config->rxdelay_last; r++)
+    {
+        length += snprintf(line + length, sizeof(line) - length, ", %d", r);
+    }
+    result_csv_line("%s\n", line);
+
+    for (int d = config->clkdiv_first; d <= config->clkdiv_last; d++)
+    {
+        length = snprintf(line, sizeof(line), "Shmoo grid, %lu, clkdiv %d", (long unsigned int)mhz, d);
+        for (int r = config->rxdelay_first; r <= config->rxdelay_last; r++)
+        {
+            const shmoo_cell *cell = &s_shmoo_grid[d - 1][r];
+
+            switch (cell->status)
+            {
+                case SHMOO_PASS: length += snprintf(line + length, sizeof(line) - length, ", %d", cell->read_mbps); break;
+                case SHMOO_FAIL: length += snprintf(line + length, sizeof(line) - length, ", x"); break;
+                case SHMOO_HANG: length += snprintf(line + length, sizeof(line) - length, ", H"); break;
+                default:         length += snprintf(line + length, sizeof(line) - length, ", ?"); break;
+            }
+        }
+        result_csv_line("%s\n", line);
+    }
+}
+
+//  From first, hung is the point the watchdog stopped (or past the end)
+static void shmoo_sweep(const shmoo_config *config, uint32_t first, uint32_t hung)
+{
+    uint32_t clkdivs = config->clkdiv_last - config->clkdiv_first + 1;
+    uint32_t rxdelays = config->rxdelay_last - config->rxdelay_first + 1;
+    uint32_t per_clock = clkdivs * rxdelays;
+    uint32_t points = config->clocks * per_clock;
+    uint32_t original_khz = clock_get_hz(clk_sys) / 1000;
+    uint32_t original_timing = qmi_hw->m[1].timing;
+    uint32_t safe_timing = original_timing;
+    int clock = -1;
+
+    print_run_header();
+    checkpoint_begin(CHECKPOINT_SHMOO, config, sizeof(shmoo_config));
+
+    for (uint32_t point = first; point < points; point++)
+    {
+        int c = point / per_clock;
+        int clkdiv = config->clkdiv_first + (point / rxdelays) % clkdivs;
+        int rxdelay = config->rxdelay_first + point % rxdelays;
+        uint32_t mhz = config->clock_mhz[c];
+        shmoo_result result = { 0 };
+        shmoo_status status = SHMOO_HANG;
+
+        checkpoint_point(point, 0);
+
+        if (c != clock)
+        {
+            if (clock >= 0)
+            {
+                shmoo_clock_end(config, config->clock_mhz[clock]);
+            }
+            shmoo_clock_begin();
+            clock = c;
+            if (!shmoo_set_clock(mhz * 1000, &safe_timing))
+            {
+                printf("Error, shmoo, can't set %lu MHz\n", (long unsigned int)mhz);
+                break;
+            }
+            result_csv_line(SHMOO_RESULT_CSV_HEADER);
+        }
+
+        if (point != hung)
+        {
+            shmoo_point(psram_timing(mhz * 1000000, clkdiv, rxdelay), safe_timing, &result);
+            status = (result.errors == 0) ? SHMOO_PASS : SHMOO_FAIL;
+        }
+        shmoo_record(mhz, clkdiv, rxdelay, c * clkdivs + (clkdiv - config->clkdiv_first), status, &result);
+
+        //  A row at a time to the flash log, so a hang loses little
+        if (rxdelay == config->rxdelay_last)
+        {
+            result_log_flush();
+        }
+    }
+
+    if (clock >= 0)
+    {
+        shmoo_clock_end(config, config->clock_mhz[clock]);
+    }
+
+    checkpoint_end();
+
+    //  Back to the start up clock and timing, and nothing stale left cached
+    shmoo_set_clock(original_khz, &safe_timing);
+    qmi_hw->m[1].timing = original_timing;
+    xip_cache_clean_all();
+    xip_cache_invalidate_all();
+
+    if ((s_shmoo_counts[SHMOO_FAIL] != 0) || (s_shmoo_counts[SHMOO_HANG] != 0) || (hung < points))
+    {
+        printf("Shmoo, PSRAM may have been written at a failing point, reset before trusting its contents\n");
+    }
+}
+
+bool bench_shmoo_run(const shmoo_config *config)
+{
+    const char *error = bench_shmoo_check(config);
+
+    if (error != NULL)
+    {
+        printf("Error, shmoo, %s\n", error);
+        return false;
+    }
+
+    shmoo_sweep(config, 0, UINT32_MAX);
+    return true;
+}
+
+void bench_shmoo_resume(const void *data, uint32_t hung)
+{
+    shmoo_config config;
+
+    memcpy(&config, data, sizeof(shmoo_config));
+    uint32_t points = config.clocks * (config.clkdiv_last - config.clkdiv_first + 1) * (config.rxdelay_last - config.rxdelay_first + 1);
+    if ((bench_shmoo_check(&config) != NULL) || (hung >= points))
+    {
+        return;
+    }
+
+    shmoo_sweep(&config, hung, hung);
+}
@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  PSRAM timing shmoo
+//
+//  Sweeps the QMI M1 clock divider and RX delay at one or more system
+//  clocks, reprogramming what setup_psram() writes.  At every point a
+//  pattern is written to and read back from the start of the PSRAM test
+//  buffer through the uncached window, and the same reads and writes are
+//  timed for throughput.  Each point is a "Shmoo" record (row / column so
+//  host/result_report draws the grid), each clock a "Shmoo clock" summary
+//  and, in CSV, a text grid.
+//
+//  A point runs from SRAM with interrupts off and the XIP cache cleaned, so
+//  nothing else touches PSRAM at the wrong timing.  Every point is a
+//  checkpoint (bench_checkpoint.h): if one hangs the watchdog resets the
+//  board, bench_shmoo_resume() reports that point as a hang and carries on
+//  from the one after.
+//
+//  A failing point may write garbage anywhere in PSRAM, reset the board
+//  before trusting anything kept there.
+
+#ifndef BENCH_SHMOO_H
+#define BENCH_SHMOO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SHMOO_MAX_CLOCKS        4
+#define SHMOO_MIN_MHZ           48
+#define SHMOO_MAX_MHZ           250         //  Flash keeps its boot divider, don't push it past this
+#define SHMOO_CLKDIV_FIRST      1
+#define SHMOO_CLKDIV_LAST       6
+#define SHMOO_CLKDIV_MAX        15
+#define SHMOO_RXDELAY_FIRST     0
+#define SHMOO_RXDELAY_LAST      7           //  3 bit field
+#define SHMOO_WORDS             (4 * 1024)  //  16K of the PSRAM test buffer
+#define SHMOO_READ_PASSES       4
+
+typedef struct
+{
+    uint8_t clock_mhz[SHMOO_MAX_CLOCKS];
+    uint8_t clocks;
+    uint8_t clkdiv_first;
+    uint8_t clkdiv_last;
+    uint8_t rxdelay_first;
+    uint8_t rxdelay_last;
+} shmoo_config;
+
+//  Current clock, default divider and RX delay ranges
+void bench_shmoo_default(shmoo_config *config);
+
+//  NULL if it can be run, otherwise what's wrong
+const char *bench_shmoo_check(const shmoo_config *config);
+
+bool bench_shmoo_run(const shmoo_config *config);
+
+//  Finish a sweep the watchdog interrupted, from the checkpoint data
+void bench_shmoo_resume(const void *data, uint32_t hung);
+
+#endif
@@ -0,0 +1,151 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#include "ber_stats.h"
+
+typedef struct
+{
+    const char *name;
+    uint32_t degree;
+    uint32_t tap;                       //  x^degree + x^tap + 1
+} ber_polynomial;
+
+static const ber_polynomial s_ber_polynomials[BER_PATTERN_COUNT] =
+{
+    { "PRBS9", 9, 5 },
+    { "PRBS15", 15, 14 },
+    { "PRBS23", 23, 18 },
+    { "PRBS31", 31, 28 },
+};
+
+const char *ber_pattern_name(ber_pattern pattern)
+{
+    return (pattern < BER_PATTERN_COUNT) ? s_ber_polynomials[pattern].name : "unknown";
+}
+
+void ber_prbs_init(ber_prbs *prbs, ber_pattern pattern, uint32_t seed)
+{
+    const ber_polynomial *polynomial = &s_ber_polynomials[(pattern < BER_PATTERN_COUNT) ? pattern : BER_PRBS31];
+    uint32_t degree = polynomial->degree;
+    uint32_t taps = (1u << polynomial->tap) | 1;
+
+    prbs->mask = (1u << degree) - 1;
+    prbs->shift = degree - 8;
+    prbs->state = seed & prbs->mask;
+    prbs->state = (prbs->state != 0) ? prbs->state : 1;
+
+    //  8 steps of each top byte with the rest zero, the rest only shifts up
+    for (uint32_t b = 0; b < 256; b++)
+    {
+        uint32_t state = b << prbs->shift;
+        uint32_t out = 0;
+
+        for (int step = 0; step < 8; step++)
+        {
+            uint32_t bit = (state >> (degree - 1)) & 1;
+            out = (out << 1) | bit;
+            state = ((state << 1) & prbs->mask) ^ (bit ? taps : 0);
+        }
+        prbs->next[b] = state;
+        prbs->out[b] = (uint8_t)out;
+    }
+}
+
+void ber_counts_clear(ber_counts *counts)
+{
+    memset(counts, 0, sizeof(ber_counts));
+}
+
+void ber_counts_add(ber_counts *total, const ber_counts *counts)
+{
+    total->bits += counts->bits;
+    total->errors += counts->errors;
+    for (int bit = 0; bit < 32; bit++)
+    {
+        total->rise[bit] += counts->rise[bit];
+        total->fall[bit] += counts->fall[bit];
+    }
+}
+
+//  Abramowitz and Stegun 26.2.23
+double ber_normal_quantile(double p)
+{
+    if (p <= 0.0)
+    {
+        return -INFINITY;
+    }
+    if (p >= 1.0)
+    {
+        return INFINITY;
+    }
+
+    double q = (p < 0.5) ? p : 1.0 - p;
+    double t = sqrt(-2.0 * log(q));
+    double z = t - ((2.515517 + (0.802853 * t) + (0.010328 * t * t)) / (1.0 + (1.432788 * t) + (0.189269 * t * t) + (0.001308 * t * t * t)));
+
+    return (p < 0.5) ? -z : z;
+}
+
+//  Wilson-Hilferty, exact for 2 degrees of freedom
+double ber_chi2_quantile(double p, double dof)
+{
+    if (dof <= 0.0)
+    {
+        return 0.0;
+    }
+    if (dof == 2.0)
+    {
+        return -2.0 * log(1.0 - p);
+    }
+
+    double h = 2.0 / (9.0 * dof);
+    double cube = 1.0 - h + (ber_normal_quantile(p) * sqrt(h));
+
+    return (cube > 0.0) ? dof * cube * cube * cube : 0.0;
+}
+
+void ber_interval_per_gbit(uint64_t errors, uint64_t bits, double confidence, ber_interval *interval)
+{
+    double alpha = 1.0 - confidence;
+    double gbits = (double)bits / 1e9;
+
+    if (gbits <= 0.0)
+    {
+        interval->rate = interval->lower = interval->upper = 0.0;
+        return;
+    }
+
+    interval->rate = (double)errors / gbits;
+    interval->lower = (errors == 0) ? 0.0 : (ber_chi2_quantile(alpha / 2.0, 2.0 * (double)errors) / 2.0) / gbits;
+    interval->upper = (ber_chi2_quantile(1.0 - (alpha / 2.0), 2.0 * (double)errors + 2.0) / 2.0) / gbits;
+}
+
+double ber_bits_needed(double target_per_gbit, double confidence)
+{
+    //  No errors in n bits puts the upper bound at -ln(1 - confidence) / n
+    return (target_per_gbit > 0.0) ? (-log(1.0 - confidence) / target_per_gbit) * 1e9 : 0.0;
+}
@@ -0,0 +1,127 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Bit error rate patterns and statistics
+//
+//  PRBS9, 15, 23 and 31 (the ITU O.150 set) from a Galois LFSR, stepped a
+//  byte at a time through tables so a word costs four lookups.  Errors
+//  are counted by bit position and direction, and the rate is given in
+//  errors per Gbit with a Poisson confidence interval, exact for no errors
+//  and Wilson-Hilferty otherwise.  Portable, the host build has it too.
+
+#ifndef BER_STATS_H
+#define BER_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    BER_PRBS9,
+    BER_PRBS15,
+    BER_PRBS23,
+    BER_PRBS31,
+    BER_PATTERN_COUNT
+} ber_pattern;
+
+typedef struct
+{
+    uint32_t state;
+    uint32_t mask;                      //  (1 << degree) - 1
+    uint32_t shift;                     //  degree - 8, the top byte of the state
+    uint32_t next[256];                 //  Top byte's part of the state 8 steps on
+    uint8_t out[256];                   //  Bits it outputs on the way
+} ber_prbs;
+
+typedef struct
+{
+    uint64_t bits;
+    uint64_t errors;
+    uint32_t rise[32];                  //  Written 0, read 1, by bit
+    uint32_t fall[32];                  //  Written 1, read 0
+} ber_counts;
+
+typedef struct
+{
+    double rate;                        //  Errors per Gbit
+    double lower;
+    double upper;
+} ber_interval;
+
+//  Any seed, 0 is moved off the all zero state
+void ber_prbs_init(ber_prbs *prbs, ber_pattern pattern, uint32_t seed);
+const char *ber_pattern_name(ber_pattern pattern);
+
+//  Next 32 bits of the sequence, first bit in the top bit
+static inline uint32_t ber_prbs_word(ber_prbs *prbs)
+{
+    uint32_t state = prbs->state;
+    uint32_t word = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t top = state >> prbs->shift;
+        word = (word << 8) | prbs->out[top];
+        state = ((state << 8) & prbs->mask) ^ prbs->next[top];
+    }
+
+    prbs->state = state;
+    return word;
+}
+
+void ber_counts_clear(ber_counts *counts);
+void ber_counts_add(ber_counts *total, const ber_counts *counts);
+
+//  One word read back, bits counted by the caller
+static inline void ber_count_word(ber_counts *counts, uint32_t expected, uint32_t actual)
+{
+    uint32_t diff = expected ^ actual;
+
+    while (diff != 0)
+    {
+        int bit = __builtin_ctz(diff);
+        if (expected & (1u << bit))
+        {
+            counts->fall[bit]++;
+        }
+        else
+        {
+            counts->rise[bit]++;
+        }
+        counts->errors++;
+        diff &= diff - 1;
+    }
+}
+
+//  Two sided interval at confidence (e.g. 0.95) on a Poisson error count
+void ber_interval_per_gbit(uint64_t errors, uint64_t bits, double confidence, ber_interval *interval);
+
+//  Error free bits it takes to show the rate is under target at confidence
+double ber_bits_needed(double target_per_gbit, double confidence);
+
+//  Quantiles behind the interval, good to about 1e-3 relative
+double ber_normal_quantile(double p);
+double ber_chi2_quantile(double p, double dof);
+
+#endif
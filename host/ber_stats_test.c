@@ -0,0 +1,222 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  BER patterns and statistics
+//
+//  Each PRBS has to come back to its seed after exactly 2^n - 1 words and
+//  not before, and every table driven word has to match 32 steps of a
+//  plain bitwise Galois LFSR on the ITU polynomial.  The error counting
+//  and the Poisson interval are pinned to hand worked values.  Exits
+//  non-zero if anything is off.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "ber_stats.h"
+
+#define BITWISE_WORDS       4096
+
+static int s_failures;
+
+#define CHECK(condition, ...)                   \
+    do                                          \
+    {                                           \
+        if (!(condition))                       \
+        {                                       \
+            printf("FAIL, " __VA_ARGS__);       \
+            printf("\n");                       \
+            s_failures++;                       \
+        }                                       \
+    } while (0)
+
+#define CHECK_NEAR(value, expected, tolerance, what)                                    \
+    CHECK(fabs((value) - (expected)) <= (tolerance), "%s, %.6g, expected %.6g", what,   \
+          (double)(value), (double)(expected))
+
+typedef struct
+{
+    ber_pattern pattern;
+    uint32_t degree;
+    uint32_t tap;                       //  x^degree + x^tap + 1
+} prbs_case;
+
+static const prbs_case s_prbs_cases[] =
+{
+    { BER_PRBS9, 9, 5 },
+    { BER_PRBS15, 15, 14 },
+    { BER_PRBS23, 23, 18 },
+    { BER_PRBS31, 31, 28 },
+};
+#define PRBS_CASES  (sizeof(s_prbs_cases) / sizeof(s_prbs_cases[0]))
+
+//  Patterns
+
+static uint32_t bitwise_word(const prbs_case *test, uint32_t *state)
+{
+    uint32_t mask = (1u << test->degree) - 1;
+    uint32_t taps = (1u << test->tap) | 1;
+    uint32_t word = 0;
+
+    for (int step = 0; step < 32; step++)
+    {
+        uint32_t bit = (*state >> (test->degree - 1)) & 1;
+        word = (word << 1) | bit;
+        *state = ((*state << 1) & mask) ^ (bit ? taps : 0);
+    }
+    return word;
+}
+
+static void test_bitwise(const prbs_case *test, uint32_t seed)
+{
+    static ber_prbs prbs;
+    const char *name = ber_pattern_name(test->pattern);
+
+    ber_prbs_init(&prbs, test->pattern, seed);
+    uint32_t state = prbs.state;
+    CHECK(state != 0, "%s, seed 0x%X left the all zero state", name, seed);
+
+    for (int i = 0; i < BITWISE_WORDS; i++)
+    {
+        uint32_t expected = bitwise_word(test, &state);
+        uint32_t word = ber_prbs_word(&prbs);
+        if (word != expected)
+        {
+            CHECK(false, "%s, seed 0x%X, word %d 0x%08X, bitwise 0x%08X", name, seed, i, word, expected);
+            return;
+        }
+    }
+    CHECK(prbs.state == state, "%s, seed 0x%X, state after %d words", name, seed, BITWISE_WORDS);
+}
+
+//  Stepping 32 bits at a time still visits every state, 2^n - 1 is odd
+static void test_period(const prbs_case *test)
+{
+    static ber_prbs prbs;
+    const char *name = ber_pattern_name(test->pattern);
+    uint32_t period = (1u << test->degree) - 1;
+
+    ber_prbs_init(&prbs, test->pattern, 1);
+    uint32_t seed_state = prbs.state;
+    uint32_t first = ber_prbs_word(&prbs);
+
+    for (uint32_t words = 1; words < period; words++)
+    {
+        if (prbs.state == seed_state)
+        {
+            CHECK(false, "%s, repeats after %u words, not %u", name, words, period);
+            return;
+        }
+        ber_prbs_word(&prbs);
+    }
+    CHECK(prbs.state == seed_state, "%s, doesn't repeat after %u words", name, period);
+    CHECK(ber_prbs_word(&prbs) == first, "%s, first word differs the second time round", name);
+}
+
+static void test_patterns(void)
+{
+    static const uint32_t seeds[] = { 0, 1, 0x1A5, 0xDEADBEEF };
+
+    for (size_t i = 0; i < PRBS_CASES; i++)
+    {
+        for (size_t s = 0; s < sizeof(seeds) / sizeof(seeds[0]); s++)
+        {
+            test_bitwise(&s_prbs_cases[i], seeds[s]);
+        }
+
+        //  PRBS31 is 2^31 words, too long to go all the way round here
+        if (s_prbs_cases[i].pattern != BER_PRBS31)
+        {
+            test_period(&s_prbs_cases[i]);
+        }
+    }
+}
+
+//  Counting
+
+static void test_counts(void)
+{
+    ber_counts counts, total;
+
+    ber_counts_clear(&counts);
+    ber_count_word(&counts, 0x00000001, 0x80000000);       //  Bit 0 fell, bit 31 rose
+    ber_count_word(&counts, 0xFFFF0000, 0xFFFF0000);
+    ber_count_word(&counts, 0x0000F000, 0x00000000);       //  Bits 12..15 fell
+    counts.bits = 96;
+
+    CHECK(counts.errors == 6, "counts, %llu errors, expected 6", (unsigned long long)counts.errors);
+    CHECK((counts.fall[0] == 1) && (counts.rise[31] == 1) && (counts.rise[0] == 0), "counts, bit 0 / 31 directions");
+    CHECK((counts.fall[12] == 1) && (counts.fall[15] == 1) && (counts.rise[12] == 0), "counts, bits 12..15 directions");
+
+    ber_counts_clear(&total);
+    ber_counts_add(&total, &counts);
+    ber_counts_add(&total, &counts);
+    CHECK((total.bits == 192) && (total.errors == 12) && (total.fall[13] == 2), "counts, add");
+}
+
+//  Interval
+
+static void test_interval(void)
+{
+    ber_interval interval;
+
+    //  No errors in 1 Gbit, the upper bound is -ln(0.025)
+    ber_interval_per_gbit(0, 1000000000ull, 0.95, &interval);
+    CHECK_NEAR(interval.rate, 0.0, 1e-12, "0 errors, rate");
+    CHECK_NEAR(interval.lower, 0.0, 1e-12, "0 errors, lower");
+    CHECK_NEAR(interval.upper, 3.689, 0.001, "0 errors, upper");
+
+    //  10 errors in 1 Gbit, Wilson-Hilferty within 0.2% of the exact 4.795 / 18.390
+    ber_interval_per_gbit(10, 1000000000ull, 0.95, &interval);
+    CHECK_NEAR(interval.rate, 10.0, 1e-9, "10 errors, rate");
+    CHECK_NEAR(interval.lower, 4.79, 0.01, "10 errors, lower");
+    CHECK_NEAR(interval.upper, 18.39, 0.01, "10 errors, upper");
+
+    //  Same count over four times the bits, a quarter of the rate
+    ber_interval_per_gbit(10, 4000000000ull, 0.95, &interval);
+    CHECK_NEAR(interval.lower, 4.79 / 4.0, 0.01, "10 errors in 4 Gbit, lower");
+    CHECK_NEAR(interval.upper, 18.39 / 4.0, 0.01, "10 errors in 4 Gbit, upper");
+
+    //  Nothing read, nothing to say
+    ber_interval_per_gbit(3, 0, 0.95, &interval);
+    CHECK((interval.rate == 0.0) && (interval.lower == 0.0) && (interval.upper == 0.0), "no bits, interval not zero");
+
+    CHECK_NEAR(ber_bits_needed(1.0, 0.95) / 1e9, 2.996, 0.001, "bits needed for 1/Gbit at 95%");
+    CHECK(ber_bits_needed(0.0, 0.95) == 0.0, "bits needed for a zero target");
+
+    CHECK_NEAR(ber_normal_quantile(0.975), 1.960, 0.001, "normal quantile 0.975");
+    CHECK_NEAR(ber_normal_quantile(0.025), -1.960, 0.001, "normal quantile 0.025");
+    CHECK_NEAR(ber_chi2_quantile(0.95, 2.0), 5.991, 0.001, "chi2 0.95, 2 dof");
+    CHECK_NEAR(ber_chi2_quantile(0.975, 22.0), 36.781, 0.04, "chi2 0.975, 22 dof");
+}
+
+int main(void)
+{
+    test_patterns();
+    test_counts();
+    test_interval();
+
+    printf("ber_stats_test, %s, failures, %d\n", (s_failures == 0) ? "pass" : "fail", s_failures);
+    return (s_failures == 0) ? 0 : 1;
+}
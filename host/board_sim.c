@@ -0,0 +1,306 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Pretend board on a pseudo terminal, for trying serial_driver without one
+//
+//  Runs the shell with the plan and format commands over the host build of
+//  the kernels, on a pty linked to --link so it can be opened like the
+//  board's USB serial port.  --drop-after=N pulls the cable after N result
+//  writes on the first boot: the pty goes away, a new one is linked in its
+//  place and the "board" starts again from scratch, the way a reset looks
+//  from the host.
+//
+//      board_sim [--link=/tmp/picomemperf-sim] [--drop-after=n] [--psram=bytes]
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "bench_shell.h"
+#include "plan_file.h"
+#include "result_out.h"
+#include "shell.h"
+#include "test_plan.h"
+
+#define SIM_LINK        "/tmp/picomemperf-sim"
+
+static const char *s_link = SIM_LINK;
+static int s_master = -1;
+static int s_slave = -1;                //  Held open so the pty stays up between connections
+static long s_drop_after = -1;
+static long s_writes = 0;
+static bool s_dropped = false;
+static plan_limits s_limits = { PLAN_HOST_BUFFER_WORDS, PLAN_HOST_PSRAM_BYTES };
+static test_plan s_plan;
+
+static bool sim_plug(void)
+{
+    struct termios tio;
+
+    s_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((s_master < 0) || (grantpt(s_master) != 0) || (unlockpt(s_master) != 0))
+    {
+        return false;
+    }
+
+    const char *name = ptsname(s_master);
+    s_slave = open(name, O_RDWR | O_NOCTTY);
+    if ((s_slave < 0) || (tcgetattr(s_slave, &tio) != 0))
+    {
+        return false;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(s_slave, TCSANOW, &tio);
+
+    //  printf goes down the "USB" port, logging to stderr
+    fflush(stdout);
+    dup2(s_master, STDOUT_FILENO);
+    clearerr(stdout);
+
+    unlink(s_link);
+    if (symlink(name, s_link) != 0)
+    {
+        fprintf(stderr, "%s: can't link\n", s_link);
+        return false;
+    }
+    fprintf(stderr, "%s -> %s\n", s_link, name);
+    return true;
+}
+
+static void sim_unplug(void)
+{
+    int null = open("/dev/null", O_WRONLY);
+
+    //  Whatever is still being printed goes nowhere, like a dead cable
+    fflush(stdout);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    close(s_master);
+    close(s_slave);
+    s_master = s_slave = -1;
+    unlink(s_link);
+    fprintf(stderr, "unplugged\n");
+}
+
+static void sim_write(const void *data, size_t length)
+{
+    if (s_dropped)
+    {
+        return;
+    }
+    fwrite(data, 1, length, stdout);
+
+    if (++s_writes == s_drop_after)
+    {
+        s_dropped = true;
+        sim_unplug();
+    }
+}
+
+static int cmd_help(shell *sh, int argc, char **argv)
+{
+    shell_help(sh);
+    return SHELL_OK;
+}
+
+static int cmd_format(shell *sh, int argc, char **argv)
+{
+    int format;
+
+    if (argc == 1)
+    {
+        printf("Format, %s\n", result_format_name(result_get_format()));
+        return SHELL_OK;
+    }
+    if ((argc != 2) || ((format = result_format_match(argv[1])) < 0))
+    {
+        return SHELL_USAGE;
+    }
+
+    result_set_format((result_format)format);
+    return SHELL_OK;
+}
+
+//  Same as the firmware's plan load
+static int plan_load_line(shell *sh, char *line)
+{
+    static int s_line_number = 0;
+    int result = test_plan_parse_line(&s_plan, line, ++s_line_number);
+
+    if (result == PLAN_OK)
+    {
+        return SHELL_OK;
+    }
+
+    s_line_number = 0;
+    shell_capture(sh, NULL);
+
+    if ((result == PLAN_ERROR) || !test_plan_validate(&s_plan, &s_limits))
+    {
+        printf("Plan error, %d, %s\n", s_plan.error_line, s_plan.error);
+        test_plan_init(&s_plan);
+        return SHELL_ERROR;
+    }
+
+    printf("Plan loaded, %s, %d\n", s_plan.name, s_plan.count);
+    return SHELL_OK;
+}
+
+static int cmd_plan(shell *sh, int argc, char **argv)
+{
+    static const char * const names[] = { "show", "load", "run" };
+    int action = (argc == 1) ? 0 : (argc == 2) ? shell_match(argv[1], names, sizeof(names) / sizeof(names[0])) : -1;
+
+    if (((action == 0) || (action == 2)) && !s_plan.complete)
+    {
+        printf("Error, no plan loaded\n");
+        return SHELL_ERROR;
+    }
+
+    switch (action)
+    {
+        case 0:
+        {
+            size_t length = test_plan_format(&s_plan, NULL, 0);
+            char *text = malloc(length + 1);
+            if (text == NULL)
+            {
+                return SHELL_ERROR;
+            }
+            test_plan_format(&s_plan, text, length + 1);
+            printf("%s", text);
+            free(text);
+            break;
+        }
+        case 1:
+            test_plan_init(&s_plan);
+            shell_capture(sh, plan_load_line);
+            break;
+        case 2:
+            //  The run header resends the schemas on the board, do the same here
+            result_reset_schemas();
+            if (!plan_file_run(&s_plan, &s_limits))
+            {
+                printf("Error, out of memory\n");
+                return SHELL_ERROR;
+            }
+            break;
+        default:
+            return SHELL_USAGE;
+    }
+
+    return SHELL_OK;
+}
+
+static const shell_command s_sim_commands[] =
+{
+    { "help", "", "This list", cmd_help },
+    { "plan", "[show|load|run]", "Test plans, load reads lines up to end", cmd_plan },
+    { "format", "[csv|json|binary]", "Result record format", cmd_format },
+};
+
+//  Power on, returns when the cable is pulled
+static void sim_boot(shell *sh)
+{
+    uint8_t buffer[256];
+
+    s_dropped = false;
+    test_plan_init(&s_plan);
+    result_set_format(RESULT_FORMAT_CSV);
+    shell_init(sh, s_sim_commands, sizeof(s_sim_commands) / sizeof(s_sim_commands[0]), BENCH_SHELL_PROMPT, true);
+
+    printf("PicoMemPerf host simulator\n");
+    shell_prompt(sh);
+
+    while (!s_dropped)
+    {
+        struct pollfd pfd = { s_master, POLLIN, 0 };
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        ssize_t length = read(s_master, buffer, sizeof(buffer));
+        if ((length < 0) && (errno != EAGAIN) && (errno != EINTR) && (errno != EIO))
+        {
+            return;
+        }
+        for (ssize_t i = 0; (i < length) && !s_dropped; i++)
+        {
+            shell_input_char(sh, buffer[i]);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static shell s_shell;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--link=", 7) == 0)
+        {
+            s_link = argv[i] + 7;
+        }
+        else if (strncmp(argv[i], "--drop-after=", 13) == 0)
+        {
+            s_drop_after = atol(argv[i] + 13);
+        }
+        else if (!plan_file_limits_arg(argv[i], &s_limits))
+        {
+            fprintf(stderr, "usage: board_sim [--link=path] [--drop-after=n] [--psram=bytes]\n");
+            return 2;
+        }
+    }
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    result_set_writer(sim_write);
+
+    while (true)
+    {
+        if (!sim_plug())
+        {
+            fprintf(stderr, "can't make a pty\n");
+            return 1;
+        }
+
+        sim_boot(&s_shell);
+
+        if (!s_dropped)
+        {
+            sim_unplug();
+        }
+
+        //  Only the first boot drops
+        s_drop_after = -1;
+        usleep(200 * 1000);
+    }
+}
@@ -0,0 +1,315 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Pool, arena and tiered allocator over simulated regions
+//
+//  The pool and arena run over a buffer that starts off a page boundary,
+//  like a block from the PSRAM heap, and are checked for line alignment,
+//  page breaks, overlap and capacity.  The tiered allocator gets a backend
+//  with a small SRAM heap and a PSRAM heap mapped twice, the second mapping
+//  standing in for the uncached window, to check placement, fallback,
+//  the SRAM budget and the accounting.  Exits non-zero at the first failure.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "tlsf.h"
+#include "mem_pool.h"
+#include "mem_tier.h"
+
+#define SIM_REGION_SIZE     (64 * 1024)
+#define SIM_REGION_SKEW     40                  //  Region start past a page boundary, on a line
+#define SIM_SRAM_SIZE       (16 * 1024)
+#define SIM_PSRAM_SIZE      (256 * 1024)
+
+static int s_failures;
+
+#define CHECK(condition, ...)                   \
+    do                                          \
+    {                                           \
+        if (!(condition))                       \
+        {                                       \
+            printf("FAIL, " __VA_ARGS__);       \
+            printf("\n");                       \
+            s_failures++;                       \
+        }                                       \
+    } while (0)
+
+static bool crosses_page(const void *ptr, size_t size)
+{
+    uintptr_t address = (uintptr_t)ptr;
+    return (address / MEM_PAGE_SIZE) != ((address + size - 1) / MEM_PAGE_SIZE);
+}
+
+//  Pool
+
+static void test_pool(uint8_t *region, size_t object_size)
+{
+    static void *objects[SIM_REGION_SIZE / MEM_LINE_SIZE];
+    mem_pool pool;
+
+    CHECK(mem_pool_init(&pool, region, SIM_REGION_SIZE, object_size), "pool %zu, init", object_size);
+    CHECK(((uintptr_t)pool.base % MEM_PAGE_SIZE) == 0, "pool %zu, base not on a page", object_size);
+
+    uint32_t count = 0;
+    void *ptr;
+    while ((ptr = mem_pool_alloc(&pool)) != NULL)
+    {
+        CHECK(((uintptr_t)ptr % MEM_LINE_SIZE) == 0, "pool %zu, object %u off a line", object_size, count);
+        CHECK((object_size > MEM_PAGE_SIZE) || !crosses_page(ptr, object_size), "pool %zu, object %u crosses a page", object_size, count);
+        CHECK(((uint8_t *)ptr >= region) && ((uint8_t *)ptr + object_size <= region + SIM_REGION_SIZE), "pool %zu, object %u outside the region", object_size, count);
+        CHECK(mem_pool_owns(&pool, ptr), "pool %zu, doesn't own object %u", object_size, count);
+        CHECK((count == 0) || ((uint8_t *)ptr >= (uint8_t *)objects[count - 1] + object_size), "pool %zu, object %u overlaps", object_size, count);
+        objects[count++] = ptr;
+    }
+    CHECK(count == pool.capacity, "pool %zu, %u handed out, capacity %u", object_size, count, pool.capacity);
+    CHECK((count != 0) && !mem_pool_owns(&pool, (uint8_t *)objects[0] + 1), "pool %zu, owns a misaligned pointer", object_size);
+
+    //  Freed objects come back before the pool is exhausted again
+    mem_pool_free(&pool, objects[3]);
+    mem_pool_free(&pool, objects[1]);
+    CHECK(pool.used == count - 2, "pool %zu, used after free", object_size);
+    CHECK(mem_pool_alloc(&pool) == objects[1], "pool %zu, free list order", object_size);
+    CHECK(mem_pool_alloc(&pool) == objects[3], "pool %zu, free list order", object_size);
+    CHECK(mem_pool_alloc(&pool) == NULL, "pool %zu, more than capacity", object_size);
+
+    mem_pool_reset(&pool);
+    CHECK((pool.used == 0) && (mem_pool_alloc(&pool) == objects[0]), "pool %zu, reset", object_size);
+}
+
+//  Arena
+
+static void test_arena(uint8_t *region)
+{
+    mem_arena arena;
+    uint8_t *last_end = region;
+    size_t total = 0;
+
+    mem_arena_init(&arena, region, SIM_REGION_SIZE);
+
+    for (uint32_t i = 0; ; i++)
+    {
+        size_t size = 1 + ((i * 97) % 700);
+        size_t align = ((i % 5) == 0) ? 64 : MEM_LINE_SIZE;
+        uint8_t *ptr = mem_arena_alloc_aligned(&arena, size, align);
+        if (ptr == NULL)
+        {
+            CHECK(mem_arena_remaining(&arena) < 2 * MEM_PAGE_SIZE, "arena, gave up with %zu left", mem_arena_remaining(&arena));
+            break;
+        }
+
+        CHECK(((uintptr_t)ptr % align) == 0, "arena, allocation %u not aligned to %zu", i, align);
+        CHECK(!crosses_page(ptr, size), "arena, allocation %u crosses a page", i);
+        CHECK(ptr >= last_end, "arena, allocation %u overlaps", i);
+        CHECK(ptr + size <= region + SIM_REGION_SIZE, "arena, allocation %u past the end", i);
+        last_end = ptr + size;
+        total += (size + MEM_LINE_SIZE - 1) & ~(size_t)(MEM_LINE_SIZE - 1);
+    }
+
+    CHECK(mem_arena_used(&arena) == total + arena.wasted, "arena, used %zu != allocated %zu + wasted %zu", mem_arena_used(&arena), total, arena.wasted);
+    CHECK(mem_arena_alloc(&arena, SIM_REGION_SIZE) == NULL, "arena, oversize allocation");
+
+    mem_arena_reset(&arena);
+    CHECK((arena.wasted == 0) && (mem_arena_remaining(&arena) >= SIM_REGION_SIZE - MEM_LINE_SIZE), "arena, reset");
+}
+
+//  Tiered allocator
+
+typedef struct
+{
+    tlsf_heap sram;
+    tlsf_heap psram;
+    uint8_t *sram_base;
+    uint8_t *psram_base;
+    uint8_t *nocache_base;                  //  Same memory as psram_base
+} sim_tiers;
+
+static void *sim_malloc(void *context, mem_tier tier, size_t size)
+{
+    sim_tiers *sim = (sim_tiers *)context;
+    void *ptr;
+
+    switch (tier)
+    {
+        case MEM_TIER_SRAM:             return tlsf_malloc(&sim->sram, size);
+        case MEM_TIER_PSRAM:            return tlsf_malloc(&sim->psram, size);
+        case MEM_TIER_PSRAM_NOCACHE:
+            ptr = tlsf_malloc(&sim->psram, size);
+            return (ptr != NULL) ? sim->nocache_base + ((uint8_t *)ptr - sim->psram_base) : NULL;
+        default:                        return NULL;
+    }
+}
+
+static void *sim_cached(sim_tiers *sim, mem_tier tier, void *ptr)
+{
+    return (tier == MEM_TIER_PSRAM_NOCACHE) ? sim->psram_base + ((uint8_t *)ptr - sim->nocache_base) : ptr;
+}
+
+static void sim_free(void *context, mem_tier tier, void *ptr)
+{
+    sim_tiers *sim = (sim_tiers *)context;
+    tlsf_free((tier == MEM_TIER_SRAM) ? &sim->sram : &sim->psram, sim_cached(sim, tier, ptr));
+}
+
+static size_t sim_block_size(void *context, mem_tier tier, void *ptr)
+{
+    return tlsf_block_size(sim_cached((sim_tiers *)context, tier, ptr));
+}
+
+static mem_tier sim_tier_of(void *context, const void *ptr)
+{
+    sim_tiers *sim = (sim_tiers *)context;
+    const uint8_t *address = (const uint8_t *)ptr;
+
+    if ((address >= sim->sram_base) && (address < sim->sram_base + SIM_SRAM_SIZE))
+    {
+        return MEM_TIER_SRAM;
+    }
+    if ((address >= sim->psram_base) && (address < sim->psram_base + SIM_PSRAM_SIZE))
+    {
+        return MEM_TIER_PSRAM;
+    }
+    if ((address >= sim->nocache_base) && (address < sim->nocache_base + SIM_PSRAM_SIZE))
+    {
+        return MEM_TIER_PSRAM_NOCACHE;
+    }
+    return MEM_TIER_NONE;
+}
+
+static void test_tier(void)
+{
+    static uint8_t sram[SIM_SRAM_SIZE];
+    static sim_tiers sim;
+    mem_tier_backend backend = { sim_malloc, sim_free, sim_block_size, sim_tier_of, &sim };
+    mem_tier_stats stats;
+    void *hot[64];
+
+    //  One PSRAM mapped twice, writes through either show in the other
+    int fd = memfd_create("psram", 0);
+    if ((fd < 0) || (ftruncate(fd, SIM_PSRAM_SIZE) != 0))
+    {
+        CHECK(false, "tier, no memfd for the simulated PSRAM");
+        return;
+    }
+    sim.psram_base = mmap(NULL, SIM_PSRAM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    sim.nocache_base = mmap(NULL, SIM_PSRAM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if ((sim.psram_base == MAP_FAILED) || (sim.nocache_base == MAP_FAILED))
+    {
+        CHECK(false, "tier, can't map the simulated PSRAM");
+        return;
+    }
+    sim.sram_base = sram;
+    tlsf_create(&sim.sram, sram, sizeof(sram));
+    tlsf_create(&sim.psram, sim.psram_base, SIM_PSRAM_SIZE);
+
+    mem_tier_set_backend(&backend);
+    mem_tier_set_policy(NULL);
+    mem_tier_reset_stats();
+
+    //  Placement by hint
+    void *latency = mem_tier_malloc(256, MEM_HINT_LATENCY);
+    uint8_t *cold = mem_tier_malloc(256, MEM_HINT_COLD);
+    CHECK(mem_tier_of(latency) == MEM_TIER_SRAM, "tier, latency hint in %s", mem_tier_name(mem_tier_of(latency)));
+    CHECK(mem_tier_of(cold) == MEM_TIER_PSRAM_NOCACHE, "tier, cold hint in %s", mem_tier_name(mem_tier_of(cold)));
+
+    memset(cold, 0x5A, 256);
+    CHECK(*(uint8_t *)sim_cached(&sim, MEM_TIER_PSRAM_NOCACHE, cold) == 0x5A, "tier, uncached alias isn't the same memory");
+
+    //  Hot allocations fill the SRAM and fall back to cached PSRAM
+    int count = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        hot[count++] = mem_tier_malloc(1024, MEM_HINT_HOT);
+    }
+    mem_tier_get_stats(&stats);
+    CHECK(mem_tier_of(hot[0]) == MEM_TIER_SRAM, "tier, first hot allocation not in SRAM");
+    CHECK(mem_tier_of(hot[63]) == MEM_TIER_PSRAM, "tier, hot allocation past the SRAM not in PSRAM");
+    CHECK((stats.fallbacks != 0) && (stats.failures == 0), "tier, %u fallbacks, %u failures", stats.fallbacks, stats.failures);
+    CHECK(stats.allocs[MEM_TIER_SRAM] + stats.allocs[MEM_TIER_PSRAM] + stats.allocs[MEM_TIER_PSRAM_NOCACHE] == 66, "tier, allocation count");
+    CHECK(stats.bytes[MEM_TIER_SRAM] <= SIM_SRAM_SIZE, "tier, %u SRAM bytes", stats.bytes[MEM_TIER_SRAM]);
+
+    //  Everything back leaves no live bytes
+    for (int i = 0; i < count; i++)
+    {
+        mem_tier_free(hot[i]);
+    }
+    mem_tier_free(latency);
+    mem_tier_free(cold);
+    mem_tier_free(NULL);
+    mem_tier_get_stats(&stats);
+    for (int tier = 0; tier < MEM_TIER_COUNT; tier++)
+    {
+        CHECK(stats.bytes[tier] == 0, "tier, %u bytes left in %s", stats.bytes[tier], mem_tier_name((mem_tier)tier));
+    }
+    CHECK(tlsf_check(&sim.sram) && tlsf_check(&sim.psram), "tier, heaps damaged");
+
+    //  SRAM budget and a policy with nowhere else to go
+    static const mem_tier_policy sram_only =
+    {
+        "SRAM ONLY",
+        {
+            [MEM_HINT_HOT]       = { MEM_TIER_SRAM, MEM_TIER_NONE, MEM_TIER_NONE },
+            [MEM_HINT_LATENCY]   = { MEM_TIER_SRAM, MEM_TIER_NONE, MEM_TIER_NONE },
+            [MEM_HINT_COLD]      = { MEM_TIER_SRAM, MEM_TIER_NONE, MEM_TIER_NONE },
+            [MEM_HINT_STREAMING] = { MEM_TIER_SRAM, MEM_TIER_NONE, MEM_TIER_NONE },
+        },
+        4096
+    };
+    mem_tier_set_policy(&sram_only);
+    mem_tier_reset_stats();
+    void *a = mem_tier_malloc(3000, MEM_HINT_COLD);
+    void *b = mem_tier_malloc(3000, MEM_HINT_COLD);
+    mem_tier_get_stats(&stats);
+    CHECK((a != NULL) && (b == NULL) && (stats.failures == 1), "tier, SRAM budget not kept");
+    mem_tier_free(a);
+
+    mem_tier_set_policy(NULL);
+    mem_tier_set_backend(NULL);
+    CHECK(mem_tier_malloc(16, MEM_HINT_HOT) == NULL, "tier, allocated with no backend");
+
+    munmap(sim.psram_base, SIM_PSRAM_SIZE);
+    munmap(sim.nocache_base, SIM_PSRAM_SIZE);
+}
+
+int main(void)
+{
+    static uint8_t region[SIM_REGION_SIZE + SIM_REGION_SKEW] __attribute__((aligned(MEM_PAGE_SIZE)));
+    static const size_t object_sizes[] = { 1, 8, 12, 24, 100, 340, 1024, 1500 };
+    uint8_t *skewed = region + SIM_REGION_SKEW;
+
+    for (int i = 0; i < (int)(sizeof(object_sizes) / sizeof(object_sizes[0])); i++)
+    {
+        test_pool(skewed, object_sizes[i]);
+    }
+    test_arena(skewed);
+    test_tier();
+
+    printf("mem_region_test, %s, failures, %d\n", (s_failures == 0) ? "pass" : "fail", s_failures);
+    return (s_failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Host simulation of the page cache over a slow backing store
+//
+//  Runs the SEQ / RND read / write kernels through page_cache with a backend
+//  that charges a modelled PSRAM transfer cost per page, so page size,
+//  associativity and replacement can be explored without a board.
+//
+//      page_cache_sim [page_size sets ways lru|clock] [setup_ns ns_per_byte]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "page_cache.h"
+
+#define SIM_BUFFER_SIZE     (16 * 1024)         //  Words, same as TEST_SIZE
+#define SIM_LOOP_COUNT      100
+
+typedef struct
+{
+    uint8_t *store;
+    uint32_t setup_ns;                          //  Per transfer, command + address + dummy cycles
+    uint32_t ns_per_byte;
+    uint64_t modelled_ns;
+    uint64_t bytes;
+} sim_store;
+
+static void sim_fill(void *context, void *dst, uint32_t offset, uint32_t size)
+{
+    sim_store *store = (sim_store *)context;
+    memcpy(dst, store->store + offset, size);
+    store->modelled_ns += store->setup_ns + ((uint64_t)store->ns_per_byte * size);
+    store->bytes += size;
+}
+
+static void sim_write_back(void *context, uint32_t offset, const void *src, uint32_t size)
+{
+    sim_store *store = (sim_store *)context;
+    memcpy(store->store + offset, src, size);
+    store->modelled_ns += store->setup_ns + ((uint64_t)store->ns_per_byte * size);
+    store->bytes += size;
+}
+
+static uint32_t sim_kernel(page_cache *cache, bool read, bool rnd)
+{
+    uint32_t seed_value = 0xDEADBEEF;
+    uint32_t value = 0;
+
+    for (int loop = 0; loop < SIM_LOOP_COUNT; loop++)
+    {
+        for (uint32_t i = 0; i < SIM_BUFFER_SIZE; i++)
+        {
+            uint32_t index = i;
+            if (rnd)
+            {
+                seed_value = (seed_value * 1103515245U + 12345U);
+                index = seed_value & (SIM_BUFFER_SIZE - 1);
+            }
+
+            if (read)
+            {
+                value += page_cache_read32(cache, index * sizeof(uint32_t));
+            }
+            else
+            {
+                page_cache_write32(cache, index * sizeof(uint32_t), value++);
+            }
+        }
+    }
+
+    page_cache_flush(cache);
+
+    return value;
+}
+
+static void sim_config(const page_cache_config *config, sim_store *store)
+{
+    static const struct { bool read; bool rnd; const char *name; } kernels[] =
+    {
+        { true, false, "SEQ READ" },
+        { true, true, "RND READ" },
+        { false, false, "SEQ WRITE" },
+        { false, true, "RND WRITE" },
+    };
+
+    size_t workspace_size = page_cache_workspace_size(config);
+    void *workspace = malloc((workspace_size + 7) & ~(size_t)7);
+    page_cache_backend backend = { sim_fill, sim_write_back, store };
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        page_cache cache;
+        if ((workspace == NULL) || !page_cache_init(&cache, config, workspace, workspace_size, &backend))
+        {
+            printf("Bad config, page %u sets %u ways %u\n", config->page_size, config->sets, config->ways);
+            break;
+        }
+
+        store->modelled_ns = 0;
+        store->bytes = 0;
+        sim_kernel(&cache, kernels[k].read, kernels[k].rnd);
+
+        printf("Page cache sim, %s, page, %u, sets, %u, ways, %u, %s, lookups, %u, misses, %u, write_backs, %u, backing_bytes, %llu, modelled_us, %llu\n",
+               kernels[k].name, config->page_size, config->sets, config->ways, (config->policy == PAGE_CACHE_CLOCK) ? "CLOCK" : "LRU",
+               cache.stats.lookups, cache.stats.misses, cache.stats.write_backs,
+               (unsigned long long)store->bytes, (unsigned long long)(store->modelled_ns / 1000));
+    }
+
+    free(workspace);
+}
+
+int main(int argc, char **argv)
+{
+    //  Same 32K cache configurations as run_page_cache_bench()
+    page_cache_config configs[] =
+    {
+        { 256, 32, 4, PAGE_CACHE_LRU },
+        { 1024, 8, 4, PAGE_CACHE_LRU },
+        { 4096, 2, 4, PAGE_CACHE_LRU },
+        { 1024, 8, 4, PAGE_CACHE_CLOCK },
+        { 1024, 32, 1, PAGE_CACHE_LRU },
+    };
+    size_t config_count = sizeof(configs) / sizeof(configs[0]);
+
+    sim_store store = { NULL, 1000, 40, 0, 0 };
+    store.store = calloc(SIM_BUFFER_SIZE, sizeof(uint32_t));
+    if (store.store == NULL)
+    {
+        return 1;
+    }
+
+    if (argc >= 5)
+    {
+        configs[0].page_size = (uint32_t)strtoul(argv[1], NULL, 0);
+        configs[0].sets = (uint32_t)strtoul(argv[2], NULL, 0);
+        configs[0].ways = (uint32_t)strtoul(argv[3], NULL, 0);
+        configs[0].policy = (strcmp(argv[4], "clock") == 0) ? PAGE_CACHE_CLOCK : PAGE_CACHE_LRU;
+        config_count = 1;
+    }
+    if (argc >= 7)
+    {
+        store.setup_ns = (uint32_t)strtoul(argv[5], NULL, 0);
+        store.ns_per_byte = (uint32_t)strtoul(argv[6], NULL, 0);
+    }
+
+    for (size_t i = 0; i < config_count; i++)
+    {
+        sim_config(&configs[i], &store);
+    }
+
+    free(store.store);
+
+    return 0;
+}
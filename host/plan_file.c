@@ -0,0 +1,143 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shell.h"
+#include "mem_kernels.h"
+#include "result_out.h"
+#include "plan_file.h"
+
+bool plan_file_load(const char *path, test_plan *plan, const plan_limits *limits)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: can't open\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = malloc((length > 0) ? length : 1);
+    bool ok = (text != NULL) && (fread(text, 1, length, file) == (size_t)length);
+    fclose(file);
+
+    if (ok && !test_plan_parse(plan, text, length, limits))
+    {
+        if (plan->error_line != 0)
+        {
+            fprintf(stderr, "%s:%d: %s\n", path, plan->error_line, plan->error);
+        }
+        else
+        {
+            fprintf(stderr, "%s: %s\n", path, plan->error);
+        }
+        ok = false;
+    }
+
+    free(text);
+    return ok;
+}
+
+bool plan_file_limits_arg(const char *arg, plan_limits *limits)
+{
+    if (strncmp(arg, "--psram=", 8) != 0)
+    {
+        return false;
+    }
+    if (!shell_parse_uint(arg + 8, &limits->psram_bytes))
+    {
+        fprintf(stderr, "bad %s\n", arg);
+        exit(2);
+    }
+    return true;
+}
+
+static void run_entry(const test_plan *plan, const plan_entry *entry, uint32_t *regions[PLAN_REGION_COUNT])
+{
+    uint32_t size = entry->size_first;
+
+    do
+    {
+        uint32_t *window = (uint32_t *)((uint8_t *)regions[entry->region] + entry->offset);
+        int loop_scale = (int)entry->loop_scale;
+
+        if (entry->kernel == PLAN_KERNEL_TABLE)
+        {
+            if (!index_table_init(size))
+            {
+                printf("Plan skipped, %s, %s, %lu, no memory for the index table\n", plan->name, entry->name, (long unsigned int)size);
+                continue;
+            }
+        }
+        else
+        {
+            index_table_free();
+        }
+
+        for (uint32_t rep = 0; rep < entry->repetitions; rep++)
+        {
+            uint64_t overhead = calibrate_overhead(size, loop_scale, entry->read, entry->random);
+            uint64_t result = memory_test(window, size, loop_scale, entry->read, entry->random);
+            uint64_t corrected = (result > overhead) ? (result - overhead) : 0;
+
+            plan_result(plan, entry, size, rep, (uint32_t)(uintptr_t)window, result, overhead, corrected);
+        }
+
+        index_table_free();
+    }
+    while (test_plan_next_size(entry, &size));
+}
+
+bool plan_file_run(const test_plan *plan, const plan_limits *limits)
+{
+    //  SRAM / ROM are test buffer sized, PSRAM reads can cover the whole device
+    size_t buffer_bytes = limits->buffer_words * sizeof(uint32_t);
+    uint32_t *sram = calloc(1, buffer_bytes);
+    uint32_t *rom = calloc(1, buffer_bytes);
+    uint32_t *psram = calloc(1, (limits->psram_bytes > buffer_bytes) ? limits->psram_bytes : buffer_bytes);
+    bool ok = (sram != NULL) && (rom != NULL) && (psram != NULL);
+
+    if (ok)
+    {
+        uint32_t *regions[PLAN_REGION_COUNT] = { sram, rom, psram, psram };
+
+        result_csv_line(PLAN_RESULT_CSV_HEADER);
+        for (int i = 0; i < plan->count; i++)
+        {
+            run_entry(plan, &plan->entries[i], regions);
+        }
+    }
+
+    free(sram);
+    free(rom);
+    free(psram);
+
+    return ok;
+}
@@ -0,0 +1,45 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Plan file loading and running shared by the host plan tools
+
+#ifndef PLAN_FILE_H
+#define PLAN_FILE_H
+
+#include "test_plan.h"
+
+//  Same as the firmware, TEST_SIZE words and an 8MB PSRAM unless --psram= says otherwise
+#define PLAN_HOST_BUFFER_WORDS  (16 * 1024)
+#define PLAN_HOST_PSRAM_BYTES   (8 * 1024 * 1024)
+
+//  Read and parse path, prints "path:line: error" on failure
+bool plan_file_load(const char *path, test_plan *plan, const plan_limits *limits);
+
+//  --psram=<bytes> (K / M suffix allowed), true if arg was one
+bool plan_file_limits_arg(const char *arg, plan_limits *limits);
+
+//  Run every entry with host memory for the regions, false if that can't be allocated
+bool plan_file_run(const test_plan *plan, const plan_limits *limits);
+
+#endif
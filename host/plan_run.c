@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Runs a test plan on the host with the same kernels as the firmware, for
+//  trying plans out and as a baseline.  Every region is ordinary host memory.
+//
+//      plan_run [--psram=bytes] [--format=csv|json|binary] plan
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_out.h"
+#include "test_plan.h"
+#include "plan_file.h"
+
+int main(int argc, char **argv)
+{
+    static test_plan plan;
+    plan_limits limits = { PLAN_HOST_BUFFER_WORDS, PLAN_HOST_PSRAM_BYTES };
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--format=", 9) == 0)
+        {
+            int format = result_format_match(argv[i] + 9);
+            if (format < 0)
+            {
+                fprintf(stderr, "bad %s\n", argv[i]);
+                return 2;
+            }
+            result_set_format((result_format)format);
+        }
+        else if (!plan_file_limits_arg(argv[i], &limits))
+        {
+            path = argv[i];
+        }
+    }
+
+    if (path == NULL)
+    {
+        fprintf(stderr, "usage: plan_run [--psram=bytes] [--format=csv|json|binary] plan\n");
+        return 2;
+    }
+    if (!plan_file_load(path, &plan, &limits))
+    {
+        return 1;
+    }
+
+    if (!plan_file_run(&plan, &limits))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Checks test plans before they go to a board, with the same rules the
+//  firmware applies when it loads them
+//
+//      plan_validate [--psram=bytes] plan...
+
+#include <stdio.h>
+
+#include "test_plan.h"
+#include "plan_file.h"
+
+int main(int argc, char **argv)
+{
+    static test_plan plan;
+    plan_limits limits = { PLAN_HOST_BUFFER_WORDS, PLAN_HOST_PSRAM_BYTES };
+    int failed = 0;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (plan_file_limits_arg(argv[i], &limits))
+        {
+            continue;
+        }
+
+        files++;
+        if (!plan_file_load(argv[i], &plan, &limits))
+        {
+            failed++;
+            continue;
+        }
+
+        //  Timed runs, so a sweep that's bigger than expected shows up
+        uint32_t runs = 0;
+        for (int e = 0; e < plan.count; e++)
+        {
+            uint32_t size = plan.entries[e].size_first;
+            do
+            {
+                runs += plan.entries[e].repetitions;
+            }
+            while (test_plan_next_size(&plan.entries[e], &size));
+        }
+
+        printf("%s: OK, %s, %d tests, %lu runs\n", argv[i], plan.name, plan.count, (long unsigned int)runs);
+    }
+
+    if (files == 0)
+    {
+        fprintf(stderr, "usage: plan_validate [--psram=bytes] plan...\n");
+        return 2;
+    }
+
+    return (failed == 0) ? 0 : 1;
+}
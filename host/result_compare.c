@@ -0,0 +1,258 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Compares two sets of results and fails on a slow down
+//
+//  Each test and sweep point (record type, test, size) in the baseline is
+//  matched with the same one in the new results.  A point is a regression
+//  when its mean cycle count is more than --threshold percent higher and,
+//  where both sides have repetitions, Welch's t test says the difference is
+//  real at --confidence.  With a single sample on either side the threshold
+//  alone decides.  Exits 1 if anything regressed, 0 if not.
+//
+//      result_compare [--threshold=pct] [--confidence=95|99] [--metric=result|corrected]
+//                     [--changes] [--fail-missing] baseline new
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_set.h"
+
+#define COMPARE_THRESHOLD       5.0             //  Percent
+#define COMPARE_CONFIDENCE      95
+
+typedef struct
+{
+    double threshold;
+    int confidence;
+    bool changes_only;
+    bool fail_missing;
+    int regressions;
+    int improvements;
+    int noisy;
+    int same;
+    int missing;
+    int added;
+} compare_options;
+
+static void print_summary(const result_summary *summary)
+{
+    if (summary->count == 0)
+    {
+        printf(" %14s %10s %4s", "-", "-", "-");
+    }
+    else
+    {
+        printf(" %14.1f %10.1f %4d", summary->mean, summary->stddev, summary->count);
+    }
+}
+
+static void print_row(const result_series *series, const result_summary *base, const result_summary *now,
+                      double change, const char *t, const char *verdict)
+{
+    printf("%-5s %-28s %9lu", series->type, series->test, (long unsigned int)series->size);
+    print_summary(base);
+    print_summary(now);
+    if ((base->count != 0) && (now->count != 0))
+    {
+        printf(" %+8.2f%% %8s", change, t);
+    }
+    else
+    {
+        printf(" %9s %8s", "-", "-");
+    }
+    printf("  %s\n", verdict);
+}
+
+static void compare_series(compare_options *options, const result_series *base_series, const result_series *new_series)
+{
+    result_summary base, now;
+    char t_text[16] = "-";
+    bool significant = true;
+    const char *verdict;
+
+    result_series_summary(base_series, &base);
+    result_series_summary(new_series, &now);
+
+    double change = (base.mean != 0.0) ? 100.0 * (now.mean - base.mean) / base.mean : 0.0;
+
+    if ((base.count > 1) && (now.count > 1))
+    {
+        double df;
+        double t = result_welch_t(&base, &now, &df);
+
+        significant = fabs(t) > result_t_critical(df, options->confidence);
+        if (isinf(t))
+        {
+            snprintf(t_text, sizeof(t_text), "%s", (t > 0) ? "inf" : "-inf");
+        }
+        else
+        {
+            snprintf(t_text, sizeof(t_text), "%.2f", t);
+        }
+    }
+
+    if (fabs(change) <= options->threshold)
+    {
+        verdict = "same";
+        options->same++;
+    }
+    else if (!significant)
+    {
+        verdict = "noisy";
+        options->noisy++;
+    }
+    else if (change > 0)
+    {
+        verdict = "SLOWER";
+        options->regressions++;
+    }
+    else
+    {
+        verdict = "faster";
+        options->improvements++;
+    }
+
+    if (!options->changes_only || (strcmp(verdict, "same") != 0))
+    {
+        print_row(base_series, &base, &now, change, t_text, verdict);
+    }
+}
+
+static void print_one_side(const result_series *series, bool in_base)
+{
+    result_summary summary, none;
+
+    result_series_summary(series, &summary);
+    memset(&none, 0, sizeof(none));
+    print_row(series, in_base ? &summary : &none, in_base ? &none : &summary, 0.0, "-", in_base ? "missing" : "new");
+}
+
+int main(int argc, char **argv)
+{
+    static result_set base_set, new_set;
+    compare_options options = { COMPARE_THRESHOLD, COMPARE_CONFIDENCE };
+    result_metric metric = RESULT_METRIC_RESULT;
+    const char *paths[2] = { NULL, NULL };
+    int path_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--threshold=", 12) == 0)
+        {
+            options.threshold = atof(argv[i] + 12);
+        }
+        else if (strncmp(argv[i], "--confidence=", 13) == 0)
+        {
+            options.confidence = atoi(argv[i] + 13);
+        }
+        else if (strcmp(argv[i], "--metric=result") == 0)
+        {
+            metric = RESULT_METRIC_RESULT;
+        }
+        else if (strcmp(argv[i], "--metric=corrected") == 0)
+        {
+            metric = RESULT_METRIC_CORRECTED;
+        }
+        else if (strcmp(argv[i], "--changes") == 0)
+        {
+            options.changes_only = true;
+        }
+        else if (strcmp(argv[i], "--fail-missing") == 0)
+        {
+            options.fail_missing = true;
+        }
+        else if ((argv[i][0] != '-') && (path_count < 2))
+        {
+            paths[path_count++] = argv[i];
+        }
+        else
+        {
+            path_count = -1;
+            break;
+        }
+    }
+
+    if ((path_count != 2) || ((options.confidence != 95) && (options.confidence != 99)) || (options.threshold < 0.0))
+    {
+        fprintf(stderr, "usage: result_compare [--threshold=pct] [--confidence=95|99] [--metric=result|corrected]\n"
+                        "                      [--changes] [--fail-missing] baseline new\n");
+        return 2;
+    }
+
+    result_set_init(&base_set, metric);
+    result_set_init(&new_set, metric);
+    if (!result_set_load(&base_set, paths[0]) || !result_set_load(&new_set, paths[1]))
+    {
+        return 2;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (((i == 0) ? base_set.samples : new_set.samples) == 0)
+        {
+            fprintf(stderr, "%s: no Test or Plan results\n", paths[i]);
+            return 2;
+        }
+    }
+
+    printf("%-5s %-28s %9s %14s %10s %4s %14s %10s %4s %9s %8s  %s\n",
+           "type", "test", "size", "base", "sd", "n", "new", "sd", "n", "change", "t", "verdict");
+
+    for (int i = 0; i < base_set.count; i++)
+    {
+        const result_series *base_series = &base_set.series[i];
+        const result_series *new_series = result_set_find(&new_set, base_series->type, base_series->test, base_series->size);
+
+        if (new_series == NULL)
+        {
+            options.missing++;
+            print_one_side(base_series, true);
+        }
+        else
+        {
+            compare_series(&options, base_series, new_series);
+        }
+    }
+    for (int i = 0; i < new_set.count; i++)
+    {
+        const result_series *new_series = &new_set.series[i];
+        if (result_set_find(&base_set, new_series->type, new_series->test, new_series->size) == NULL)
+        {
+            options.added++;
+            print_one_side(new_series, false);
+        }
+    }
+
+    printf("Compare, threshold, %.1f%%, confidence, %d%%, slower, %d, faster, %d, noisy, %d, same, %d, missing, %d, new, %d\n",
+           options.threshold, options.confidence, options.regressions, options.improvements, options.noisy,
+           options.same, options.missing, options.added);
+
+    result_set_free(&base_set);
+    result_set_free(&new_set);
+
+    bool failed = (options.regressions != 0) || (options.fail_missing && (options.missing != 0));
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+#!/bin/sh
+#
+# result_compare on the committed results, against itself and against copies
+# with one test made slower / faster / left out, the way ctest runs it:
+#
+#   result_compare_test.sh <result_compare> <results csv> <work directory>
+
+RESULT_COMPARE="$1"
+RESULTS="$2"
+WORK="$3"
+TESTS=14                                # Test lines in the committed results
+failures=0
+
+fail()
+{
+    echo "FAIL, $*"
+    failures=$((failures + 1))
+}
+
+# scale <test name> <factor> <output>, the results with one test's cycles scaled
+scale()
+{
+    awk -v name="$1" -v factor="$2" 'BEGIN { FS = OFS = ", " }
+        $1 == "Test" && $2 == name { $5 = sprintf("%.0f", $5 * factor) } { print }' "$RESULTS" > "$3"
+}
+
+# compare <name> <expected exit> [result_compare options] <base> <new>
+compare()
+{
+    name="$1"
+    expected="$2"
+    shift 2
+    "$RESULT_COMPARE" "$@" > "$WORK/$name.out" 2>&1
+    status=$?
+    [ $status -eq "$expected" ] || fail "$name, exit $status, expected $expected"
+}
+
+# verdict <name> <test name> <verdict>
+verdict()
+{
+    grep -q "^Test  $2 .* $3\$" "$WORK/$1.out" || fail "$1, $2 not $3"
+}
+
+# summary <name> <field> <count>
+summary()
+{
+    grep -q "^Compare, .*, $2, $3," "$WORK/$1.out" || fail "$1, $2 not $3: $(grep '^Compare' "$WORK/$1.out")"
+}
+
+mkdir -p "$WORK" || exit 1
+[ "$(grep -c '^Test, ' "$RESULTS")" -eq $TESTS ] || fail "results, expected $TESTS Test lines"
+
+# Against itself, nothing moves
+compare self 0 "$RESULTS" "$RESULTS"
+summary self same $TESTS
+verdict self "SEQ SRAM READ" same
+
+# 20% slower random PSRAM reads are a regression, the rest stay the same
+scale "RND PSRAM READ" 1.20 "$WORK/slower.csv"
+compare slower 1 "$RESULTS" "$WORK/slower.csv"
+verdict slower "RND PSRAM READ" SLOWER
+grep -q "RND PSRAM READ .* +20.00% " "$WORK/slower.out" || fail "slower, change not +20%"
+summary slower slower 1
+summary slower same $((TESTS - 1))
+
+# Faster is reported but doesn't fail
+scale "SEQ PSRAM WRITE" 0.80 "$WORK/faster.csv"
+compare faster 0 "$RESULTS" "$WORK/faster.csv"
+verdict faster "SEQ PSRAM WRITE" faster
+summary faster faster 1
+
+# 3% is inside the default 5% threshold, outside a 2% one
+scale "RND SRAM READ" 1.03 "$WORK/small.csv"
+compare small 0 "$RESULTS" "$WORK/small.csv"
+verdict small "RND SRAM READ" same
+compare small_threshold 1 --threshold=2 "$RESULTS" "$WORK/small.csv"
+verdict small_threshold "RND SRAM READ" SLOWER
+
+# A test that didn't run is only a failure when asked
+grep -v "^Test, SEQ ROM READ," "$RESULTS" > "$WORK/missing.csv"
+compare missing 0 "$RESULTS" "$WORK/missing.csv"
+verdict missing "SEQ ROM READ" missing
+summary missing missing 1
+compare fail_missing 1 --fail-missing "$RESULTS" "$WORK/missing.csv"
+compare added 0 "$WORK/missing.csv" "$RESULTS"
+verdict added "SEQ ROM READ" new
+
+# Two runs a side, a consistent slowdown is significant, a scattered one isn't
+scale "RND PSRAM READ" 1.01 "$WORK/run2.csv"
+cat "$RESULTS" "$WORK/run2.csv" > "$WORK/base2.csv"
+scale "RND PSRAM READ" 1.20 "$WORK/run3.csv"
+scale "RND PSRAM READ" 1.21 "$WORK/run4.csv"
+cat "$WORK/run3.csv" "$WORK/run4.csv" > "$WORK/slower2.csv"
+compare repeated 1 "$WORK/base2.csv" "$WORK/slower2.csv"
+verdict repeated "RND PSRAM READ" SLOWER
+scale "RND PSRAM READ" 0.90 "$WORK/run5.csv"
+scale "RND PSRAM READ" 1.40 "$WORK/run6.csv"
+cat "$WORK/run5.csv" "$WORK/run6.csv" > "$WORK/noisy2.csv"
+compare noisy 0 "$WORK/base2.csv" "$WORK/noisy2.csv"
+verdict noisy "RND PSRAM READ" noisy
+summary noisy noisy 1
+
+echo "result_compare_test, $([ $failures -eq 0 ] && echo pass || echo fail), failures, $failures"
+[ $failures -eq 0 ]
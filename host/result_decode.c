@@ -0,0 +1,598 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_decode.h"
+
+void result_decoder_init(result_decoder *decoder, result_record_callback on_record, result_text_callback on_text, void *context)
+{
+    memset(decoder, 0, sizeof(result_decoder));
+    decoder->on_record = on_record;
+    decoder->on_text = on_text;
+    decoder->context = context;
+}
+
+size_t result_get_varint(const uint8_t *data, size_t length, uint64_t *value)
+{
+    uint64_t result = 0;
+
+    for (size_t i = 0; (i < length) && (i < 10); i++)
+    {
+        result |= (uint64_t)(data[i] & 0x7F) << (7 * i);
+        if ((data[i] & 0x80) == 0)
+        {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+
+//  Text between frames
+
+static void text_flush(result_decoder *decoder)
+{
+    if (decoder->text_used == 0)
+    {
+        return;
+    }
+
+    //  Drop the CR of CR LF
+    if (decoder->text[decoder->text_used - 1] == '\r')
+    {
+        decoder->text_used--;
+    }
+    decoder->text[decoder->text_used] = 0;
+    decoder->text_used = 0;
+
+    if (decoder->on_text != NULL)
+    {
+        decoder->on_text(decoder->context, decoder->text);
+    }
+}
+
+static void text_byte(result_decoder *decoder, uint8_t byte)
+{
+    if (byte == '\n')
+    {
+        text_flush(decoder);
+        return;
+    }
+
+    decoder->text[decoder->text_used++] = (char)byte;
+    if (decoder->text_used == (RESULT_DECODE_TEXT_MAX - 1))
+    {
+        text_flush(decoder);
+    }
+}
+
+
+//  Frame payloads
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    bool error;
+} payload_reader;
+
+static uint8_t read_u8(payload_reader *reader)
+{
+    if (reader->position >= reader->length)
+    {
+        reader->error = true;
+        return 0;
+    }
+    return reader->data[reader->position++];
+}
+
+static uint32_t read_u32(payload_reader *reader)
+{
+    uint32_t value = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        value |= (uint32_t)read_u8(reader) << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t read_varint(payload_reader *reader)
+{
+    uint64_t value = 0;
+    size_t used = result_get_varint(reader->data + reader->position, reader->length - reader->position, &value);
+
+    if (used == 0)
+    {
+        reader->error = true;
+    }
+    reader->position += used;
+    return value;
+}
+
+static void read_string(payload_reader *reader, char *out)
+{
+    uint8_t length = read_u8(reader);
+
+    if (reader->error || (reader->position + length > reader->length))
+    {
+        reader->error = true;
+        out[0] = 0;
+        return;
+    }
+    memcpy(out, reader->data + reader->position, length);
+    out[length] = 0;
+    reader->position += length;
+}
+
+static bool decode_schema(result_decoder *decoder, payload_reader *reader)
+{
+    uint8_t id = read_u8(reader);
+    uint8_t field_count = read_u8(reader);
+    result_decoded_schema schema;
+
+    if (reader->error || (id >= RESULT_MAX_SCHEMAS) || (field_count > RESULT_MAX_FIELDS))
+    {
+        return false;
+    }
+
+    read_string(reader, schema.type);
+    schema.field_count = field_count;
+    for (int f = 0; f < field_count; f++)
+    {
+        schema.field_types[f] = read_u8(reader);
+        read_string(reader, schema.field_keys[f]);
+        if ((schema.field_types[f] < RESULT_TYPE_STR) || (schema.field_types[f] > RESULT_TYPE_F32))
+        {
+            return false;
+        }
+    }
+    if (reader->error || (reader->position != reader->length))
+    {
+        return false;
+    }
+
+    schema.valid = true;
+    decoder->schemas[id] = schema;
+    decoder->schemas_seen++;
+    return true;
+}
+
+static bool decode_record(result_decoder *decoder, payload_reader *reader)
+{
+    static result_decoded record;
+    uint8_t id = read_u8(reader);
+
+    if (reader->error || (id >= RESULT_MAX_SCHEMAS) || !decoder->schemas[id].valid)
+    {
+        decoder->unknown_schema++;
+        return true;
+    }
+
+    const result_decoded_schema *schema = &decoder->schemas[id];
+    record.schema = schema;
+
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        result_value *value = &record.values[f];
+        uint32_t bits;
+
+        value->type = schema->field_types[f];
+        switch (value->type)
+        {
+            case RESULT_TYPE_STR:
+                read_string(reader, value->s);
+                break;
+            case RESULT_TYPE_U64:
+                value->u = read_varint(reader);
+                break;
+            case RESULT_TYPE_I64:
+            {
+                uint64_t zigzag = read_varint(reader);
+                value->i = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+                break;
+            }
+            case RESULT_TYPE_HEX:
+                value->u = read_u32(reader);
+                break;
+            default:
+                bits = read_u32(reader);
+                memcpy(&value->f, &bits, sizeof(bits));
+                break;
+        }
+    }
+
+    if (reader->error || (reader->position != reader->length))
+    {
+        return false;
+    }
+
+    decoder->records++;
+    if (decoder->on_record != NULL)
+    {
+        decoder->on_record(decoder->context, &record);
+    }
+    return true;
+}
+
+static bool decode_payload(result_decoder *decoder, const uint8_t *data, size_t length)
+{
+    payload_reader reader = { data, length, 0, false };
+    uint8_t kind = read_u8(&reader);
+
+    if (kind == RESULT_FRAME_SCHEMA)
+    {
+        return decode_schema(decoder, &reader);
+    }
+    if (kind == RESULT_FRAME_RECORD)
+    {
+        return decode_record(decoder, &reader);
+    }
+    return false;
+}
+
+//  Work through what's buffered, from a possible frame start.  A bad frame
+//  gives its magic byte up as text and the scan starts again one byte on.
+static void decode_frames(result_decoder *decoder, bool finish)
+{
+    size_t start = 0;
+
+    while (start < decoder->frame_used)
+    {
+        uint8_t *frame = decoder->frame + start;
+        size_t available = decoder->frame_used - start;
+
+        if (frame[0] != RESULT_FRAME_MAGIC)
+        {
+            text_byte(decoder, frame[0]);
+            start++;
+            continue;
+        }
+
+        if (available < 3)
+        {
+            break;
+        }
+
+        //  Nothing longer is ever encoded, don't wait for it
+        size_t length = frame[1] | (frame[2] << 8);
+        bool possible = (length != 0) && (length <= RESULT_RECORD_SIZE + 2);
+
+        if (possible && (available < (length + RESULT_FRAME_OVERHEAD)))
+        {
+            break;
+        }
+
+        if (possible && (result_checksum(frame + 3, length) == frame[3 + length]) && decode_payload(decoder, frame + 3, length))
+        {
+            //  A frame ends any partial text line
+            text_flush(decoder);
+            start += length + RESULT_FRAME_OVERHEAD;
+        }
+        else
+        {
+            decoder->bad_frames++;
+            text_byte(decoder, frame[0]);
+            start++;
+        }
+    }
+
+    //  Left over at the end of input can't become a frame
+    if (finish)
+    {
+        for (; start < decoder->frame_used; start++)
+        {
+            text_byte(decoder, decoder->frame[start]);
+        }
+        text_flush(decoder);
+    }
+
+    memmove(decoder->frame, decoder->frame + start, decoder->frame_used - start);
+    decoder->frame_used -= start;
+}
+
+void result_decoder_feed(result_decoder *decoder, const uint8_t *data, size_t length)
+{
+    while (length != 0)
+    {
+        size_t space = RESULT_DECODE_FRAME_MAX - decoder->frame_used;
+        size_t chunk = (length < space) ? length : space;
+
+        memcpy(decoder->frame + decoder->frame_used, data, chunk);
+        decoder->frame_used += chunk;
+        data += chunk;
+        length -= chunk;
+
+        decode_frames(decoder, false);
+    }
+}
+
+void result_decoder_finish(result_decoder *decoder)
+{
+    decode_frames(decoder, true);
+}
+
+
+//  Output
+
+const result_value *result_decoded_field(const result_decoded *record, const char *key)
+{
+    for (int f = 0; f < record->schema->field_count; f++)
+    {
+        if (strcmp(record->schema->field_keys[f], key) == 0)
+        {
+            return &record->values[f];
+        }
+    }
+    return NULL;
+}
+
+#define JSON_APPEND(...)    used += snprintf(buffer + ((used < size) ? used : size), (used < size) ? (size - used) : 0, __VA_ARGS__)
+
+static size_t json_string(char *buffer, size_t size, size_t used, const char *text)
+{
+    JSON_APPEND("\"");
+    for (const char *c = text; *c != 0; c++)
+    {
+        if ((*c == '"') || (*c == '\\'))
+        {
+            JSON_APPEND("\\%c", *c);
+        }
+        else if ((unsigned char)*c < ' ')
+        {
+            JSON_APPEND("\\u%04x", (unsigned)*c);
+        }
+        else
+        {
+            JSON_APPEND("%c", *c);
+        }
+    }
+    JSON_APPEND("\"");
+    return used;
+}
+
+size_t result_decoded_json(const result_decoded *record, char *buffer, size_t size)
+{
+    size_t used = 0;
+
+    JSON_APPEND("{\"type\":");
+    used = json_string(buffer, size, used, record->schema->type);
+
+    for (int f = 0; f < record->schema->field_count; f++)
+    {
+        const result_value *value = &record->values[f];
+
+        JSON_APPEND(",");
+        used = json_string(buffer, size, used, record->schema->field_keys[f]);
+        JSON_APPEND(":");
+
+        switch (value->type)
+        {
+            case RESULT_TYPE_STR:
+                used = json_string(buffer, size, used, value->s);
+                break;
+            case RESULT_TYPE_U64:
+                JSON_APPEND("%llu", (unsigned long long)value->u);
+                break;
+            case RESULT_TYPE_I64:
+                JSON_APPEND("%lld", (long long)value->i);
+                break;
+            case RESULT_TYPE_HEX:
+                JSON_APPEND("\"0x%08lX\"", (long unsigned int)value->u);
+                break;
+            default:
+                if ((value->f != value->f) || (value->f > 3.4e38f) || (value->f < -3.4e38f))
+                {
+                    JSON_APPEND("null");
+                }
+                else
+                {
+                    JSON_APPEND("%.6g", (double)value->f);
+                }
+                break;
+        }
+    }
+    JSON_APPEND("}\n");
+
+    return used;
+}
+
+//  Quoted JSON string at text into out, returns the character after it or NULL
+static const char *json_parse_string(const char *text, char *out, size_t size)
+{
+    size_t used = 0;
+
+    if (*text++ != '"')
+    {
+        return NULL;
+    }
+    while (*text != '"')
+    {
+        char c = *text++;
+
+        if (c == 0)
+        {
+            return NULL;
+        }
+        if (c == '\\')
+        {
+            c = *text++;
+            if (c == 'u')
+            {
+                unsigned code = 0;
+                if (sscanf(text, "%4x", &code) != 1)
+                {
+                    return NULL;
+                }
+                text += 4;
+                c = (code < 0x80) ? (char)code : '?';
+            }
+            else if (c == 'n')
+            {
+                c = '\n';
+            }
+            else if (c == 't')
+            {
+                c = '\t';
+            }
+            else if (c == 0)
+            {
+                return NULL;
+            }
+        }
+        if (used < size - 1)
+        {
+            out[used++] = c;
+        }
+    }
+    out[used] = 0;
+    return text + 1;
+}
+
+static const char *json_skip_space(const char *text)
+{
+    while ((*text == ' ') || (*text == '\t') || (*text == '\r') || (*text == '\n'))
+    {
+        text++;
+    }
+    return text;
+}
+
+bool result_json_parse(const char *line, result_decoded_schema *schema, result_decoded *record)
+{
+    const char *at = json_skip_space(line);
+
+    memset(schema, 0, sizeof(result_decoded_schema));
+    record->schema = schema;
+
+    if (*at++ != '{')
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        char key[RESULT_MAX_STRING + 1];
+
+        at = json_skip_space(at);
+        if (*at == '}')
+        {
+            break;
+        }
+        if (((at = json_parse_string(at, key, sizeof(key))) == NULL) || (*(at = json_skip_space(at)) != ':'))
+        {
+            return false;
+        }
+        at = json_skip_space(at + 1);
+
+        result_value value;
+        memset(&value, 0, sizeof(value));
+
+        if (*at == '"')
+        {
+            if ((at = json_parse_string(at, value.s, sizeof(value.s))) == NULL)
+            {
+                return false;
+            }
+            //  Hex values are written as "0x..." strings
+            char *end;
+            if ((strncmp(value.s, "0x", 2) == 0) && (value.s[2] != 0))
+            {
+                value.u = strtoull(value.s + 2, &end, 16);
+                value.type = (*end == 0) ? RESULT_TYPE_HEX : RESULT_TYPE_STR;
+            }
+            else
+            {
+                value.type = RESULT_TYPE_STR;
+            }
+        }
+        else if (strncmp(at, "null", 4) == 0)
+        {
+            value.type = RESULT_TYPE_F32;
+            value.f = NAN;
+            at += 4;
+        }
+        else
+        {
+            char *end;
+            size_t length = strcspn(at, ",} \t\r\n");
+
+            if ((memchr(at, '.', length) != NULL) || (memchr(at, 'e', length) != NULL) || (memchr(at, 'E', length) != NULL))
+            {
+                value.type = RESULT_TYPE_F32;
+                value.f = strtof(at, &end);
+            }
+            else if (*at == '-')
+            {
+                value.type = RESULT_TYPE_I64;
+                value.i = strtoll(at, &end, 10);
+            }
+            else
+            {
+                value.type = RESULT_TYPE_U64;
+                value.u = strtoull(at, &end, 10);
+            }
+            if ((end == at) || (end != at + length))
+            {
+                return false;
+            }
+            at = end;
+        }
+
+        if (strcmp(key, "type") == 0)
+        {
+            if (value.type != RESULT_TYPE_STR)
+            {
+                return false;
+            }
+            strcpy(schema->type, value.s);
+        }
+        else if (schema->field_count < RESULT_MAX_FIELDS)
+        {
+            int f = schema->field_count++;
+            strcpy(schema->field_keys[f], key);
+            schema->field_types[f] = value.type;
+            record->values[f] = value;
+        }
+
+        at = json_skip_space(at);
+        if (*at == ',')
+        {
+            at++;
+        }
+        else if (*at != '}')
+        {
+            return false;
+        }
+    }
+
+    schema->valid = (schema->type[0] != 0);
+    return schema->valid;
+}
@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Host decoder for the binary result stream (result_out.h)
+//
+//  Bytes are fed in as they arrive from the serial port or a capture file.
+//  Frames are checked (magic, length, checksum) and turned back into typed
+//  records, anything between frames is passed on as lines of text so the
+//  ordinary printf output mixed in with the records isn't lost.
+
+#ifndef RESULT_DECODE_H
+#define RESULT_DECODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "result_out.h"
+
+#define RESULT_DECODE_FRAME_MAX     (RESULT_FRAME_OVERHEAD + 0xFFFF)
+#define RESULT_DECODE_TEXT_MAX      1024
+
+typedef struct
+{
+    uint8_t type;                       //  RESULT_TYPE_*
+    uint64_t u;                         //  U64 / HEX
+    int64_t i;
+    float f;
+    char s[RESULT_MAX_STRING + 1];
+} result_value;
+
+typedef struct
+{
+    char type[RESULT_MAX_STRING + 1];
+    int field_count;
+    uint8_t field_types[RESULT_MAX_FIELDS];
+    char field_keys[RESULT_MAX_FIELDS][RESULT_MAX_STRING + 1];
+    bool valid;
+} result_decoded_schema;
+
+typedef struct
+{
+    const result_decoded_schema *schema;
+    result_value values[RESULT_MAX_FIELDS];
+} result_decoded;
+
+typedef void (*result_record_callback)(void *context, const result_decoded *record);
+typedef void (*result_text_callback)(void *context, const char *line);
+
+typedef struct
+{
+    result_record_callback on_record;
+    result_text_callback on_text;
+    void *context;
+
+    result_decoded_schema schemas[RESULT_MAX_SCHEMAS];
+
+    uint8_t frame[RESULT_DECODE_FRAME_MAX];
+    size_t frame_used;
+    char text[RESULT_DECODE_TEXT_MAX];
+    size_t text_used;
+
+    uint64_t records;
+    uint64_t schemas_seen;
+    uint64_t bad_frames;                //  Checksum / length / content errors
+    uint64_t unknown_schema;            //  Record before its schema, e.g. joined late
+} result_decoder;
+
+void result_decoder_init(result_decoder *decoder, result_record_callback on_record, result_text_callback on_text, void *context);
+void result_decoder_feed(result_decoder *decoder, const uint8_t *data, size_t length);
+
+//  End of input, passes on any partial line or frame as text
+void result_decoder_finish(result_decoder *decoder);
+
+//  One decoded record as a JSON line (with the newline), returns the length
+//  needed like snprintf
+size_t result_decoded_json(const result_decoded *record, char *buffer, size_t size);
+
+//  One of our own JSON lines back into a record, the reverse of
+//  result_decoded_json().  Hex comes back from its "0x..." string, other
+//  numbers as F32 if they have a fraction or exponent.
+bool result_json_parse(const char *line, result_decoded_schema *schema, result_decoded *record);
+
+//  Look a field up by key, NULL if it isn't there
+const result_value *result_decoded_field(const result_decoded *record, const char *key);
+
+//  Varint from data, returns the bytes used or 0 if it runs off the end
+size_t result_get_varint(const uint8_t *data, size_t length, uint64_t *value);
+
+#endif
@@ -0,0 +1,84 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Binary result capture to JSON Lines
+//
+//  Text between the binary frames is passed through as it was, or dropped
+//  with --records.  Counts of records / bad frames go to stderr.
+//
+//      result_decode [--records] [capture] > results.jsonl
+
+#include <stdio.h>
+#include <string.h>
+
+#include "result_decode.h"
+
+static void on_record(void *context, const result_decoded *record)
+{
+    char line[4096];
+    size_t length = result_decoded_json(record, line, sizeof(line));
+
+    fwrite(line, 1, (length < sizeof(line)) ? length : sizeof(line) - 1, stdout);
+}
+
+static void on_text(void *context, const char *line)
+{
+    printf("%s\n", line);
+}
+
+int main(int argc, char **argv)
+{
+    static result_decoder decoder;
+    static uint8_t buffer[4096];
+    bool records_only = false;
+    FILE *input = stdin;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--records") == 0)
+        {
+            records_only = true;
+        }
+        else if ((input = fopen(argv[i], "rb")) == NULL)
+        {
+            fprintf(stderr, "%s: can't open\n", argv[i]);
+            return 1;
+        }
+    }
+
+    result_decoder_init(&decoder, on_record, records_only ? NULL : on_text, NULL);
+
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), input)) != 0)
+    {
+        result_decoder_feed(&decoder, buffer, length);
+    }
+    result_decoder_finish(&decoder);
+
+    fprintf(stderr, "records, %llu, schemas, %llu, bad_frames, %llu, unknown_schema, %llu\n",
+            (unsigned long long)decoder.records, (unsigned long long)decoder.schemas_seen,
+            (unsigned long long)decoder.bad_frames, (unsigned long long)decoder.unknown_schema);
+
+    return (decoder.bad_frames == 0) ? 0 : 1;
+}
@@ -0,0 +1,1036 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Self contained HTML report of one or more result captures
+//
+//  The run header, tables of every record type, and SVG charts for the
+//  parts that read better as pictures: working set sweeps (Test / Plan
+//  records over several sizes), latency histograms and address heatmaps
+//  (any record with a row and a column).  Everything is inline, no
+//  scripts, fonts or network, so the file can be attached to a board
+//  qualification and opened anywhere.  Input is binary captures or JSON
+//  Lines, CSV logs don't say what their columns are.
+//
+//      result_report [--title=text] [--out=report.html] capture...
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_decode.h"
+
+#define REPORT_MAX_SCHEMAS      256
+#define REPORT_MAX_TYPES        64
+#define REPORT_MAX_SERIES       64
+#define REPORT_TABLE_ROWS       500             //  Longer tables are cut short
+#define REPORT_CHART_WIDTH      720
+#define REPORT_CHART_HEIGHT     360
+#define REPORT_CELL             12              //  Heatmap cell in pixels
+#define REPORT_COLUMNS_MAX      128             //  Heatmap width in cells
+
+typedef struct
+{
+    char type[RESULT_MAX_STRING + 1];
+    int field_count;
+    uint8_t field_types[RESULT_MAX_FIELDS];
+    char field_keys[RESULT_MAX_FIELDS][RESULT_MAX_STRING + 1];
+} report_schema;
+
+typedef struct
+{
+    uint8_t type;
+    double number;
+    char *text;                         //  Strings only
+} report_value;
+
+typedef struct
+{
+    const report_schema *schema;
+    report_value *values;
+} report_record;
+
+typedef struct
+{
+    const char *name;
+    double *x;
+    double *y;
+    int *samples;                       //  Results averaged into each y
+    int count;
+} report_series;
+
+static report_schema *s_schemas[REPORT_MAX_SCHEMAS];
+static int s_schema_count = 0;
+static report_record *s_records = NULL;
+static int s_record_count = 0;
+static int s_record_capacity = 0;
+static uint64_t s_skipped = 0;
+static FILE *s_out;
+
+static const char * const s_colours[] =
+{
+    "#1f77b4", "#d62728", "#2ca02c", "#ff7f0e", "#9467bd", "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22", "#17becf"
+};
+#define REPORT_COLOURS  (sizeof(s_colours) / sizeof(s_colours[0]))
+
+//  Schemas can be sent again with other ids mid capture, records keep their own copy
+static const report_schema *report_intern(const result_decoded_schema *decoded)
+{
+    for (int i = 0; i < s_schema_count; i++)
+    {
+        report_schema *schema = s_schemas[i];
+        bool same = (schema->field_count == decoded->field_count) && (strcmp(schema->type, decoded->type) == 0);
+
+        for (int f = 0; same && (f < schema->field_count); f++)
+        {
+            same = (strcmp(schema->field_keys[f], decoded->field_keys[f]) == 0);
+        }
+        if (same)
+        {
+            return schema;
+        }
+    }
+    if (s_schema_count == REPORT_MAX_SCHEMAS)
+    {
+        return NULL;
+    }
+
+    report_schema *schema = calloc(1, sizeof(report_schema));
+    if (schema == NULL)
+    {
+        return NULL;
+    }
+    strcpy(schema->type, decoded->type);
+    schema->field_count = decoded->field_count;
+    for (int f = 0; f < decoded->field_count; f++)
+    {
+        schema->field_types[f] = decoded->field_types[f];
+        strcpy(schema->field_keys[f], decoded->field_keys[f]);
+    }
+    s_schemas[s_schema_count++] = schema;
+    return schema;
+}
+
+static void report_add(const result_decoded *decoded)
+{
+    const report_schema *schema = report_intern(decoded->schema);
+
+    if (schema == NULL)
+    {
+        s_skipped++;
+        return;
+    }
+    if (s_record_count == s_record_capacity)
+    {
+        int capacity = s_record_capacity ? s_record_capacity * 2 : 1024;
+        report_record *grown = realloc(s_records, capacity * sizeof(report_record));
+        if (grown == NULL)
+        {
+            s_skipped++;
+            return;
+        }
+        s_records = grown;
+        s_record_capacity = capacity;
+    }
+
+    report_record *record = &s_records[s_record_count];
+    record->schema = schema;
+    record->values = calloc(schema->field_count ? schema->field_count : 1, sizeof(report_value));
+    if (record->values == NULL)
+    {
+        s_skipped++;
+        return;
+    }
+
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        const result_value *value = &decoded->values[f];
+        report_value *out = &record->values[f];
+
+        out->type = value->type;
+        switch (value->type)
+        {
+            case RESULT_TYPE_STR:   out->text = strdup(value->s); break;
+            case RESULT_TYPE_I64:   out->number = (double)value->i; break;
+            case RESULT_TYPE_F32:   out->number = (double)value->f; break;
+            default:                out->number = (double)value->u; break;
+        }
+    }
+    s_record_count++;
+}
+
+static void on_record(void *context, const result_decoded *record)
+{
+    report_add(record);
+}
+
+static void on_text(void *context, const char *line)
+{
+    static result_decoded_schema schema;
+    static result_decoded record;
+
+    if ((line[0] == '{') && result_json_parse(line, &schema, &record))
+    {
+        report_add(&record);
+    }
+}
+
+static bool report_load(const char *path)
+{
+    static result_decoder decoder;
+    uint8_t buffer[4096];
+    size_t length;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: can't open\n", path);
+        return false;
+    }
+
+    result_decoder_init(&decoder, on_record, on_text, NULL);
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) != 0)
+    {
+        result_decoder_feed(&decoder, buffer, length);
+    }
+    result_decoder_finish(&decoder);
+    fclose(file);
+
+    if (decoder.bad_frames != 0)
+    {
+        fprintf(stderr, "%s: %llu bad frames\n", path, (unsigned long long)decoder.bad_frames);
+    }
+    return true;
+}
+
+static const report_value *record_field(const report_record *record, const char *key)
+{
+    for (int f = 0; f < record->schema->field_count; f++)
+    {
+        if (strcmp(record->schema->field_keys[f], key) == 0)
+        {
+            return &record->values[f];
+        }
+    }
+    return NULL;
+}
+
+static bool record_number(const report_record *record, const char *key, double *number)
+{
+    const report_value *value = record_field(record, key);
+
+    if ((value == NULL) || (value->type == RESULT_TYPE_STR) || isnan(value->number))
+    {
+        return false;
+    }
+    *number = value->number;
+    return true;
+}
+
+static const char *record_text(const report_record *record, const char *key)
+{
+    const report_value *value = record_field(record, key);
+    return ((value != NULL) && (value->type == RESULT_TYPE_STR)) ? value->text : NULL;
+}
+
+static void html_text(const char *text)
+{
+    for (; *text != 0; text++)
+    {
+        switch (*text)
+        {
+            case '<':   fputs("&lt;", s_out); break;
+            case '>':   fputs("&gt;", s_out); break;
+            case '&':   fputs("&amp;", s_out); break;
+            case '"':   fputs("&quot;", s_out); break;
+            default:    fputc(*text, s_out); break;
+        }
+    }
+}
+
+static void html_value(const report_value *value)
+{
+    switch (value->type)
+    {
+        case RESULT_TYPE_STR:
+            html_text(value->text);
+            break;
+        case RESULT_TYPE_HEX:
+            fprintf(s_out, "0x%08lX", (long unsigned int)value->number);
+            break;
+        case RESULT_TYPE_F32:
+            fprintf(s_out, "%.4g", value->number);
+            break;
+        default:
+            fprintf(s_out, "%.0f", value->number);
+            break;
+    }
+}
+
+//  Sizes and counts as 256, 4K, 1M
+static void format_size(char *text, size_t size, double value)
+{
+    if ((value >= 1024 * 1024) && (fmod(value, 1024 * 1024) == 0))
+    {
+        snprintf(text, size, "%.0fM", value / (1024 * 1024));
+    }
+    else if ((value >= 1024) && (fmod(value, 1024) == 0))
+    {
+        snprintf(text, size, "%.0fK", value / 1024);
+    }
+    else
+    {
+        snprintf(text, size, "%.4g", value);
+    }
+}
+
+//  1, 2 or 5 times a power of ten, about count steps over range
+static double nice_step(double range, int count)
+{
+    double rough = range / count;
+    double power = pow(10.0, floor(log10(rough)));
+    double scaled = rough / power;
+
+    return power * ((scaled < 1.5) ? 1.0 : (scaled < 3.5) ? 2.0 : (scaled < 7.5) ? 5.0 : 10.0);
+}
+
+//  Line chart, x on a log 2 axis when log_x
+static void svg_line_chart(const char *title, const char *x_label, const char *y_label,
+                           const report_series *series, int series_count, bool log_x)
+{
+    const int left = 70, right = 170, top = 30, bottom = 50;
+    const int width = REPORT_CHART_WIDTH, height = REPORT_CHART_HEIGHT;
+    const int plot_width = width - left - right, plot_height = height - top - bottom;
+    double x_min = INFINITY, x_max = -INFINITY, y_max = 0.0;
+
+    for (int s = 0; s < series_count; s++)
+    {
+        for (int i = 0; i < series[s].count; i++)
+        {
+            double x = log_x ? log2(series[s].x[i]) : series[s].x[i];
+            x_min = (x < x_min) ? x : x_min;
+            x_max = (x > x_max) ? x : x_max;
+            y_max = (series[s].y[i] > y_max) ? series[s].y[i] : y_max;
+        }
+    }
+    if (!(x_max > x_min))
+    {
+        x_max = x_min + 1.0;
+    }
+    double y_step = nice_step((y_max > 0.0) ? y_max : 1.0, 5);
+    y_max = ceil(((y_max > 0.0) ? y_max : 1.0) / y_step) * y_step;
+
+    #define CHART_X(x)  (left + ((x) - x_min) * plot_width / (x_max - x_min))
+    #define CHART_Y(y)  (top + plot_height - (y) * plot_height / y_max)
+
+    fprintf(s_out, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">\n", width, height, width, height);
+    fprintf(s_out, "<text x=\"%d\" y=\"18\" class=\"title\">", left);
+    html_text(title);
+    fprintf(s_out, "</text>\n");
+
+    //  Grid and axis labels
+    for (double y = 0.0; y <= y_max * 1.0001; y += y_step)
+    {
+        fprintf(s_out, "<line x1=\"%d\" y1=\"%.1f\" x2=\"%d\" y2=\"%.1f\" class=\"grid\"/>", left, CHART_Y(y), left + plot_width, CHART_Y(y));
+        fprintf(s_out, "<text x=\"%d\" y=\"%.1f\" class=\"tick\" text-anchor=\"end\">%.4g</text>\n", left - 6, CHART_Y(y) + 4, y);
+    }
+    double x_step = log_x ? 1.0 : nice_step(x_max - x_min, 6);
+    for (double x = log_x ? ceil(x_min) : ceil(x_min / x_step) * x_step; x <= x_max + 1e-9; x += x_step)
+    {
+        char label[32];
+        format_size(label, sizeof(label), log_x ? pow(2.0, x) : x);
+        fprintf(s_out, "<line x1=\"%.1f\" y1=\"%d\" x2=\"%.1f\" y2=\"%d\" class=\"grid\"/>", CHART_X(x), top, CHART_X(x), top + plot_height);
+        fprintf(s_out, "<text x=\"%.1f\" y=\"%d\" class=\"tick\" text-anchor=\"middle\">%s</text>\n", CHART_X(x), top + plot_height + 16, label);
+    }
+    fprintf(s_out, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" class=\"frame\"/>\n", left, top, plot_width, plot_height);
+    fprintf(s_out, "<text x=\"%d\" y=\"%d\" class=\"label\" text-anchor=\"middle\">", left + plot_width / 2, height - 10);
+    html_text(x_label);
+    fprintf(s_out, "</text>\n<text x=\"14\" y=\"%d\" class=\"label\" text-anchor=\"middle\" transform=\"rotate(-90 14 %d)\">", top + plot_height / 2, top + plot_height / 2);
+    html_text(y_label);
+    fprintf(s_out, "</text>\n");
+
+    for (int s = 0; s < series_count; s++)
+    {
+        const char *colour = s_colours[s % REPORT_COLOURS];
+
+        fprintf(s_out, "<polyline fill=\"none\" stroke=\"%s\" stroke-width=\"2\" points=\"", colour);
+        for (int i = 0; i < series[s].count; i++)
+        {
+            double x = log_x ? log2(series[s].x[i]) : series[s].x[i];
+            fprintf(s_out, "%.1f,%.1f ", CHART_X(x), CHART_Y(series[s].y[i]));
+        }
+        fprintf(s_out, "\"/>\n");
+        for (int i = 0; i < series[s].count; i++)
+        {
+            double x = log_x ? log2(series[s].x[i]) : series[s].x[i];
+            fprintf(s_out, "<circle cx=\"%.1f\" cy=\"%.1f\" r=\"3\" fill=\"%s\"><title>%.4g, %.4g</title></circle>",
+                    CHART_X(x), CHART_Y(series[s].y[i]), colour, series[s].x[i], series[s].y[i]);
+        }
+
+        int legend_y = top + 10 + s * 16;
+        fprintf(s_out, "\n<rect x=\"%d\" y=\"%d\" width=\"10\" height=\"10\" fill=\"%s\"/>", left + plot_width + 10, legend_y - 9, colour);
+        fprintf(s_out, "<text x=\"%d\" y=\"%d\" class=\"tick\">", left + plot_width + 25, legend_y);
+        html_text(series[s].name);
+        fprintf(s_out, "</text>\n");
+    }
+    fprintf(s_out, "</svg>\n");
+
+    #undef CHART_X
+    #undef CHART_Y
+}
+
+//  Bars on a log count axis, so the tail buckets show up
+static void svg_histogram(const char *title, const double *low, const double *high, const double *count, int bins)
+{
+    const int left = 70, right = 20, top = 30, bottom = 60;
+    const int width = REPORT_CHART_WIDTH, height = REPORT_CHART_HEIGHT;
+    const int plot_width = width - left - right, plot_height = height - top - bottom;
+    double top_decade = 1.0;
+
+    for (int i = 0; i < bins; i++)
+    {
+        while (count[i] > pow(10.0, top_decade))
+        {
+            top_decade += 1.0;
+        }
+    }
+
+    #define HIST_Y(c)   (top + plot_height - log10((c) + 1.0) * plot_height / top_decade)
+
+    fprintf(s_out, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">\n", width, height, width, height);
+    fprintf(s_out, "<text x=\"%d\" y=\"18\" class=\"title\">", left);
+    html_text(title);
+    fprintf(s_out, "</text>\n");
+
+    for (int decade = 0; decade <= (int)top_decade; decade++)
+    {
+        double y = top + plot_height - decade * plot_height / top_decade;
+        fprintf(s_out, "<line x1=\"%d\" y1=\"%.1f\" x2=\"%d\" y2=\"%.1f\" class=\"grid\"/>", left, y, left + plot_width, y);
+        fprintf(s_out, "<text x=\"%d\" y=\"%.1f\" class=\"tick\" text-anchor=\"end\">%.0f</text>\n", left - 6, y + 4, pow(10.0, decade));
+    }
+
+    double bar = (double)plot_width / ((bins > 0) ? bins : 1);
+    int label_every = (bins + 15) / 16;
+    for (int i = 0; i < bins; i++)
+    {
+        double x = left + i * bar;
+        double y = HIST_Y(count[i]);
+
+        fprintf(s_out, "<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"%s\"><title>%.0f..%.0f cycles, %.0f</title></rect>",
+                x + 1, y, (bar > 2) ? bar - 2 : bar, top + plot_height - y, s_colours[0], low[i], high[i], count[i]);
+        if ((i % label_every) == 0)
+        {
+            fprintf(s_out, "<text x=\"%.1f\" y=\"%d\" class=\"tick\" text-anchor=\"end\" transform=\"rotate(-45 %.1f %d)\">%.0f</text>",
+                    x + bar / 2, top + plot_height + 14, x + bar / 2, top + plot_height + 14, low[i]);
+        }
+        fprintf(s_out, "\n");
+    }
+    fprintf(s_out, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" class=\"frame\"/>\n", left, top, plot_width, plot_height);
+    fprintf(s_out, "<text x=\"%d\" y=\"%d\" class=\"label\" text-anchor=\"middle\">cycles (bucket low edge)</text>\n", left + plot_width / 2, height - 6);
+    fprintf(s_out, "<text x=\"14\" y=\"%d\" class=\"label\" text-anchor=\"middle\" transform=\"rotate(-90 14 %d)\">count</text>\n", top + plot_height / 2, top + plot_height / 2);
+    fprintf(s_out, "</svg>\n");
+
+    #undef HIST_Y
+}
+
+//  Blue (low) through yellow to red (high)
+static void heat_colour(double t, char *text, size_t size)
+{
+    static const int stops[3][3] = { { 49, 130, 189 }, { 255, 221, 87 }, { 215, 48, 39 } };
+    int c[3];
+
+    t = (t < 0.0) ? 0.0 : (t > 1.0) ? 1.0 : t;
+    int low = (t < 0.5) ? 0 : 1;
+    double blend = (t - 0.5 * low) * 2.0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        c[i] = (int)(stops[low][i] + blend * (stops[low + 1][i] - stops[low][i]) + 0.5);
+    }
+    snprintf(text, size, "#%02x%02x%02x", c[0], c[1], c[2]);
+}
+
+static void svg_heatmap(const char *type, const char *key)
+{
+    double rows = 0, columns = 0, low = INFINITY, high = -INFINITY;
+
+    for (int i = 0; i < s_record_count; i++)
+    {
+        const report_record *record = &s_records[i];
+        double row, column, value;
+
+        if ((strcmp(record->schema->type, type) == 0) && record_number(record, "row", &row) &&
+            record_number(record, "column", &column) && record_number(record, key, &value))
+        {
+            rows = (row + 1 > rows) ? row + 1 : rows;
+            columns = (column + 1 > columns) ? column + 1 : columns;
+            low = (value < low) ? value : low;
+            high = (value > high) ? value : high;
+        }
+    }
+    if ((rows == 0) || (columns == 0))
+    {
+        return;
+    }
+    if (columns > REPORT_COLUMNS_MAX)
+    {
+        columns = REPORT_COLUMNS_MAX;
+    }
+
+    const int left = 50, top = 30, legend = 40;
+    int width = left + (int)columns * REPORT_CELL + 20;
+    int height = top + (int)rows * REPORT_CELL + legend;
+    char colour[16];
+
+    fprintf(s_out, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">\n", width, height, width, height);
+    fprintf(s_out, "<text x=\"%d\" y=\"18\" class=\"title\">", left);
+    html_text(type);
+    fprintf(s_out, " ");
+    html_text(key);
+    fprintf(s_out, " by row and column</text>\n");
+
+    for (int i = 0; i < s_record_count; i++)
+    {
+        const report_record *record = &s_records[i];
+        double row, column, value;
+
+        if ((strcmp(record->schema->type, type) == 0) && record_number(record, "row", &row) &&
+            record_number(record, "column", &column) && record_number(record, key, &value) && (column < columns))
+        {
+            heat_colour((high > low) ? (value - low) / (high - low) : 0.5, colour, sizeof(colour));
+            fprintf(s_out, "<rect x=\"%.0f\" y=\"%.0f\" width=\"%d\" height=\"%d\" fill=\"%s\"><title>row %.0f, column %.0f, %.4g</title></rect>\n",
+                    left + column * REPORT_CELL, top + row * REPORT_CELL, REPORT_CELL, REPORT_CELL, colour, row, column, value);
+        }
+    }
+    for (int row = 0; row < (int)rows; row += ((int)rows + 7) / 8)
+    {
+        fprintf(s_out, "<text x=\"%d\" y=\"%d\" class=\"tick\" text-anchor=\"end\">%d</text>\n", left - 4, top + row * REPORT_CELL + REPORT_CELL - 2, row);
+    }
+
+    //  Scale
+    int legend_y = top + (int)rows * REPORT_CELL + 12;
+    for (int step = 0; step < 10; step++)
+    {
+        heat_colour(step / 9.0, colour, sizeof(colour));
+        fprintf(s_out, "<rect x=\"%d\" y=\"%d\" width=\"16\" height=\"10\" fill=\"%s\"/>", left + 60 + step * 16, legend_y, colour);
+    }
+    fprintf(s_out, "\n<text x=\"%d\" y=\"%d\" class=\"tick\" text-anchor=\"end\">%.4g</text>", left + 56, legend_y + 9, low);
+    fprintf(s_out, "<text x=\"%d\" y=\"%d\" class=\"tick\">%.4g</text>\n", left + 64 + 160, legend_y + 9, high);
+    fprintf(s_out, "</svg>\n");
+}
+
+//  Every record of a type as a table, columns from the first one
+static void html_table(const char *type)
+{
+    const report_schema *schema = NULL;
+    int rows = 0, total = 0;
+
+    for (int i = 0; i < s_record_count; i++)
+    {
+        if (strcmp(s_records[i].schema->type, type) == 0)
+        {
+            schema = (schema == NULL) ? s_records[i].schema : schema;
+            total++;
+        }
+    }
+    if (schema == NULL)
+    {
+        return;
+    }
+
+    fprintf(s_out, "<table>\n<tr>");
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        fprintf(s_out, "<th>");
+        html_text(schema->field_keys[f]);
+        fprintf(s_out, "</th>");
+    }
+    fprintf(s_out, "</tr>\n");
+
+    for (int i = 0; (i < s_record_count) && (rows < REPORT_TABLE_ROWS); i++)
+    {
+        const report_record *record = &s_records[i];
+        if (strcmp(record->schema->type, type) != 0)
+        {
+            continue;
+        }
+
+        fprintf(s_out, "<tr>");
+        for (int f = 0; f < schema->field_count; f++)
+        {
+            const report_value *value = record_field(record, schema->field_keys[f]);
+            fprintf(s_out, (value != NULL) && (value->type != RESULT_TYPE_STR) ? "<td class=\"n\">" : "<td>");
+            if (value != NULL)
+            {
+                html_value(value);
+            }
+            fprintf(s_out, "</td>");
+        }
+        fprintf(s_out, "</tr>\n");
+        rows++;
+    }
+    fprintf(s_out, "</table>\n");
+    if (total > rows)
+    {
+        fprintf(s_out, "<p class=\"note\">First %d of %d records.</p>\n", rows, total);
+    }
+}
+
+//  Header records as key / value, the QMI timing fields follow on as key=value
+static void report_header(void)
+{
+    bool any = false;
+
+    for (int i = 0; i < s_record_count; i++)
+    {
+        const report_record *record = &s_records[i];
+        const char *key = record_text(record, "key");
+
+        if ((strcmp(record->schema->type, "Header") != 0) || (key == NULL))
+        {
+            continue;
+        }
+        if (!any)
+        {
+            fprintf(s_out, "<h2>Run header</h2>\n<table>\n<tr><th>key</th><th>value</th></tr>\n");
+            any = true;
+        }
+
+        fprintf(s_out, "<tr><td>");
+        html_text(key);
+        fprintf(s_out, "</td><td>");
+        for (int f = 0; f < record->schema->field_count; f++)
+        {
+            const char *field = record->schema->field_keys[f];
+            if (strcmp(field, "key") == 0)
+            {
+                continue;
+            }
+            if (strcmp(field, "value") != 0)
+            {
+                html_text(field);
+                fprintf(s_out, "=");
+            }
+            html_value(&record->values[f]);
+            fprintf(s_out, " ");
+        }
+        fprintf(s_out, "</td></tr>\n");
+    }
+    if (any)
+    {
+        fprintf(s_out, "</table>\n");
+    }
+}
+
+//  Mean of the metric per size, per test, for tests run at more than one size
+static void report_sweeps(const char *type)
+{
+    static report_series series[REPORT_MAX_SERIES];
+    int series_count = 0;
+
+    for (int i = 0; i < s_record_count; i++)
+    {
+        const report_record *record = &s_records[i];
+        const char *test = record_text(record, "test");
+        double size, value;
+
+        if ((strcmp(record->schema->type, type) != 0) || (test == NULL) || !record_number(record, "size", &size) || (size <= 0) ||
+            (!record_number(record, "corrected", &value) && !record_number(record, "result", &value)))
+        {
+            continue;
+        }
+
+        int s;
+        for (s = 0; (s < series_count) && (strcmp(series[s].name, test) != 0); s++)
+        {
+        }
+        if (s == series_count)
+        {
+            if (series_count == REPORT_MAX_SERIES)
+            {
+                continue;
+            }
+            memset(&series[s], 0, sizeof(report_series));
+            series[s].name = test;
+            series_count++;
+        }
+
+        //  Reps are summed here and averaged below
+        report_series *one = &series[s];
+        int p;
+        for (p = 0; (p < one->count) && (one->x[p] != size); p++)
+        {
+        }
+        if (p == one->count)
+        {
+            one->x = realloc(one->x, (p + 1) * sizeof(double));
+            one->y = realloc(one->y, (p + 1) * sizeof(double));
+            one->samples = realloc(one->samples, (p + 1) * sizeof(int));
+            one->x[p] = size;
+            one->y[p] = 0.0;
+            one->samples[p] = 0;
+            one->count++;
+        }
+        one->y[p] += value / size;
+        one->samples[p]++;
+    }
+
+    //  Only the sweeps, in size order
+    int kept = 0;
+    for (int s = 0; s < series_count; s++)
+    {
+        report_series *one = &series[s];
+
+        for (int p = 0; p < one->count; p++)
+        {
+            one->y[p] /= one->samples[p];
+        }
+        for (int a = 1; a < one->count; a++)
+        {
+            for (int b = a; (b > 0) && (one->x[b - 1] > one->x[b]); b--)
+            {
+                double x = one->x[b], y = one->y[b];
+                one->x[b] = one->x[b - 1];
+                one->y[b] = one->y[b - 1];
+                one->x[b - 1] = x;
+                one->y[b - 1] = y;
+            }
+        }
+        if (one->count > 1)
+        {
+            series[kept++] = *one;
+        }
+        else
+        {
+            free(one->x);
+            free(one->y);
+            free(one->samples);
+        }
+    }
+
+    if (kept != 0)
+    {
+        char title[64];
+        snprintf(title, sizeof(title), "%s working set sweep", type);
+        fprintf(s_out, "<h2>");
+        html_text(title);
+        fprintf(s_out, "</h2>\n<p class=\"note\">Cycles for the whole test divided by its size, so the loop count is folded in; compare the shape, not tests with each other.</p>\n");
+
+        //  Too many lines to read on one chart, split them
+        for (int first = 0; first < kept; first += REPORT_COLOURS)
+        {
+            int count = ((kept - first) < (int)REPORT_COLOURS) ? kept - first : (int)REPORT_COLOURS;
+            svg_line_chart(title, "size", "cycles / size", &series[first], count, true);
+        }
+    }
+
+    for (int s = 0; s < kept; s++)
+    {
+        free(series[s].x);
+        free(series[s].y);
+        free(series[s].samples);
+    }
+}
+
+static void report_latency(void)
+{
+    const char *done[REPORT_MAX_SERIES];
+    int done_count = 0;
+    bool any = false;
+
+    for (int i = 0; i < s_record_count; i++)
+    {
+        const char *test = record_text(&s_records[i], "test");
+
+        if ((strcmp(s_records[i].schema->type, "Latency bucket") != 0) || (test == NULL))
+        {
+            continue;
+        }
+
+        int d;
+        for (d = 0; (d < done_count) && (strcmp(done[d], test) != 0); d++)
+        {
+        }
+        if ((d != done_count) || (done_count == REPORT_MAX_SERIES))
+        {
+            continue;
+        }
+        done[done_count++] = test;
+
+        if (!any)
+        {
+            fprintf(s_out, "<h2>Latency</h2>\n");
+            html_table("Latency");
+            any = true;
+        }
+
+        //  The last histogram for the test, earlier ones are earlier runs
+        int bins = 0, capacity = 0;
+        double *low = NULL, *high = NULL, *count = NULL;
+        for (int j = i; j < s_record_count; j++)
+        {
+            const report_record *record = &s_records[j];
+            const char *name = record_text(record, "test");
+            double l, h, c;
+
+            if ((strcmp(record->schema->type, "Latency bucket") != 0) || (name == NULL) || (strcmp(name, test) != 0) ||
+                !record_number(record, "low", &l) || !record_number(record, "high", &h) || !record_number(record, "count", &c))
+            {
+                continue;
+            }
+            if ((bins != 0) && (l <= low[bins - 1]))
+            {
+                bins = 0;
+            }
+            if (bins == capacity)
+            {
+                capacity = capacity ? capacity * 2 : 64;
+                low = realloc(low, capacity * sizeof(double));
+                high = realloc(high, capacity * sizeof(double));
+                count = realloc(count, capacity * sizeof(double));
+            }
+            low[bins] = l;
+            high[bins] = h;
+            count[bins] = c;
+            bins++;
+        }
+
+        svg_histogram(test, low, high, count, bins);
+        free(low);
+        free(high);
+        free(count);
+    }
+
+    if (!any)
+    {
+        for (int i = 0; i < s_record_count; i++)
+        {
+            if (strcmp(s_records[i].schema->type, "Latency") == 0)
+            {
+                fprintf(s_out, "<h2>Latency</h2>\n");
+                html_table("Latency");
+                break;
+            }
+        }
+    }
+}
+
+static bool type_has_grid(const char *type)
+{
+    for (int i = 0; i < s_schema_count; i++)
+    {
+        const report_schema *schema = s_schemas[i];
+        bool row = false, column = false;
+
+        if (strcmp(schema->type, type) != 0)
+        {
+            continue;
+        }
+        for (int f = 0; f < schema->field_count; f++)
+        {
+            row |= (strcmp(schema->field_keys[f], "row") == 0);
+            column |= (strcmp(schema->field_keys[f], "column") == 0);
+        }
+        if (row && column)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//  A heatmap for every measured field, the position fields aren't measurements
+static void report_grid(const char *type)
+{
+    static const char * const position[] = { "row", "column", "offset", "address", "attempt" };
+    const report_schema *schema = NULL;
+
+    for (int i = 0; (i < s_schema_count) && (schema == NULL); i++)
+    {
+        if (strcmp(s_schemas[i]->type, type) == 0)
+        {
+            schema = s_schemas[i];
+        }
+    }
+
+    fprintf(s_out, "<h2>");
+    html_text(type);
+    fprintf(s_out, "</h2>\n");
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        bool skip = (schema->field_types[f] == RESULT_TYPE_STR) || (schema->field_types[f] == RESULT_TYPE_HEX);
+        for (size_t p = 0; !skip && (p < sizeof(position) / sizeof(position[0])); p++)
+        {
+            skip = (strcmp(schema->field_keys[f], position[p]) == 0);
+        }
+        if (!skip)
+        {
+            svg_heatmap(type, schema->field_keys[f]);
+        }
+    }
+    html_table(type);
+}
+
+static void report_write(const char *title, char **paths, int path_count)
+{
+    const char *types[REPORT_MAX_TYPES];
+    int type_count = 0;
+
+    for (int i = 0; (i < s_schema_count) && (type_count < REPORT_MAX_TYPES); i++)
+    {
+        int t;
+        for (t = 0; (t < type_count) && (strcmp(types[t], s_schemas[i]->type) != 0); t++)
+        {
+        }
+        if (t == type_count)
+        {
+            types[type_count++] = s_schemas[i]->type;
+        }
+    }
+
+    fprintf(s_out, "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>");
+    html_text(title);
+    fprintf(s_out, "</title>\n<style>\n"
+                   "body { font-family: sans-serif; margin: 2em; color: #222; }\n"
+                   "table { border-collapse: collapse; margin: 1em 0; font-size: 13px; }\n"
+                   "th, td { border: 1px solid #ccc; padding: 2px 8px; text-align: left; }\n"
+                   "th { background: #eee; }\n"
+                   "td.n { text-align: right; font-family: monospace; }\n"
+                   "svg { display: block; margin: 1em 0; }\n"
+                   "svg text { font-family: sans-serif; }\n"
+                   ".title { font-size: 14px; font-weight: bold; }\n"
+                   ".tick { font-size: 11px; fill: #444; }\n"
+                   ".label { font-size: 12px; }\n"
+                   ".grid { stroke: #e4e4e4; }\n"
+                   ".frame { fill: none; stroke: #888; }\n"
+                   ".note { color: #666; font-size: 13px; }\n"
+                   "</style>\n</head>\n<body>\n<h1>");
+    html_text(title);
+    fprintf(s_out, "</h1>\n<p class=\"note\">%d records from", s_record_count);
+    for (int i = 0; i < path_count; i++)
+    {
+        fprintf(s_out, " ");
+        html_text(paths[i]);
+    }
+    fprintf(s_out, "</p>\n");
+
+    report_header();
+
+    for (int t = 0; t < type_count; t++)
+    {
+        const char *type = types[t];
+
+        if ((strcmp(type, "Header") == 0) || (strcmp(type, "Latency") == 0) || (strcmp(type, "Latency bucket") == 0))
+        {
+            continue;
+        }
+        if (strcmp(type, "Test") == 0 || strcmp(type, "Plan") == 0)
+        {
+            report_sweeps(type);
+            fprintf(s_out, "<h2>");
+            html_text(type);
+            fprintf(s_out, " results</h2>\n");
+            html_table(type);
+        }
+        else if (type_has_grid(type))
+        {
+            report_grid(type);
+        }
+        else
+        {
+            fprintf(s_out, "<h2>");
+            html_text(type);
+            fprintf(s_out, "</h2>\n");
+            html_table(type);
+        }
+    }
+
+    report_latency();
+
+    fprintf(s_out, "</body>\n</html>\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *title = "PicoMemPerf report";
+    const char *out_path = NULL;
+    char *paths[64];
+    int path_count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--title=", 8) == 0)
+        {
+            title = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--out=", 6) == 0)
+        {
+            out_path = argv[i] + 6;
+        }
+        else if ((argv[i][0] != '-') && (path_count < (int)(sizeof(paths) / sizeof(paths[0]))))
+        {
+            paths[path_count++] = argv[i];
+        }
+        else
+        {
+            path_count = 0;
+            break;
+        }
+    }
+
+    if (path_count == 0)
+    {
+        fprintf(stderr, "usage: result_report [--title=text] [--out=report.html] capture...\n");
+        return 2;
+    }
+
+    for (int i = 0; i < path_count; i++)
+    {
+        if (!report_load(paths[i]))
+        {
+            return 1;
+        }
+    }
+    if (s_record_count == 0)
+    {
+        fprintf(stderr, "no records, CSV logs can't be read, capture with \"format json\" or \"format binary\"\n");
+        return 1;
+    }
+
+    s_out = stdout;
+    if ((out_path != NULL) && ((s_out = fopen(out_path, "w")) == NULL))
+    {
+        fprintf(stderr, "%s: can't open\n", out_path);
+        return 1;
+    }
+
+    report_write(title, paths, path_count);
+
+    if (s_out != stdout)
+    {
+        fclose(s_out);
+    }
+    fprintf(stderr, "records, %d, types, %d, skipped, %llu\n", s_record_count, s_schema_count, (unsigned long long)s_skipped);
+    return 0;
+}
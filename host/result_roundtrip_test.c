@@ -0,0 +1,446 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Result encoder / decoder round trips
+//
+//  A set of records with awkward values (commas, quotes, control characters,
+//  the extremes of every integer type, fractional floats, NaN) is encoded
+//  with result_out and decoded back field by field:
+//
+//      binary, fed a byte at a time with text between the frames
+//      binary, one bad checksum, which only loses that frame
+//      binary, joined late, records before a schema are counted not guessed
+//      JSON Lines, parsed back and compared with the decoder's own JSON
+//      the binary log copy while the output is CSV
+//
+//  Exits non-zero at the first failure.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_out.h"
+#include "result_decode.h"
+
+#define CAPTURE_SIZE    (64 * 1024)
+#define TEST_FIELDS     6
+
+typedef struct
+{
+    const char *key;
+    uint8_t type;
+    uint64_t u;
+    int64_t i;
+    float f;
+    const char *s;
+} test_field;
+
+typedef struct
+{
+    const char *type;
+    int field_count;
+    test_field fields[TEST_FIELDS];
+} test_record;
+
+static const test_record s_records[] =
+{
+    { "Test", 4, {
+        { "test", RESULT_TYPE_STR, .s = "SEQ PSRAM READ" },
+        { "address", RESULT_TYPE_HEX, .u = 0x11000000 },
+        { "result", RESULT_TYPE_U64, .u = 123456 },
+        { "overhead", RESULT_TYPE_U64, .u = 0 } } },
+    { "Test", 4, {
+        { "test", RESULT_TYPE_STR, .s = "name, with \"quotes\", \\ and \ttab" },
+        { "address", RESULT_TYPE_HEX, .u = 0xFFFFFFFF },
+        { "result", RESULT_TYPE_U64, .u = UINT64_MAX },
+        { "overhead", RESULT_TYPE_U64, .u = 1ull << 63 } } },
+    { "Signed", 3, {
+        { "min", RESULT_TYPE_I64, .i = INT64_MIN },
+        { "max", RESULT_TYPE_I64, .i = INT64_MAX },
+        { "minus_one", RESULT_TYPE_I64, .i = -1 } } },
+    { "Floats", 5, {
+        { "third", RESULT_TYPE_F32, .f = 0.333333f },
+        { "small", RESULT_TYPE_F32, .f = 1.5e-9f },
+        { "large", RESULT_TYPE_F32, .f = -2.75e12f },
+        { "nan", RESULT_TYPE_F32, .f = NAN },
+        { "empty", RESULT_TYPE_STR, .s = "" } } },
+    { "Signed", 3, {
+        { "min", RESULT_TYPE_I64, .i = 0 },
+        { "max", RESULT_TYPE_I64, .i = 300 },
+        { "minus_one", RESULT_TYPE_I64, .i = -300 } } },
+    { "Control", 1, {
+        { "text", RESULT_TYPE_STR, .s = "line\nbreak\x01\x7F end" } } },
+};
+
+#define RECORD_COUNT    ((int)(sizeof(s_records) / sizeof(s_records[0])))
+
+static uint8_t s_capture[CAPTURE_SIZE];
+static size_t s_capture_used;
+static uint8_t s_log_capture[CAPTURE_SIZE];
+static size_t s_log_used;
+
+static int s_failures;
+static int s_decoded;
+static int s_texts;
+static char s_last_text[256];
+
+#define FAIL(...)                               \
+    do                                          \
+    {                                           \
+        printf("FAIL, " __VA_ARGS__);           \
+        printf("\n");                           \
+        s_failures++;                           \
+    } while (0)
+
+static void capture_writer(const void *data, size_t length)
+{
+    if (s_capture_used + length <= CAPTURE_SIZE)
+    {
+        memcpy(s_capture + s_capture_used, data, length);
+        s_capture_used += length;
+    }
+}
+
+static void log_writer(const void *data, size_t length)
+{
+    if (s_log_used + length <= CAPTURE_SIZE)
+    {
+        memcpy(s_log_capture + s_log_used, data, length);
+        s_log_used += length;
+    }
+}
+
+static void emit(const test_record *test)
+{
+    result_record record;
+
+    result_begin(&record, test->type);
+    for (int f = 0; f < test->field_count; f++)
+    {
+        const test_field *field = &test->fields[f];
+        switch (field->type)
+        {
+            case RESULT_TYPE_STR:   result_str(&record, field->key, field->s); break;
+            case RESULT_TYPE_U64:   result_u64(&record, field->key, field->u); break;
+            case RESULT_TYPE_I64:   result_i64(&record, field->key, field->i); break;
+            case RESULT_TYPE_HEX:   result_hex(&record, field->key, (uint32_t)field->u); break;
+            default:                result_f32(&record, field->key, field->f); break;
+        }
+    }
+    result_end(&record);
+}
+
+static void emit_all(void)
+{
+    for (int i = 0; i < RECORD_COUNT; i++)
+    {
+        emit(&s_records[i]);
+    }
+}
+
+//  exact for binary, JSON only carries floats to 6 digits
+static bool float_matches(float expected, float actual, bool exact)
+{
+    if (isnan(expected))
+    {
+        return isnan(actual);
+    }
+    if (exact)
+    {
+        return memcmp(&expected, &actual, sizeof(float)) == 0;
+    }
+    return fabsf(actual - expected) <= fabsf(expected) * 1e-5f;
+}
+
+static void compare(const char *what, const test_record *test, const result_decoded *record, bool exact)
+{
+    const result_decoded_schema *schema = record->schema;
+
+    if (strcmp(schema->type, test->type) != 0)
+    {
+        FAIL("%s, type %s, expected %s", what, schema->type, test->type);
+        return;
+    }
+    if (schema->field_count != test->field_count)
+    {
+        FAIL("%s, %s, %d fields, expected %d", what, test->type, schema->field_count, test->field_count);
+        return;
+    }
+
+    for (int f = 0; f < test->field_count; f++)
+    {
+        const test_field *field = &test->fields[f];
+        const result_value *value = &record->values[f];
+        bool same;
+
+        if (strcmp(schema->field_keys[f], field->key) != 0)
+        {
+            FAIL("%s, %s, field %d is %s, expected %s", what, test->type, f, schema->field_keys[f], field->key);
+            continue;
+        }
+
+        //  JSON can't tell a string from a field's type, a non-negative I64 comes back as U64
+        switch (field->type)
+        {
+            case RESULT_TYPE_STR:
+                same = (value->type == RESULT_TYPE_STR) && (strcmp(value->s, field->s) == 0);
+                break;
+            case RESULT_TYPE_U64:
+            case RESULT_TYPE_HEX:
+                same = (value->type == field->type) && (value->u == field->u);
+                break;
+            case RESULT_TYPE_I64:
+                same = ((value->type == RESULT_TYPE_I64) && (value->i == field->i)) ||
+                       (!exact && (field->i >= 0) && (value->type == RESULT_TYPE_U64) && (value->u == (uint64_t)field->i));
+                break;
+            default:
+                same = (value->type == RESULT_TYPE_F32) && float_matches(field->f, value->f, exact);
+                break;
+        }
+        if (!same)
+        {
+            FAIL("%s, %s, field %s differs", what, test->type, field->key);
+        }
+    }
+}
+
+static void on_record(void *context, const result_decoded *record)
+{
+    int *next = (int *)context;
+
+    if (*next < RECORD_COUNT)
+    {
+        compare("binary", &s_records[*next], record, true);
+    }
+    (*next)++;
+    s_decoded++;
+}
+
+static void on_text(void *context, const char *line)
+{
+    s_texts++;
+    snprintf(s_last_text, sizeof(s_last_text), "%s", line);
+}
+
+static void capture_reset(void)
+{
+    s_capture_used = 0;
+    s_decoded = 0;
+    s_texts = 0;
+    s_last_text[0] = 0;
+}
+
+//  Byte at a time, with text either side of every frame
+static void test_binary(void)
+{
+    static result_decoder decoder;
+    int next = 0;
+
+    capture_reset();
+    result_set_format(RESULT_FORMAT_BINARY);
+    capture_writer("booting\r\n", 9);
+    for (int i = 0; i < RECORD_COUNT; i++)
+    {
+        emit(&s_records[i]);
+        capture_writer("between\n", 8);
+    }
+
+    result_decoder_init(&decoder, on_record, on_text, &next);
+    for (size_t i = 0; i < s_capture_used; i++)
+    {
+        result_decoder_feed(&decoder, &s_capture[i], 1);
+    }
+    result_decoder_finish(&decoder);
+
+    if ((s_decoded != RECORD_COUNT) || (decoder.bad_frames != 0) || (decoder.unknown_schema != 0))
+    {
+        FAIL("binary, %d records, %llu bad, %llu unknown", s_decoded, (unsigned long long)decoder.bad_frames, (unsigned long long)decoder.unknown_schema);
+    }
+    if ((s_texts != RECORD_COUNT + 1) || (strcmp(s_last_text, "between") != 0))
+    {
+        FAIL("binary, text between frames, %d lines, last \"%s\"", s_texts, s_last_text);
+    }
+}
+
+//  A bad checksum loses that record and nothing else
+static void test_corrupt(void)
+{
+    static result_decoder decoder;
+    int next = 0;
+    size_t starts[RECORD_COUNT + 1];
+
+    capture_reset();
+    result_set_format(RESULT_FORMAT_BINARY);
+    for (int i = 0; i < RECORD_COUNT; i++)
+    {
+        starts[i] = s_capture_used;
+        emit(&s_records[i]);
+    }
+    starts[RECORD_COUNT] = s_capture_used;
+
+    //  Last byte of the last record's frame is its checksum
+    s_capture[starts[RECORD_COUNT] - 1] ^= 0x55;
+
+    result_decoder_init(&decoder, on_record, NULL, &next);
+    result_decoder_feed(&decoder, s_capture, s_capture_used);
+    result_decoder_finish(&decoder);
+
+    if ((s_decoded != RECORD_COUNT - 1) || (decoder.bad_frames != 1))
+    {
+        FAIL("corrupt, %d records, %llu bad frames", s_decoded, (unsigned long long)decoder.bad_frames);
+    }
+}
+
+//  Reader joins after the schemas went past, then the sender resends them
+static void test_late_join(void)
+{
+    static result_decoder decoder;
+    int next = 0;
+
+    result_set_format(RESULT_FORMAT_BINARY);
+    capture_reset();
+    emit_all();
+    capture_reset();
+    emit_all();
+
+    result_decoder_init(&decoder, on_record, NULL, &next);
+    result_decoder_feed(&decoder, s_capture, s_capture_used);
+    if ((s_decoded != 0) || (decoder.unknown_schema != RECORD_COUNT))
+    {
+        FAIL("late join, %d decoded, %llu unknown", s_decoded, (unsigned long long)decoder.unknown_schema);
+    }
+
+    capture_reset();
+    result_reset_schemas();
+    emit_all();
+    result_decoder_feed(&decoder, s_capture, s_capture_used);
+    if (s_decoded != RECORD_COUNT)
+    {
+        FAIL("late join, %d decoded after the schemas were resent", s_decoded);
+    }
+}
+
+static void on_record_json(void *context, const result_decoded *record)
+{
+    char **line = (char **)context;
+    char json[2048];
+    size_t length = result_decoded_json(record, json, sizeof(json));
+    size_t expected = strcspn(*line, "\n") + 1;
+
+    if ((length != expected) || (strncmp(json, *line, length) != 0))
+    {
+        FAIL("json, decoder and encoder disagree\n  %.*s  %s", (int)expected, *line, json);
+    }
+    *line += expected;
+}
+
+//  JSON Lines parsed back, and the binary decoder's JSON is the same text
+static void test_json(void)
+{
+    static char json[CAPTURE_SIZE];
+    static uint8_t binary[CAPTURE_SIZE];
+    static result_decoder decoder;
+
+    capture_reset();
+    result_set_format(RESULT_FORMAT_JSON);
+    emit_all();
+    memcpy(json, s_capture, s_capture_used);
+    json[s_capture_used] = 0;
+
+    char *line = json;
+    for (int i = 0; i < RECORD_COUNT; i++)
+    {
+        result_decoded_schema schema;
+        result_decoded record;
+        char *end = strchr(line, '\n');
+
+        if (end == NULL)
+        {
+            FAIL("json, %d lines, expected %d", i, RECORD_COUNT);
+            return;
+        }
+        *end = 0;
+        if (!result_json_parse(line, &schema, &record))
+        {
+            FAIL("json, can't parse %s", line);
+        }
+        else
+        {
+            compare("json", &s_records[i], &record, false);
+        }
+        *end = '\n';
+        line = end + 1;
+    }
+
+    capture_reset();
+    result_set_format(RESULT_FORMAT_BINARY);
+    emit_all();
+    memcpy(binary, s_capture, s_capture_used);
+
+    line = json;
+    result_decoder_init(&decoder, on_record_json, NULL, &line);
+    result_decoder_feed(&decoder, binary, s_capture_used);
+}
+
+//  The log copy is binary whatever the output format
+static void test_log_copy(void)
+{
+    static result_decoder decoder;
+    int next = 0;
+
+    capture_reset();
+    s_log_used = 0;
+    result_set_format(RESULT_FORMAT_CSV);
+    result_set_log(log_writer);
+    emit_all();
+    result_set_log(NULL);
+
+    if ((s_capture_used == 0) || (s_capture[0] == RESULT_FRAME_MAGIC))
+    {
+        FAIL("log copy, the output isn't CSV");
+    }
+
+    result_decoder_init(&decoder, on_record, NULL, &next);
+    result_decoder_feed(&decoder, s_log_capture, s_log_used);
+    if ((s_decoded != RECORD_COUNT) || (decoder.bad_frames != 0))
+    {
+        FAIL("log copy, %d records, %llu bad frames", s_decoded, (unsigned long long)decoder.bad_frames);
+    }
+}
+
+int main(void)
+{
+    result_set_writer(capture_writer);
+
+    test_binary();
+    test_corrupt();
+    test_late_join();
+    test_json();
+    test_log_copy();
+
+    result_set_writer(NULL);
+    printf("result_roundtrip_test, %s, failures, %d\n", (s_failures == 0) ? "pass" : "fail", s_failures);
+    return (s_failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,475 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_decode.h"
+#include "result_set.h"
+
+#define RESULT_SET_MAX_COLUMNS  (RESULT_MAX_FIELDS + 2)
+
+typedef struct
+{
+    result_set *set;
+    int column_count;                   //  serial_driver heading row, 0 for firmware lines
+    char columns[RESULT_SET_MAX_COLUMNS][RESULT_MAX_STRING + 1];
+} result_loader;
+
+void result_set_init(result_set *set, result_metric metric)
+{
+    memset(set, 0, sizeof(result_set));
+    set->metric = metric;
+}
+
+void result_set_free(result_set *set)
+{
+    for (int i = 0; i < set->count; i++)
+    {
+        free(set->series[i].samples);
+    }
+    free(set->series);
+    result_set_init(set, set->metric);
+}
+
+const result_series *result_set_find(const result_set *set, const char *type, const char *test, uint32_t size)
+{
+    for (int i = 0; i < set->count; i++)
+    {
+        const result_series *series = &set->series[i];
+        if ((series->size == size) && (strcmp(series->test, test) == 0) && (strcmp(series->type, type) == 0))
+        {
+            return series;
+        }
+    }
+    return NULL;
+}
+
+void result_set_add(result_set *set, const char *type, const char *test, uint32_t size, double value)
+{
+    result_series *series = (result_series *)result_set_find(set, type, test, size);
+
+    if (series == NULL)
+    {
+        if (set->count == set->capacity)
+        {
+            int capacity = set->capacity ? set->capacity * 2 : 64;
+            result_series *grown = realloc(set->series, capacity * sizeof(result_series));
+            if (grown == NULL)
+            {
+                return;
+            }
+            set->series = grown;
+            set->capacity = capacity;
+        }
+        series = &set->series[set->count++];
+        memset(series, 0, sizeof(result_series));
+        snprintf(series->type, sizeof(series->type), "%s", type);
+        snprintf(series->test, sizeof(series->test), "%s", test);
+        series->size = size;
+    }
+
+    if (series->count == series->capacity)
+    {
+        int capacity = series->capacity ? series->capacity * 2 : 4;
+        double *grown = realloc(series->samples, capacity * sizeof(double));
+        if (grown == NULL)
+        {
+            return;
+        }
+        series->samples = grown;
+        series->capacity = capacity;
+    }
+    series->samples[series->count++] = value;
+    set->samples++;
+}
+
+static bool parse_number(const char *text, double *value)
+{
+    char *end;
+
+    if (*text == 0)
+    {
+        return false;
+    }
+    *value = strtod(text, &end);
+    return *end == 0;
+}
+
+//  Comma separated with RFC 4180 quotes, fields are split in place and the
+//  space after each comma dropped
+static int split_csv(char *line, char **fields, int max_fields)
+{
+    int count = 0;
+    char *in = line;
+
+    while ((*in != 0) && (count < max_fields))
+    {
+        char *out = in;
+
+        while (*in == ' ')
+        {
+            in++;
+        }
+        fields[count++] = out;
+
+        if (*in == '"')
+        {
+            in++;
+            while (*in != 0)
+            {
+                if ((in[0] == '"') && (in[1] == '"'))
+                {
+                    *out++ = '"';
+                    in += 2;
+                }
+                else if (*in == '"')
+                {
+                    in++;
+                    break;
+                }
+                else
+                {
+                    *out++ = *in++;
+                }
+            }
+            while ((*in != 0) && (*in != ','))
+            {
+                in++;
+            }
+        }
+        else
+        {
+            while ((*in != 0) && (*in != ','))
+            {
+                *out++ = *in++;
+            }
+        }
+
+        bool more = (*in == ',');
+        if (more)
+        {
+            in++;
+        }
+        *out = 0;
+        if (more && (*in == 0) && (count < max_fields))
+        {
+            fields[count++] = in;
+        }
+    }
+
+    return count;
+}
+
+//  Value of "key" in one of our own JSON lines, strings unescaped
+static bool json_field(const char *line, const char *key, char *value, size_t size)
+{
+    char pattern[RESULT_MAX_STRING + 4];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+
+    const char *at = strstr(line, pattern);
+    if (at == NULL)
+    {
+        return false;
+    }
+    at += strlen(pattern);
+
+    size_t used = 0;
+    if (*at == '"')
+    {
+        for (at++; (*at != 0) && (*at != '"') && (used < size - 1); at++)
+        {
+            if ((*at == '\\') && (at[1] != 0))
+            {
+                at++;
+            }
+            value[used++] = *at;
+        }
+    }
+    else
+    {
+        for (; (*at != 0) && (*at != ',') && (*at != '}') && (used < size - 1); at++)
+        {
+            value[used++] = *at;
+        }
+    }
+    value[used] = 0;
+    return true;
+}
+
+static const char *metric_key(const result_set *set)
+{
+    return (set->metric == RESULT_METRIC_CORRECTED) ? "corrected" : "result";
+}
+
+static void load_json(result_loader *loader, const char *line)
+{
+    char type[16], test[RESULT_MAX_STRING + 1], size_text[32], metric_text[32];
+    double size, value;
+
+    if (json_field(line, "type", type, sizeof(type)) && ((strcmp(type, "Test") == 0) || (strcmp(type, "Plan") == 0)) &&
+        json_field(line, "test", test, sizeof(test)) &&
+        json_field(line, "size", size_text, sizeof(size_text)) && parse_number(size_text, &size) &&
+        json_field(line, metric_key(loader->set), metric_text, sizeof(metric_text)) && parse_number(metric_text, &value))
+    {
+        result_set_add(loader->set, type, test, (uint32_t)size, value);
+    }
+}
+
+static int column_index(const result_loader *loader, const char *name)
+{
+    for (int i = 0; i < loader->column_count; i++)
+    {
+        if (strcmp(loader->columns[i], name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void load_csv(result_loader *loader, char *line)
+{
+    char *fields[RESULT_SET_MAX_COLUMNS + RESULT_MAX_FIELDS];
+    int count = split_csv(line, fields, sizeof(fields) / sizeof(fields[0]));
+    double size, value;
+
+    if (count < 2)
+    {
+        return;
+    }
+
+    //  serial_driver files, a heading row then rows
+    if ((strcmp(fields[0], "run") == 0) && (strcmp(fields[1], "attempt") == 0))
+    {
+        loader->column_count = (count < RESULT_SET_MAX_COLUMNS) ? count : RESULT_SET_MAX_COLUMNS;
+        for (int i = 0; i < loader->column_count; i++)
+        {
+            snprintf(loader->columns[i], sizeof(loader->columns[i]), "%s", fields[i]);
+        }
+        return;
+    }
+    if (loader->column_count != 0)
+    {
+        int test = column_index(loader, "test");
+        int size_column = column_index(loader, "size");
+        int metric = column_index(loader, metric_key(loader->set));
+
+        if ((test >= 0) && (size_column >= 0) && (metric >= 0) && (count == loader->column_count) &&
+            parse_number(fields[size_column], &size) && parse_number(fields[metric], &value))
+        {
+            result_set_add(loader->set, (column_index(loader, "plan") >= 0) ? "Plan" : "Test", fields[test], (uint32_t)size, value);
+        }
+        return;
+    }
+
+    //  Firmware output, Test, name, window, size, result[, overhead, n, corrected, n]
+    if ((strcmp(fields[0], "Test") == 0) && (count >= 5) && parse_number(fields[3], &size))
+    {
+        const char *metric = NULL;
+
+        if (loader->set->metric == RESULT_METRIC_RESULT)
+        {
+            metric = fields[4];
+        }
+        else
+        {
+            for (int i = 5; i < count - 1; i++)
+            {
+                if (strcmp(fields[i], "corrected") == 0)
+                {
+                    metric = fields[i + 1];
+                }
+            }
+        }
+        if ((metric != NULL) && parse_number(metric, &value))
+        {
+            result_set_add(loader->set, "Test", fields[1], (uint32_t)size, value);
+        }
+    }
+
+    //  Plan, plan, test, size, rep, window, result, overhead, corrected
+    if ((strcmp(fields[0], "Plan") == 0) && (count == 9) && parse_number(fields[3], &size) &&
+        parse_number(fields[(loader->set->metric == RESULT_METRIC_CORRECTED) ? 8 : 6], &value))
+    {
+        result_set_add(loader->set, "Plan", fields[2], (uint32_t)size, value);
+    }
+}
+
+static void on_text(void *context, const char *line)
+{
+    char copy[RESULT_DECODE_TEXT_MAX];
+    size_t length = strlen(line);
+
+    //  Firmware logs are CRLF
+    if (length >= sizeof(copy))
+    {
+        return;
+    }
+    memcpy(copy, line, length + 1);
+    while ((length != 0) && ((copy[length - 1] == '\r') || (copy[length - 1] == ' ')))
+    {
+        copy[--length] = 0;
+    }
+
+    if (copy[0] == '{')
+    {
+        load_json((result_loader *)context, copy);
+    }
+    else
+    {
+        load_csv((result_loader *)context, copy);
+    }
+}
+
+static void on_record(void *context, const result_decoded *record)
+{
+    result_loader *loader = (result_loader *)context;
+    const char *type = record->schema->type;
+
+    if ((strcmp(type, "Test") != 0) && (strcmp(type, "Plan") != 0))
+    {
+        return;
+    }
+
+    const result_value *test = result_decoded_field(record, "test");
+    const result_value *size = result_decoded_field(record, "size");
+    const result_value *metric = result_decoded_field(record, metric_key(loader->set));
+
+    if ((test != NULL) && (size != NULL) && (metric != NULL))
+    {
+        result_set_add(loader->set, type, test->s, (uint32_t)size->u, (double)metric->u);
+    }
+}
+
+bool result_set_load(result_set *set, const char *path)
+{
+    static result_decoder decoder;
+    static result_loader loader;
+    uint8_t buffer[4096];
+    size_t length;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: can't open\n", path);
+        return false;
+    }
+
+    //  Binary frames come out as records, everything else as lines of text
+    memset(&loader, 0, sizeof(loader));
+    loader.set = set;
+    result_decoder_init(&decoder, on_record, on_text, &loader);
+
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) != 0)
+    {
+        result_decoder_feed(&decoder, buffer, length);
+    }
+    result_decoder_finish(&decoder);
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+void result_series_summary(const result_series *series, result_summary *summary)
+{
+    double sum = 0.0, squares = 0.0;
+
+    memset(summary, 0, sizeof(result_summary));
+    summary->count = series->count;
+    if (series->count == 0)
+    {
+        return;
+    }
+
+    summary->min = summary->max = series->samples[0];
+    for (int i = 0; i < series->count; i++)
+    {
+        double value = series->samples[i];
+        sum += value;
+        summary->min = (value < summary->min) ? value : summary->min;
+        summary->max = (value > summary->max) ? value : summary->max;
+    }
+    summary->mean = sum / series->count;
+
+    if (series->count > 1)
+    {
+        for (int i = 0; i < series->count; i++)
+        {
+            double delta = series->samples[i] - summary->mean;
+            squares += delta * delta;
+        }
+        summary->stddev = sqrt(squares / (series->count - 1));
+    }
+}
+
+double result_welch_t(const result_summary *a, const result_summary *b, double *df)
+{
+    double va = (a->stddev * a->stddev) / a->count;
+    double vb = (b->stddev * b->stddev) / b->count;
+    double se = sqrt(va + vb);
+
+    //  No spread at all, any difference is real
+    if (se == 0.0)
+    {
+        *df = a->count + b->count - 2;
+        return (b->mean == a->mean) ? 0.0 : (b->mean > a->mean) ? INFINITY : -INFINITY;
+    }
+
+    *df = ((va + vb) * (va + vb)) / (((va * va) / (a->count - 1)) + ((vb * vb) / (b->count - 1)));
+    return (b->mean - a->mean) / se;
+}
+
+double result_t_critical(double df, int confidence)
+{
+    //  One sided, df 1..30 then 40, 60, 120 and infinity
+    static const double t95[] = { 6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+                                  1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+                                  1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697,
+                                  1.684, 1.671, 1.658, 1.645 };
+    static const double t99[] = { 31.821, 6.965, 4.541, 3.747, 3.365, 3.143, 2.998, 2.896, 2.821, 2.764,
+                                  2.718, 2.681, 2.650, 2.624, 2.602, 2.583, 2.567, 2.552, 2.539, 2.528,
+                                  2.518, 2.508, 2.500, 2.492, 2.485, 2.479, 2.473, 2.467, 2.462, 2.457,
+                                  2.423, 2.390, 2.358, 2.326 };
+    const double *table = (confidence >= 99) ? t99 : t95;
+    int index;
+
+    //  Rounded down, the larger value is the safe side
+    if (df < 1.0)
+    {
+        df = 1.0;
+    }
+    if (df < 31.0)
+    {
+        index = (int)df - 1;
+    }
+    else
+    {
+        index = (df < 40.0) ? 29 : (df < 60.0) ? 30 : (df < 120.0) ? 31 : 32;
+    }
+    return table[index];
+}
@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Test / Plan results loaded from any of the forms they get saved in, for
+//  comparing runs
+//
+//  A file can be a firmware log (CSV records mixed with other output, like
+//  results/), JSON Lines, a binary capture, or a serial_driver CSV with its
+//  heading row.  Results are grouped into series by record type, test name
+//  and size, the repetitions (Plan reps, or the same test in several runs
+//  in one file) are the samples.
+
+#ifndef RESULT_SET_H
+#define RESULT_SET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "result_out.h"
+
+//  Which cycle count to compare, old logs only have result
+typedef enum
+{
+    RESULT_METRIC_RESULT,
+    RESULT_METRIC_CORRECTED,
+} result_metric;
+
+typedef struct
+{
+    char type[8];                       //  "Test" or "Plan"
+    char test[RESULT_MAX_STRING + 1];
+    uint32_t size;
+    double *samples;
+    int count;
+    int capacity;
+} result_series;
+
+typedef struct
+{
+    result_series *series;
+    int count;
+    int capacity;
+    result_metric metric;
+    uint64_t samples;
+} result_set;
+
+typedef struct
+{
+    int count;
+    double mean;
+    double stddev;                      //  Sample standard deviation, 0 for one sample
+    double min;
+    double max;
+} result_summary;
+
+void result_set_init(result_set *set, result_metric metric);
+void result_set_free(result_set *set);
+
+//  Adds every Test / Plan result in path, false if it can't be read
+bool result_set_load(result_set *set, const char *path);
+
+void result_set_add(result_set *set, const char *type, const char *test, uint32_t size, double value);
+const result_series *result_set_find(const result_set *set, const char *type, const char *test, uint32_t size);
+
+void result_series_summary(const result_series *series, result_summary *summary);
+
+//  Welch's t for b - a, degrees of freedom in df, needs two samples each
+double result_welch_t(const result_summary *a, const result_summary *b, double *df);
+
+//  One sided Student t critical value, confidence 95 or 99 (percent)
+double result_t_critical(double df, int confidence);
+
+#endif
@@ -0,0 +1,332 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "result_sink.h"
+
+#if HAVE_SQLITE3
+#include <sqlite3.h>
+#endif
+
+bool result_sink_has_sqlite(void)
+{
+    return HAVE_SQLITE3 != 0;
+}
+
+//  Record types can have spaces ("Latency bucket"), not wanted in file / table names
+static void sink_type_name(const char *type, char *name, size_t size)
+{
+    size_t i;
+
+    for (i = 0; (type[i] != 0) && (i < size - 1); i++)
+    {
+        char c = type[i];
+        name[i] = (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))) ? c : '_';
+    }
+    name[i] = 0;
+}
+
+static void csv_string(FILE *file, const char *text)
+{
+    if (strpbrk(text, ",\"\r\n") == NULL)
+    {
+        fputs(text, file);
+        return;
+    }
+
+    fputc('"', file);
+    for (; *text != 0; text++)
+    {
+        if (*text == '"')
+        {
+            fputc('"', file);
+        }
+        fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+static void csv_value(FILE *file, const result_value *value)
+{
+    switch (value->type)
+    {
+        case RESULT_TYPE_STR:
+            csv_string(file, value->s);
+            break;
+        case RESULT_TYPE_U64:
+            fprintf(file, "%llu", (unsigned long long)value->u);
+            break;
+        case RESULT_TYPE_I64:
+            fprintf(file, "%lld", (long long)value->i);
+            break;
+        case RESULT_TYPE_HEX:
+            fprintf(file, "0x%08lX", (long unsigned int)value->u);
+            break;
+        default:
+            fprintf(file, "%.6g", (double)value->f);
+            break;
+    }
+}
+
+static FILE *sink_csv_file(result_sink *sink, const result_decoded *record)
+{
+    const result_decoded_schema *schema = record->schema;
+
+    for (int i = 0; i < sink->csv_count; i++)
+    {
+        if (strcmp(sink->csv[i].type, schema->type) == 0)
+        {
+            return sink->csv[i].file;
+        }
+    }
+    if (sink->csv_count == RESULT_SINK_MAX_TYPES)
+    {
+        return NULL;
+    }
+
+    char name[RESULT_SINK_NAME_SIZE];
+    char path[1024];
+
+    sink_type_name(schema->type, name, sizeof(name));
+    snprintf(path, sizeof(path), "%s-%s.csv", sink->csv_prefix, name);
+
+    FILE *file = fopen(path, "a");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: can't open\n", path);
+        return NULL;
+    }
+
+    //  Heading row on a new file
+    if (ftell(file) == 0)
+    {
+        fprintf(file, "run, attempt");
+        for (int f = 0; f < schema->field_count; f++)
+        {
+            fprintf(file, ", %s", schema->field_keys[f]);
+        }
+        fprintf(file, "\n");
+    }
+
+    result_sink_csv *csv = &sink->csv[sink->csv_count++];
+    strcpy(csv->type, schema->type);
+    csv->file = file;
+
+    return file;
+}
+
+#if HAVE_SQLITE3
+
+static void sql_quote_name(char *out, size_t size, const char *name)
+{
+    size_t used = 0;
+
+    out[used++] = '"';
+    for (; (*name != 0) && (used < size - 3); name++)
+    {
+        if (*name == '"')
+        {
+            out[used++] = '"';
+        }
+        out[used++] = *name;
+    }
+    out[used++] = '"';
+    out[used] = 0;
+}
+
+static void sink_sqlite_record(result_sink *sink, const result_decoded *record)
+{
+    const result_decoded_schema *schema = record->schema;
+    sqlite3 *db = (sqlite3 *)sink->sqlite;
+    char table[RESULT_SINK_NAME_SIZE + 2];
+    char column[2 * RESULT_MAX_STRING + 3];
+    char create[8192];
+    char insert[8192];
+    int create_used, insert_used;
+
+    sql_quote_name(table, sizeof(table), schema->type);
+    create_used = snprintf(create, sizeof(create), "CREATE TABLE IF NOT EXISTS %s (run TEXT, attempt INTEGER", table);
+    insert_used = snprintf(insert, sizeof(insert), "INSERT INTO %s (run, attempt", table);
+
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        static const char * const affinity[] = { "", "TEXT", "INTEGER", "INTEGER", "INTEGER", "REAL" };
+
+        sql_quote_name(column, sizeof(column), schema->field_keys[f]);
+        create_used += snprintf(create + create_used, sizeof(create) - create_used, ", %s %s", column, affinity[schema->field_types[f]]);
+        insert_used += snprintf(insert + insert_used, sizeof(insert) - insert_used, ", %s", column);
+    }
+    snprintf(create + create_used, sizeof(create) - create_used, ")");
+    insert_used += snprintf(insert + insert_used, sizeof(insert) - insert_used, ") VALUES (?, ?");
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        insert_used += snprintf(insert + insert_used, sizeof(insert) - insert_used, ", ?");
+    }
+    snprintf(insert + insert_used, sizeof(insert) - insert_used, ")");
+
+    sqlite3_stmt *statement = NULL;
+
+    if ((sqlite3_exec(db, create, NULL, NULL, NULL) != SQLITE_OK) ||
+        (sqlite3_prepare_v2(db, insert, -1, &statement, NULL) != SQLITE_OK))
+    {
+        fprintf(stderr, "sqlite, %s\n", sqlite3_errmsg(db));
+        sink->errors++;
+        return;
+    }
+
+    sqlite3_bind_text(statement, 1, sink->run, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(statement, 2, sink->attempt);
+    for (int f = 0; f < schema->field_count; f++)
+    {
+        const result_value *value = &record->values[f];
+
+        switch (value->type)
+        {
+            case RESULT_TYPE_STR:
+                sqlite3_bind_text(statement, f + 3, value->s, -1, SQLITE_TRANSIENT);
+                break;
+            case RESULT_TYPE_I64:
+                sqlite3_bind_int64(statement, f + 3, value->i);
+                break;
+            case RESULT_TYPE_F32:
+                sqlite3_bind_double(statement, f + 3, value->f);
+                break;
+            default:
+                sqlite3_bind_int64(statement, f + 3, (sqlite3_int64)value->u);
+                break;
+        }
+    }
+
+    if (sqlite3_step(statement) != SQLITE_DONE)
+    {
+        fprintf(stderr, "sqlite, %s\n", sqlite3_errmsg(db));
+        sink->errors++;
+    }
+    sqlite3_finalize(statement);
+
+    if ((sink->rows % RESULT_SINK_COMMIT_ROWS) == 0)
+    {
+        sqlite3_exec(db, "COMMIT; BEGIN", NULL, NULL, NULL);
+    }
+}
+
+#endif
+
+bool result_sink_open(result_sink *sink, const char *csv_prefix, const char *json_path, const char *sqlite_path, const char *run)
+{
+    memset(sink, 0, sizeof(result_sink));
+    snprintf(sink->run, sizeof(sink->run), "%s", run);
+    sink->csv_prefix = csv_prefix;
+
+    if ((json_path != NULL) && ((sink->json = fopen(json_path, "a")) == NULL))
+    {
+        fprintf(stderr, "%s: can't open\n", json_path);
+        return false;
+    }
+
+    if (sqlite_path != NULL)
+    {
+#if HAVE_SQLITE3
+        sqlite3 *db = NULL;
+        if (sqlite3_open(sqlite_path, &db) != SQLITE_OK)
+        {
+            fprintf(stderr, "%s: %s\n", sqlite_path, sqlite3_errmsg(db));
+            sqlite3_close(db);
+            return false;
+        }
+        sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+        sink->sqlite = db;
+#else
+        fprintf(stderr, "%s: built without SQLite\n", sqlite_path);
+        return false;
+#endif
+    }
+
+    return true;
+}
+
+void result_sink_record(result_sink *sink, const result_decoded *record)
+{
+    sink->rows++;
+
+    if (sink->csv_prefix != NULL)
+    {
+        FILE *file = sink_csv_file(sink, record);
+        if (file != NULL)
+        {
+            fprintf(file, "%s, %d", sink->run, sink->attempt);
+            for (int f = 0; f < record->schema->field_count; f++)
+            {
+                fprintf(file, ", ");
+                csv_value(file, &record->values[f]);
+            }
+            fprintf(file, "\n");
+        }
+    }
+
+    if (sink->json != NULL)
+    {
+        char line[8192];
+        size_t length = result_decoded_json(record, line, sizeof(line));
+
+        //  Run and attempt go in after the opening brace
+        if ((length < sizeof(line)) && (length > 1))
+        {
+            fprintf(sink->json, "{\"run\":\"%s\",\"attempt\":%d,%s", sink->run, sink->attempt, line + 1);
+        }
+    }
+
+#if HAVE_SQLITE3
+    if (sink->sqlite != NULL)
+    {
+        sink_sqlite_record(sink, record);
+    }
+#endif
+}
+
+void result_sink_close(result_sink *sink)
+{
+    for (int i = 0; i < sink->csv_count; i++)
+    {
+        fclose(sink->csv[i].file);
+    }
+    sink->csv_count = 0;
+
+    if (sink->json != NULL)
+    {
+        fclose(sink->json);
+        sink->json = NULL;
+    }
+
+#if HAVE_SQLITE3
+    if (sink->sqlite != NULL)
+    {
+        sqlite3_exec((sqlite3 *)sink->sqlite, "COMMIT", NULL, NULL, NULL);
+        sqlite3_close((sqlite3 *)sink->sqlite);
+        sink->sqlite = NULL;
+    }
+#endif
+}
@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Where decoded result records end up on the host
+//
+//  CSV is one file per record type, PREFIX-Type.csv with a heading row,
+//  so each opens straight into a spreadsheet.  JSON Lines is one file with
+//  every record.  SQLite (when built with it) is a table per record type.
+//  Every row carries the run name and attempt number so retried commands
+//  can be told apart.
+
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include <stdio.h>
+
+#include "result_decode.h"
+
+#define RESULT_SINK_MAX_TYPES   RESULT_MAX_SCHEMAS
+#define RESULT_SINK_NAME_SIZE   64
+#define RESULT_SINK_COMMIT_ROWS 1000            //  SQLite rows per transaction
+
+typedef struct
+{
+    char type[RESULT_MAX_STRING + 1];
+    FILE *file;
+} result_sink_csv;
+
+typedef struct
+{
+    const char *csv_prefix;
+    result_sink_csv csv[RESULT_SINK_MAX_TYPES];
+    int csv_count;
+
+    FILE *json;
+    void *sqlite;                               //  sqlite3 *, NULL when not used
+
+    char run[RESULT_SINK_NAME_SIZE];
+    int attempt;
+    uint64_t rows;
+    uint64_t errors;
+} result_sink;
+
+//  Any of the paths can be NULL, false if one couldn't be opened
+bool result_sink_open(result_sink *sink, const char *csv_prefix, const char *json_path, const char *sqlite_path, const char *run);
+void result_sink_record(result_sink *sink, const result_decoded *record);
+void result_sink_close(result_sink *sink);
+
+//  Whether SQLite support was built in
+bool result_sink_has_sqlite(void);
+
+#endif
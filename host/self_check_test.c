@@ -0,0 +1,233 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Golden baseline and self check grading
+//
+//  Grades results either side of a baseline across the pass / degraded /
+//  fail bands, on and just past each edge, with the default and tighter
+//  bands, and the board grading for a changed clock or PSRAM.  The baseline
+//  itself is checked for limits, lookup and a tampered checksum.  Exits
+//  non-zero if anything is off.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "self_check.h"
+
+#define GOLDEN_US           100000
+#define GOLDEN_CLOCK_HZ     150000000
+#define GOLDEN_PSRAM_SIZE   (8 * 1024 * 1024)
+#define GOLDEN_PSRAM_ID     0x5D53
+
+static int s_failures;
+
+#define CHECK(condition, ...)                   \
+    do                                          \
+    {                                           \
+        if (!(condition))                       \
+        {                                       \
+            printf("FAIL, " __VA_ARGS__);       \
+            printf("\n");                       \
+            s_failures++;                       \
+        }                                       \
+    } while (0)
+
+typedef struct
+{
+    uint64_t us;
+    self_check_grade grade;
+    int32_t deviation;                  //  Tenths of a percent
+} grade_case;
+
+//  Results
+
+static void test_grades(const char *name, const golden_entry *entry, const self_check_bands *bands,
+                        const grade_case *cases, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int32_t deviation = -1;
+        self_check_grade grade = self_check_grade_result(entry, cases[i].us, bands, &deviation);
+
+        CHECK(grade == cases[i].grade, "%s, %llu us graded %s, expected %s", name, (unsigned long long)cases[i].us,
+              self_check_grade_name(grade), self_check_grade_name(cases[i].grade));
+        CHECK(deviation == cases[i].deviation, "%s, %llu us deviation %d, expected %d", name, (unsigned long long)cases[i].us,
+              (int)deviation, (int)cases[i].deviation);
+    }
+}
+
+static void test_results(void)
+{
+    static const self_check_bands default_bands = { SELF_CHECK_DEGRADED_PCT, SELF_CHECK_FAIL_PCT };
+    static const self_check_bands tight_bands = { 1, 2 };
+    golden_entry entry = { "RND PSRAM READ", 16384, 10, GOLDEN_US };
+
+    //  Either way from the baseline counts, the band edges are inclusive
+    static const grade_case default_cases[] =
+    {
+        { GOLDEN_US,            SELF_CHECK_PASS,        0 },
+        { 104999,               SELF_CHECK_PASS,        49 },
+        { 105000,               SELF_CHECK_PASS,        50 },
+        { 95000,                SELF_CHECK_PASS,        -50 },
+        { 105100,               SELF_CHECK_DEGRADED,    51 },
+        { 94900,                SELF_CHECK_DEGRADED,    -51 },
+        { 125000,               SELF_CHECK_DEGRADED,    250 },
+        { 75000,                SELF_CHECK_DEGRADED,    -250 },
+        { 125100,               SELF_CHECK_FAIL,        251 },
+        { 74900,                SELF_CHECK_FAIL,        -251 },
+        { 300000,               SELF_CHECK_FAIL,        2000 },
+        { 1,                    SELF_CHECK_FAIL,        -999 },
+        { 0,                    SELF_CHECK_FAIL,        0 },        //  Didn't run
+    };
+    test_grades("default bands", &entry, &default_bands, default_cases, sizeof(default_cases) / sizeof(default_cases[0]));
+
+    static const grade_case tight_cases[] =
+    {
+        { 101000,               SELF_CHECK_PASS,        10 },
+        { 101500,               SELF_CHECK_DEGRADED,    15 },
+        { 98000,                SELF_CHECK_DEGRADED,    -20 },
+        { 102100,               SELF_CHECK_FAIL,        21 },
+    };
+    test_grades("tight bands", &entry, &tight_bands, tight_cases, sizeof(tight_cases) / sizeof(tight_cases[0]));
+
+    //  A huge result against a tiny baseline clamps the deviation
+    golden_entry tiny = { "TINY", 1, 1, 1 };
+    static const grade_case tiny_cases[] =
+    {
+        { 1000000000000ull,     SELF_CHECK_FAIL,        INT32_MAX },
+    };
+    test_grades("clamped", &tiny, &default_bands, tiny_cases, 1);
+
+    //  No baseline entry, or a zero one, can't pass
+    int32_t deviation = -1;
+    CHECK(self_check_grade_result(NULL, GOLDEN_US, &default_bands, &deviation) == SELF_CHECK_FAIL, "no entry, not fail");
+    CHECK(deviation == 0, "no entry, deviation %d", (int)deviation);
+    entry.us = 0;
+    CHECK(self_check_grade_result(&entry, GOLDEN_US, &default_bands, &deviation) == SELF_CHECK_FAIL, "zero entry, not fail");
+}
+
+//  Board
+
+static void test_board(void)
+{
+    golden_baseline golden;
+
+    golden_init(&golden, GOLDEN_CLOCK_HZ, GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID);
+    CHECK(self_check_grade_board(&golden, GOLDEN_CLOCK_HZ, GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID) == SELF_CHECK_PASS, "board, same board not pass");
+    CHECK(self_check_grade_board(&golden, 200000000, GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID) == SELF_CHECK_DEGRADED, "board, other clock not degraded");
+    CHECK(self_check_grade_board(&golden, GOLDEN_CLOCK_HZ, 2 * GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID) == SELF_CHECK_FAIL, "board, other PSRAM size not fail");
+    CHECK(self_check_grade_board(&golden, GOLDEN_CLOCK_HZ, GOLDEN_PSRAM_SIZE, 0x5D52) == SELF_CHECK_FAIL, "board, other PSRAM ID not fail");
+    CHECK(self_check_grade_board(&golden, 200000000, 0, GOLDEN_PSRAM_ID) == SELF_CHECK_FAIL, "board, other clock and no PSRAM not fail");
+
+    //  The overall grade is the worst of the board and every test
+    CHECK(self_check_worse(SELF_CHECK_PASS, SELF_CHECK_DEGRADED) == SELF_CHECK_DEGRADED, "worse, pass / degraded");
+    CHECK(self_check_worse(SELF_CHECK_FAIL, SELF_CHECK_DEGRADED) == SELF_CHECK_FAIL, "worse, fail / degraded");
+    CHECK(self_check_worse(SELF_CHECK_PASS, SELF_CHECK_PASS) == SELF_CHECK_PASS, "worse, pass / pass");
+
+    CHECK(strcmp(self_check_grade_name(SELF_CHECK_DEGRADED), "degraded") == 0, "grade name");
+    CHECK(strcmp(self_check_grade_name((self_check_grade)7), "?") == 0, "grade name out of range");
+}
+
+//  Baseline
+
+static void test_golden(void)
+{
+    golden_baseline golden, copy;
+    char name[GOLDEN_NAME_SIZE + 1];
+
+    golden_init(&golden, GOLDEN_CLOCK_HZ, GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID);
+    CHECK(golden_add(&golden, "SEQ SRAM READ", 16384, 10, 51000), "golden, add");
+    CHECK(golden_add(&golden, "RND PSRAM READ", 16384, 10, 760000), "golden, add");
+
+    memset(name, 'x', GOLDEN_NAME_SIZE);
+    name[GOLDEN_NAME_SIZE] = '\0';
+    CHECK(!golden_add(&golden, name, 16384, 10, 1), "golden, name too long added");
+    name[GOLDEN_NAME_SIZE - 1] = '\0';
+    CHECK(golden_add(&golden, name, 16384, 10, 1), "golden, longest name not added");
+    CHECK(!golden_add(&golden, "SLOW", 16384, 10, (uint64_t)UINT32_MAX + 1), "golden, time over 32 bits added");
+    CHECK(golden.count == 3, "golden, count %u", golden.count);
+
+    golden_seal(&golden);
+    CHECK(golden_valid(&golden), "golden, sealed not valid");
+
+    const golden_entry *entry = golden_find(&golden, "RND PSRAM READ");
+    CHECK((entry != NULL) && (entry->us == 760000) && (entry->size == 16384) && (entry->loop_scale == 10), "golden, find");
+    CHECK(golden_find(&golden, "RND PSRAM") == NULL, "golden, found a prefix");
+    CHECK(golden_find(&golden, "SEQ ROM READ") == NULL, "golden, found a missing test");
+
+    //  Same contents, same checksum, whatever was in memory before
+    memset(&copy, 0xA5, sizeof(copy));
+    golden_init(&copy, GOLDEN_CLOCK_HZ, GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID);
+    golden_add(&copy, "SEQ SRAM READ", 16384, 10, 51000);
+    golden_add(&copy, "RND PSRAM READ", 16384, 10, 760000);
+    golden_add(&copy, name, 16384, 10, 1);
+    golden_seal(&copy);
+    CHECK(copy.checksum == golden.checksum, "golden, checksum depends on old memory");
+
+    //  Any change after sealing is caught
+    copy.entries[1].us++;
+    CHECK(!golden_valid(&copy), "golden, tampered time still valid");
+    golden_seal(&copy);
+    CHECK(golden_valid(&copy), "golden, resealed not valid");
+
+    copy = golden;
+    copy.clock_hz++;
+    CHECK(!golden_valid(&copy), "golden, tampered clock still valid");
+    copy = golden;
+    copy.version++;
+    golden_seal(&copy);
+    CHECK(!golden_valid(&copy), "golden, other version valid");
+    copy = golden;
+    copy.count = GOLDEN_MAX_TESTS + 1;
+    golden_seal(&copy);
+    CHECK(!golden_valid(&copy), "golden, too many entries valid");
+
+    //  Erased flash
+    memset(&copy, 0xFF, sizeof(copy));
+    CHECK(!golden_valid(&copy), "golden, erased flash valid");
+
+    //  Full
+    golden_init(&copy, GOLDEN_CLOCK_HZ, GOLDEN_PSRAM_SIZE, GOLDEN_PSRAM_ID);
+    for (int i = 0; i < GOLDEN_MAX_TESTS; i++)
+    {
+        snprintf(name, sizeof(name), "TEST %d", i);
+        CHECK(golden_add(&copy, name, 16384, 10, 1000 + i), "golden, add %d", i);
+    }
+    CHECK(!golden_add(&copy, "ONE MORE", 16384, 10, 1), "golden, added past the end");
+    golden_seal(&copy);
+    CHECK(golden_valid(&copy), "golden, full not valid");
+    entry = golden_find(&copy, "TEST 15");
+    CHECK((entry != NULL) && (entry->us == 1015), "golden, find last");
+}
+
+int main(void)
+{
+    test_results();
+    test_board();
+    test_golden();
+
+    printf("self_check_test, %s, failures, %d\n", (s_failures == 0) ? "pass" : "fail", s_failures);
+    return (s_failures == 0) ? 0 : 1;
+}
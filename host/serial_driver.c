@@ -0,0 +1,457 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Drives a board over its serial port and collects the results
+//
+//  Waits for the shell prompt, switches the board to binary records, sends
+//  a test plan, runs it and any extra commands, and writes every decoded
+//  record to CSV / JSON Lines / SQLite.  If the port goes away (board reset,
+//  cable pulled) or goes quiet for too long the port is opened again, the
+//  board set up again and the interrupted command run again, up to
+//  --retries times.  Rows carry the attempt number so a partial first
+//  attempt can be told from the rerun.
+//
+//      serial_driver --port=/dev/ttyACM0 [--plan=file] [--command="run all"]...
+//                    [--csv=prefix] [--json=file] [--sqlite=file] [--log=file]
+//                    [--run=name] [--timeout=s] [--retries=n]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench_shell.h"
+#include "plan_file.h"
+#include "result_decode.h"
+#include "result_sink.h"
+#include "serial_port.h"
+
+#define DRIVER_MAX_COMMANDS     32
+#define DRIVER_TIMEOUT_S        120             //  Longest quiet spell before giving up on a command
+#define DRIVER_SYNC_TIMEOUT_S   60              //  Start up can run the autorun tests first
+#define DRIVER_RETRIES          3
+#define DRIVER_REOPEN_MS        500
+#define DRIVER_SYNC_RESEND_MS   2000
+
+typedef struct
+{
+    const char *port;
+    const char *plan_path;
+    const char *commands[DRIVER_MAX_COMMANDS];
+    int command_count;
+    int timeout_s;
+    int retries;
+    FILE *log;
+    test_plan plan;
+    bool have_plan;
+
+    int fd;
+    result_decoder decoder;
+    result_sink sink;
+    bool collecting;                            //  Records go to the sink, not during set up
+    size_t prompt_matched;                      //  Characters of the prompt seen so far
+    bool prompt_seen;
+    bool error_seen;                            //  "Error, ..." or "Plan error, ..." from the board
+    uint64_t skipped;                           //  Records outside a command, e.g. the autorun
+    uint64_t bad_frames;                        //  Over every connection
+    uint64_t unknown_schema;
+} driver;
+
+static driver s_driver;
+
+static void on_record(void *context, const result_decoded *record)
+{
+    driver *d = (driver *)context;
+
+    if (d->collecting)
+    {
+        result_sink_record(&d->sink, record);
+    }
+    else
+    {
+        d->skipped++;
+    }
+}
+
+static void on_text(void *context, const char *line)
+{
+    driver *d = (driver *)context;
+
+    if ((strncmp(line, "Error,", 6) == 0) || (strncmp(line, "Plan error,", 11) == 0) || (strncmp(line, "Usage,", 6) == 0))
+    {
+        d->error_seen = true;
+        fprintf(stderr, "%s\n", line);
+    }
+    if (d->log != NULL)
+    {
+        fprintf(d->log, "%s\n", line);
+    }
+}
+
+//  The prompt has no newline so it's looked for in the raw bytes
+static void match_prompt(driver *d, const uint8_t *data, int length)
+{
+    static const char prompt[] = BENCH_SHELL_PROMPT;
+
+    for (int i = 0; i < length; i++)
+    {
+        if (data[i] == (uint8_t)prompt[d->prompt_matched])
+        {
+            if (++d->prompt_matched == sizeof(prompt) - 1)
+            {
+                d->prompt_seen = true;
+                d->prompt_matched = 0;
+            }
+        }
+        else
+        {
+            d->prompt_matched = (data[i] == (uint8_t)prompt[0]) ? 1 : 0;
+        }
+    }
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//  Read until the prompt comes back, 1 prompt, 0 nothing for timeout_s, -1 port gone
+static int wait_prompt(driver *d, int timeout_s, const char *resend)
+{
+    uint8_t buffer[4096];
+    double quiet_since = now_s();
+    double sent = quiet_since;
+
+    d->prompt_seen = false;
+    while (!d->prompt_seen)
+    {
+        int length = serial_read(d->fd, buffer, sizeof(buffer), 100);
+        double now = now_s();
+
+        if (length < 0)
+        {
+            return -1;
+        }
+        if (length > 0)
+        {
+            quiet_since = now;
+            match_prompt(d, buffer, length);
+            result_decoder_feed(&d->decoder, buffer, length);
+        }
+        else if ((now - quiet_since) > timeout_s)
+        {
+            return 0;
+        }
+        else if ((resend != NULL) && ((now - sent) * 1000 > DRIVER_SYNC_RESEND_MS) && ((now - quiet_since) * 1000 > DRIVER_SYNC_RESEND_MS))
+        {
+            //  Nothing running and no prompt, it missed the line
+            if (!serial_write(d->fd, resend, strlen(resend)))
+            {
+                return -1;
+            }
+            sent = now;
+        }
+    }
+
+    return 1;
+}
+
+static bool send_line(driver *d, const char *line)
+{
+    return serial_write(d->fd, line, strlen(line)) && serial_write(d->fd, "\r", 1);
+}
+
+//  Plan lines one at a time, the shell has a line buffer not a file buffer
+static int send_plan(driver *d)
+{
+    size_t length = test_plan_format(&d->plan, NULL, 0);
+    char *text = malloc(length + 1);
+    int result = -1;
+
+    if (text == NULL)
+    {
+        return -1;
+    }
+    test_plan_format(&d->plan, text, length + 1);
+
+    d->error_seen = false;
+    if (send_line(d, "plan load"))
+    {
+        char *line = text;
+        result = 1;
+        while ((*line != 0) && (result > 0))
+        {
+            char *next = strchr(line, '\n');
+            if (next != NULL)
+            {
+                *next++ = 0;
+            }
+            else
+            {
+                next = line + strlen(line);
+            }
+            if (!send_line(d, line))
+            {
+                result = -1;
+            }
+            line = next;
+        }
+        if (result > 0)
+        {
+            result = wait_prompt(d, d->timeout_s, NULL);
+        }
+    }
+    free(text);
+
+    if ((result > 0) && d->error_seen)
+    {
+        fprintf(stderr, "%s: the board rejected the plan\n", d->plan_path);
+        return -2;
+    }
+    return result;
+}
+
+//  Open the port and get the board to a prompt, in binary, with the plan loaded
+static int connect_board(driver *d)
+{
+    const char *sync = "format binary\r";
+    double give_up = now_s() + DRIVER_SYNC_TIMEOUT_S;
+
+    while ((d->fd = serial_open(d->port)) < 0)
+    {
+        if (now_s() > give_up)
+        {
+            fprintf(stderr, "%s: can't open\n", d->port);
+            return -1;
+        }
+        usleep(DRIVER_REOPEN_MS * 1000);
+    }
+
+    //  Anything left over from the last connection is junk
+    result_decoder_init(&d->decoder, on_record, on_text, d);
+    d->prompt_matched = 0;
+    d->collecting = false;
+
+    if (!serial_write(d->fd, sync, strlen(sync)) || (wait_prompt(d, DRIVER_SYNC_TIMEOUT_S, sync) <= 0))
+    {
+        fprintf(stderr, "%s: no prompt\n", d->port);
+        return 0;
+    }
+
+    if (d->have_plan)
+    {
+        return send_plan(d);
+    }
+    return 1;
+}
+
+static void disconnect_board(driver *d)
+{
+    result_decoder_finish(&d->decoder);
+    d->bad_frames += d->decoder.bad_frames;
+    d->unknown_schema += d->decoder.unknown_schema;
+    serial_close(d->fd);
+    d->fd = -1;
+}
+
+//  Runs every command, true if they all finished
+static bool run_session(driver *d)
+{
+    const char *commands[DRIVER_MAX_COMMANDS + 1];
+    int count = 0;
+    int failures = 0;
+
+    if (d->have_plan)
+    {
+        commands[count++] = "plan run";
+    }
+    for (int i = 0; i < d->command_count; i++)
+    {
+        commands[count++] = d->commands[i];
+    }
+
+    int next = 0;
+    while (next < count)
+    {
+        int result = connect_board(d);
+
+        while ((result > 0) && (next < count))
+        {
+            fprintf(stderr, "%s, attempt %d\n", commands[next], d->sink.attempt);
+            d->collecting = true;
+            d->error_seen = false;
+            result = send_line(d, commands[next]) ? wait_prompt(d, d->timeout_s, NULL) : -1;
+            d->collecting = false;
+
+            if (result > 0)
+            {
+                if (d->error_seen)
+                {
+                    fprintf(stderr, "%s: failed on the board\n", commands[next]);
+                }
+                next++;
+                d->sink.attempt = 0;
+            }
+        }
+
+        if (d->fd >= 0)
+        {
+            disconnect_board(d);
+        }
+        if (result == -2)
+        {
+            return false;
+        }
+        if (next < count)
+        {
+            fprintf(stderr, "%s: %s\n", d->port, (result < 0) ? "disconnected" : "timed out");
+            if (++failures > d->retries)
+            {
+                return false;
+            }
+            d->sink.attempt++;
+            usleep(DRIVER_REOPEN_MS * 1000);
+        }
+    }
+
+    return true;
+}
+
+static const char *option(const char *arg, const char *name)
+{
+    size_t length = strlen(name);
+    return (strncmp(arg, name, length) == 0) ? arg + length : NULL;
+}
+
+int main(int argc, char **argv)
+{
+    driver *d = &s_driver;
+    plan_limits limits = { PLAN_HOST_BUFFER_WORDS, PLAN_HOST_PSRAM_BYTES };
+    const char *csv = NULL, *json = NULL, *sqlite = NULL;
+    char run[RESULT_SINK_NAME_SIZE];
+    const char *value;
+
+    snprintf(run, sizeof(run), "%lld", (long long)time(NULL));
+    d->timeout_s = DRIVER_TIMEOUT_S;
+    d->retries = DRIVER_RETRIES;
+    d->fd = -1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((value = option(argv[i], "--port=")) != NULL)
+        {
+            d->port = value;
+        }
+        else if ((value = option(argv[i], "--plan=")) != NULL)
+        {
+            d->plan_path = value;
+        }
+        else if ((value = option(argv[i], "--command=")) != NULL)
+        {
+            if (d->command_count == DRIVER_MAX_COMMANDS)
+            {
+                fprintf(stderr, "too many commands\n");
+                return 2;
+            }
+            d->commands[d->command_count++] = value;
+        }
+        else if ((value = option(argv[i], "--csv=")) != NULL)
+        {
+            csv = value;
+        }
+        else if ((value = option(argv[i], "--json=")) != NULL)
+        {
+            json = value;
+        }
+        else if ((value = option(argv[i], "--sqlite=")) != NULL)
+        {
+            sqlite = value;
+        }
+        else if ((value = option(argv[i], "--log=")) != NULL)
+        {
+            if ((d->log = fopen(value, "a")) == NULL)
+            {
+                fprintf(stderr, "%s: can't open\n", value);
+                return 1;
+            }
+        }
+        else if ((value = option(argv[i], "--run=")) != NULL)
+        {
+            snprintf(run, sizeof(run), "%s", value);
+        }
+        else if ((value = option(argv[i], "--timeout=")) != NULL)
+        {
+            d->timeout_s = atoi(value);
+        }
+        else if ((value = option(argv[i], "--retries=")) != NULL)
+        {
+            d->retries = atoi(value);
+        }
+        else if (!plan_file_limits_arg(argv[i], &limits))
+        {
+            fprintf(stderr, "bad %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if ((d->port == NULL) || ((d->plan_path == NULL) && (d->command_count == 0)))
+    {
+        fprintf(stderr, "usage: serial_driver --port=device [--plan=file] [--command=line]... [--csv=prefix] [--json=file] [--sqlite=file]\n"
+                        "                     [--log=file] [--run=name] [--timeout=s] [--retries=n] [--psram=bytes]\n");
+        return 2;
+    }
+
+    //  Checked here first so a typo doesn't cost a board run
+    if (d->plan_path != NULL)
+    {
+        if (!plan_file_load(d->plan_path, &d->plan, &limits))
+        {
+            return 1;
+        }
+        d->have_plan = true;
+    }
+
+    if (!result_sink_open(&d->sink, csv, json, sqlite, run))
+    {
+        return 1;
+    }
+
+    bool done = run_session(d);
+
+    result_sink_close(&d->sink);
+    if (d->log != NULL)
+    {
+        fclose(d->log);
+    }
+
+    fprintf(stderr, "run, %s, records, %llu, skipped, %llu, bad_frames, %llu, unknown_schema, %llu, %s\n",
+            run, (unsigned long long)d->sink.rows, (unsigned long long)d->skipped,
+            (unsigned long long)d->bad_frames, (unsigned long long)d->unknown_schema,
+            done ? "complete" : "incomplete");
+
+    return done ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "serial_port.h"
+
+int serial_open(const char *path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+        tcflush(fd, TCIOFLUSH);
+    }
+
+    return fd;
+}
+
+void serial_close(int fd)
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+int serial_read(int fd, uint8_t *buffer, size_t size, int timeout_ms)
+{
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    int ready = poll(&pfd, 1, timeout_ms);
+
+    if (ready < 0)
+    {
+        return (errno == EINTR) ? 0 : -1;
+    }
+    if (ready == 0)
+    {
+        return 0;
+    }
+
+    //  Readable with nothing to read is a hang up
+    ssize_t length = read(fd, buffer, size);
+    if (length > 0)
+    {
+        return (int)length;
+    }
+    if ((length < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+    {
+        return 0;
+    }
+    return -1;
+}
+
+bool serial_write(int fd, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while (length != 0)
+    {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        length -= written;
+    }
+
+    return tcdrain(fd) == 0 || errno == ENOTTY || errno == EINVAL;
+}
@@ -0,0 +1,82 @@
+#!/bin/sh
+#
+# serial_driver against board_sim on a pty, a clean session and one where the
+# cable is pulled part way through, the way ctest runs it:
+#
+#   serial_session_test.sh <board_sim> <serial_driver> <work directory>
+
+BOARD_SIM="$1"
+SERIAL_DRIVER="$2"
+WORK="$3"
+RECORDS=7                               # 3 sizes x 2 reps + 1
+failures=0
+sim_pid=
+
+fail()
+{
+    echo "FAIL, $*"
+    failures=$((failures + 1))
+}
+
+stop_sim()
+{
+    if [ -n "$sim_pid" ]; then
+        kill "$sim_pid" 2>/dev/null
+        wait "$sim_pid" 2>/dev/null
+        sim_pid=
+    fi
+}
+
+trap stop_sim EXIT
+
+# board_sim [options], returns once its pty is linked
+start_sim()
+{
+    rm -f "$WORK/sim"
+    "$BOARD_SIM" --link="$WORK/sim" "$@" > "$WORK/sim.out" 2>&1 &
+    sim_pid=$!
+    for i in $(seq 50); do
+        [ -e "$WORK/sim" ] && return 0
+        sleep 0.1
+    done
+    fail "board_sim didn't link its pty"
+    return 1
+}
+
+# session <name> [board_sim options]
+session()
+{
+    name="$1"
+    shift
+    rm -f "$WORK/$name".* "$WORK/$name"-*.csv
+    start_sim "$@" || return 1
+    timeout 60 "$SERIAL_DRIVER" --port="$WORK/sim" --plan="$WORK/session.plan" --json="$WORK/$name.jsonl" \
+        --csv="$WORK/$name" --timeout=10 --retries=2 > "$WORK/$name.out" 2>&1
+    status=$?
+    stop_sim
+    [ $status -eq 0 ] || fail "$name, serial_driver exit $status"
+    grep -q "records, $RECORDS, .*complete" "$WORK/$name.out" || fail "$name, run not complete: $(tail -n 1 "$WORK/$name.out")"
+}
+
+mkdir -p "$WORK" || exit 1
+cat > "$WORK/session.plan" <<'PLAN'
+plan session
+test rnd_sram region=sram op=read pattern=rnd size=1K..4K factor=2 loops=2 reps=2
+test seq_psram region=psram op=read pattern=seq size=16K loops=2
+end
+PLAN
+
+# Every record once, from the first attempt, in JSON Lines and CSV
+session clean
+[ "$(grep -c '"type":"Plan"' "$WORK/clean.jsonl")" = "$RECORDS" ] || fail "clean, JSON records"
+[ "$(grep -c '"attempt":0' "$WORK/clean.jsonl")" = "$RECORDS" ] || fail "clean, not all from attempt 0"
+[ "$(wc -l < "$WORK/clean-Plan.csv")" -eq $((RECORDS + 1)) ] || fail "clean, CSV rows"
+grep -q '"test":"seq_psram"' "$WORK/clean.jsonl" || fail "clean, last test missing"
+
+# Cable pulled after a few writes, the driver reconnects and reruns the plan
+session dropped --drop-after=3
+grep -q "disconnected" "$WORK/dropped.out" || fail "dropped, no disconnect seen"
+[ "$(grep -c '"attempt":1' "$WORK/dropped.jsonl")" = "$RECORDS" ] || fail "dropped, rerun records"
+
+echo "serial_session_test, $([ $failures -eq 0 ] && echo pass || echo fail), failures, $failures"
+[ $failures -eq 0 ]
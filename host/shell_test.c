@@ -0,0 +1,230 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Shell parser against scripted input
+//
+//  A script is fed a character at a time through shell_input_char() with a
+//  command table that logs what it was called with, and the log is compared
+//  with what the script should have done.  shell_parse_uint(), the
+//  tokenizer and shell_execute()'s results are checked from tables.  Exits
+//  non-zero at the first failure.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "shell.h"
+
+static char s_log[1024];
+static int s_failures;
+
+static void log_append(const char *text)
+{
+    strncat(s_log, text, sizeof(s_log) - strlen(s_log) - 1);
+}
+
+//  size <bytes>
+static int cmd_size(shell *sh, int argc, char **argv)
+{
+    uint32_t value;
+    char text[32];
+
+    if ((argc != 2) || !shell_parse_uint(argv[1], &value))
+    {
+        log_append("[size usage]");
+        return SHELL_USAGE;
+    }
+    snprintf(text, sizeof(text), "[size %lu]", (long unsigned int)value);
+    log_append(text);
+    return SHELL_OK;
+}
+
+//  args <anything>, logs the arguments
+static int cmd_args(shell *sh, int argc, char **argv)
+{
+    log_append("[args");
+    for (int i = 1; i < argc; i++)
+    {
+        log_append(" ");
+        log_append(argv[i]);
+    }
+    log_append("]");
+    return SHELL_OK;
+}
+
+static int capture_line(shell *sh, char *line)
+{
+    if (strcmp(line, "end") == 0)
+    {
+        shell_capture(sh, NULL);
+        log_append("[end]");
+        return SHELL_OK;
+    }
+    log_append("[line ");
+    log_append(line);
+    log_append("]");
+    return SHELL_OK;
+}
+
+//  load, lines up to end go to capture_line
+static int cmd_load(shell *sh, int argc, char **argv)
+{
+    shell_capture(sh, capture_line);
+    log_append("[load]");
+    return SHELL_OK;
+}
+
+static int cmd_fail(shell *sh, int argc, char **argv)
+{
+    log_append("[fail]");
+    return SHELL_ERROR;
+}
+
+static const shell_command s_test_commands[] =
+{
+    { "size", "<bytes>", "Parse a size", cmd_size },
+    { "args", "...", "Log the arguments", cmd_args },
+    { "load", "", "Capture lines up to end", cmd_load },
+    { "fail", "", "Always fails", cmd_fail },
+};
+
+typedef struct
+{
+    const char *text;
+    bool ok;
+    uint32_t value;
+} parse_case;
+
+static const parse_case s_parse_cases[] =
+{
+    { "0", true, 0 },
+    { "123", true, 123 },
+    { "0x1F", true, 0x1F },
+    { "0XfF", true, 0xFF },
+    { "48K", true, 48 * 1024 },
+    { "16k", true, 16 * 1024 },
+    { "8M", true, 8 * 1024 * 1024 },
+    { "0x10K", true, 16 * 1024 },
+    { "4294967295", true, 4294967295u },
+    { "4294967296", false, 0 },
+    { "4096M", false, 0 },
+    { "", false, 0 },
+    { "k", false, 0 },
+    { "K", false, 0 },
+    { "m", false, 0 },
+    { "M", false, 0 },
+    { "0x", false, 0 },
+    { "0xK", false, 0 },
+    { "12KB", false, 0 },
+    { "1.5", false, 0 },
+    { "-1", false, 0 },
+    { "12a", false, 0 },
+};
+
+typedef struct
+{
+    const char *line;
+    int result;
+} execute_case;
+
+static const execute_case s_execute_cases[] =
+{
+    { "size 64K", SHELL_OK },
+    { "SIZE 1", SHELL_OK },
+    { "size", SHELL_USAGE },
+    { "size k", SHELL_USAGE },
+    { "fail", SHELL_ERROR },
+    { "nosuch 1 2", SHELL_UNKNOWN },
+    { "", SHELL_EMPTY },
+    { "   \t  ", SHELL_EMPTY },
+    { "# just a comment", SHELL_EMPTY },
+    { "args 1 2 3 4 5 6 7 8 9 10 11", SHELL_OK },
+    { "args 1 2 3 4 5 6 7 8 9 10 11 12", SHELL_TOO_LONG },
+};
+
+//  Pasted in a character at a time, CR LF, tabs, backspaces, a comment and an overlong line
+static const char s_script[] =
+    "size 48K\r\n"
+    "size k\n"
+    "  args\ta  b   # comment\n"
+    "sizx\be 0x10\n"
+    "\n\r\n"
+    "load\n"
+    "entry 1 2\n"
+    "size 1\n"
+    "end\n"
+    "size 1M\n"
+    "args xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\n"
+    "args after\n";
+
+static const char s_script_log[] =
+    "[size 49152][size usage][args a b][size 16][load][line entry 1 2][line size 1][end][size 1048576][args after]";
+
+int main(void)
+{
+    shell sh;
+
+    for (int i = 0; i < (int)(sizeof(s_parse_cases) / sizeof(s_parse_cases[0])); i++)
+    {
+        const parse_case *test = &s_parse_cases[i];
+        uint32_t value = 0xA5A5A5A5;
+        bool ok = shell_parse_uint(test->text, &value);
+
+        if ((ok != test->ok) || (ok && (value != test->value)))
+        {
+            printf("FAIL, parse \"%s\", %s %lu, expected %s %lu\n", test->text, ok ? "ok" : "refused", (long unsigned int)value,
+                   test->ok ? "ok" : "refused", (long unsigned int)test->value);
+            s_failures++;
+        }
+    }
+
+    shell_init(&sh, s_test_commands, sizeof(s_test_commands) / sizeof(s_test_commands[0]), "", false);
+    for (int i = 0; i < (int)(sizeof(s_execute_cases) / sizeof(s_execute_cases[0])); i++)
+    {
+        char line[SHELL_LINE_SIZE];
+        strncpy(line, s_execute_cases[i].line, sizeof(line) - 1);
+        line[sizeof(line) - 1] = 0;
+
+        int result = shell_execute(&sh, line);
+        if (result != s_execute_cases[i].result)
+        {
+            printf("FAIL, execute \"%s\", %d, expected %d\n", s_execute_cases[i].line, result, s_execute_cases[i].result);
+            s_failures++;
+        }
+    }
+
+    s_log[0] = 0;
+    shell_init(&sh, s_test_commands, sizeof(s_test_commands) / sizeof(s_test_commands[0]), "", false);
+    for (const char *c = s_script; *c != 0; c++)
+    {
+        shell_input_char(&sh, *c);
+    }
+    if (strcmp(s_log, s_script_log) != 0)
+    {
+        printf("FAIL, script\n  got      %s\n  expected %s\n", s_log, s_script_log);
+        s_failures++;
+    }
+
+    printf("shell_test, %s, failures, %d\n", (s_failures == 0) ? "pass" : "fail", s_failures);
+    return (s_failures == 0) ? 0 : 1;
+}
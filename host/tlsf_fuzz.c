@@ -0,0 +1,208 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Random malloc / free / realloc / memalign against a TLSF heap, with
+//  tlsf_check() after every step and every live block's contents verified
+//  before it's freed or moved.  Exits non-zero at the first failure.
+//
+//      tlsf_fuzz [steps] [seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tlsf.h"
+
+#define FUZZ_POOL_SIZE      (256 * 1024)
+#define FUZZ_SLOTS          256
+#define FUZZ_MAX_SIZE       (8 * 1024)
+#define FUZZ_MAX_ALIGN_SHIFT 12
+
+typedef struct
+{
+    uint8_t *ptr;
+    size_t size;
+    uint8_t fill;
+} fuzz_slot;
+
+static uint64_t s_fuzz_seed;
+
+static uint32_t fuzz_random(void)
+{
+    s_fuzz_seed = (s_fuzz_seed * 6364136223846793005ull) + 1442695040888963407ull;
+    return (uint32_t)(s_fuzz_seed >> 33);
+}
+
+//  Mostly small, sometimes up to FUZZ_MAX_SIZE
+static size_t fuzz_size(void)
+{
+    return ((fuzz_random() & 3) == 0) ? 1 + (fuzz_random() % FUZZ_MAX_SIZE) : 1 + (fuzz_random() % 128);
+}
+
+static bool fuzz_verify(const fuzz_slot *slot, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (slot->ptr[i] != (uint8_t)(slot->fill + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void fuzz_fill(fuzz_slot *slot)
+{
+    slot->fill = (uint8_t)fuzz_random();
+    for (size_t i = 0; i < slot->size; i++)
+    {
+        slot->ptr[i] = (uint8_t)(slot->fill + i);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t pool[FUZZ_POOL_SIZE];
+    static fuzz_slot slots[FUZZ_SLOTS];
+    static const char * const op_names[] = { "malloc", "free", "realloc", "memalign" };
+    tlsf_heap heap;
+    uint32_t steps = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100000;
+    uint32_t counts[4] = { 0 };
+    uint32_t failed_allocs = 0;
+
+    s_fuzz_seed = (argc > 2) ? strtoull(argv[2], NULL, 0) : 1;
+
+    if (!tlsf_create(&heap, pool, sizeof(pool)))
+    {
+        fprintf(stderr, "tlsf_create failed\n");
+        return 1;
+    }
+
+    for (uint32_t step = 0; step < steps; step++)
+    {
+        fuzz_slot *slot = &slots[fuzz_random() % FUZZ_SLOTS];
+        int op = fuzz_random() % 4;
+        size_t align = 0;
+
+        //  An empty slot can only be allocated
+        if ((slot->ptr == NULL) && ((op == 1) || (op == 2)))
+        {
+            op = 0;
+        }
+        if ((slot->ptr != NULL) && ((op == 0) || (op == 3)))
+        {
+            op = 1;
+        }
+
+        if ((slot->ptr != NULL) && !fuzz_verify(slot, slot->size))
+        {
+            fprintf(stderr, "step %u, %s, contents of a live block changed\n", step, op_names[op]);
+            return 1;
+        }
+
+        switch (op)
+        {
+            case 0:
+            case 3:
+                slot->size = fuzz_size();
+                if (op == 3)
+                {
+                    align = (size_t)1 << (fuzz_random() % (FUZZ_MAX_ALIGN_SHIFT + 1));
+                    slot->ptr = tlsf_memalign(&heap, align, slot->size);
+                }
+                else
+                {
+                    slot->ptr = tlsf_malloc(&heap, slot->size);
+                }
+                if (slot->ptr == NULL)
+                {
+                    failed_allocs++;
+                    break;
+                }
+                if ((align != 0) && (((uintptr_t)slot->ptr & (align - 1)) != 0))
+                {
+                    fprintf(stderr, "step %u, memalign %zu returned %p\n", step, align, (void *)slot->ptr);
+                    return 1;
+                }
+                if (tlsf_block_size(slot->ptr) < slot->size)
+                {
+                    fprintf(stderr, "step %u, %s, block smaller than asked for\n", step, op_names[op]);
+                    return 1;
+                }
+                fuzz_fill(slot);
+                break;
+
+            case 1:
+                tlsf_free(&heap, slot->ptr);
+                slot->ptr = NULL;
+                break;
+
+            default:
+            {
+                size_t size = fuzz_size();
+                uint8_t *moved = tlsf_realloc(&heap, slot->ptr, size);
+                if (moved == NULL)
+                {
+                    //  Failed, the old block is untouched
+                    failed_allocs++;
+                    break;
+                }
+                slot->ptr = moved;
+                if (!fuzz_verify(slot, (size < slot->size) ? size : slot->size))
+                {
+                    fprintf(stderr, "step %u, realloc lost the contents\n", step);
+                    return 1;
+                }
+                slot->size = size;
+                fuzz_fill(slot);
+                break;
+            }
+        }
+        counts[op]++;
+
+        if (!tlsf_check(&heap))
+        {
+            fprintf(stderr, "step %u, %s, tlsf_check failed\n", step, op_names[op]);
+            return 1;
+        }
+    }
+
+    //  Everything back should leave one free block the size of the pool
+    for (int i = 0; i < FUZZ_SLOTS; i++)
+    {
+        tlsf_free(&heap, slots[i].ptr);
+    }
+
+    tlsf_stats stats;
+    tlsf_get_stats(&heap, &stats);
+    if (!tlsf_check(&heap) || (stats.used_blocks != 0) || (stats.free_blocks != 1) || (stats.largest_free != stats.total_size))
+    {
+        fprintf(stderr, "heap not whole after freeing everything\n");
+        return 1;
+    }
+
+    printf("tlsf_fuzz, steps, %u, malloc, %u, free, %u, realloc, %u, memalign, %u, failed_allocs, %u, peak_used, %zu\n",
+           steps, counts[0], counts[1], counts[2], counts[3], failed_allocs, stats.peak_used_size);
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "pico/stdio/driver.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+#include "PicoMemPerf.h"
+#include "isolation.h"
+#include "result_out.h"
+
+static uint32_t s_isolation_mode = 0;
+static uint32_t s_isolation_irq_state;
+static bool s_isolation_usb_irq;
+
+static char s_isolation_log[ISOLATION_LOG_SIZE];
+static uint32_t s_isolation_log_used = 0;
+static uint32_t s_isolation_log_dropped = 0;
+
+static void isolation_log_out_chars(const char *buf, int len)
+{
+    for (int i = 0; i < len; i++)
+    {
+        if (s_isolation_log_used < ISOLATION_LOG_SIZE)
+        {
+            s_isolation_log[s_isolation_log_used++] = buf[i];
+        }
+        else
+        {
+            s_isolation_log_dropped++;
+        }
+    }
+}
+
+//  No CRLF translation into the log, the real drivers do it when it's flushed
+static stdio_driver_t s_isolation_log_driver =
+{
+    .out_chars = isolation_log_out_chars,
+#if PICO_STDIO_ENABLE_CRLF_SUPPORT
+    .crlf_enabled = false
+#endif
+};
+
+static void isolation_capture(bool capture)
+{
+    stdio_set_driver_enabled(&s_isolation_log_driver, capture);
+    stdio_filter_driver(capture ? &s_isolation_log_driver : NULL);
+}
+
+void isolation_set_mode(uint32_t flags)
+{
+    if ((s_isolation_mode & ISOLATE_DEFER_OUTPUT) && !(flags & ISOLATE_DEFER_OUTPUT))
+    {
+        isolation_flush();
+    }
+
+    //  Don't start capturing with output still queued for USB
+    if (!(s_isolation_mode & ISOLATE_DEFER_OUTPUT) && (flags & ISOLATE_DEFER_OUTPUT))
+    {
+        stdio_flush();
+        sleep_ms(ISOLATION_DRAIN_MS);
+    }
+
+    s_isolation_mode = flags;
+    isolation_capture((flags & ISOLATE_DEFER_OUTPUT) != 0);
+}
+
+uint32_t isolation_get_mode(void)
+{
+    return s_isolation_mode;
+}
+
+void __time_critical_func(isolate_begin)(void)
+{
+    if (s_isolation_mode & ISOLATE_PARK_USB)
+    {
+        s_isolation_usb_irq = irq_is_enabled(USBCTRL_IRQ);
+        irq_set_enabled(USBCTRL_IRQ, false);
+    }
+    if (s_isolation_mode & ISOLATE_NO_IRQ)
+    {
+        s_isolation_irq_state = save_and_disable_interrupts();
+    }
+}
+
+void __time_critical_func(isolate_end)(void)
+{
+    if (s_isolation_mode & ISOLATE_NO_IRQ)
+    {
+        restore_interrupts(s_isolation_irq_state);
+    }
+    if (s_isolation_mode & ISOLATE_PARK_USB)
+    {
+        irq_set_enabled(USBCTRL_IRQ, s_isolation_usb_irq);
+    }
+
+    //  Flush between regions rather than lose output, and give USB time to drain it
+    if ((s_isolation_mode & ISOLATE_DEFER_OUTPUT) && (s_isolation_log_used >= ISOLATION_HIGH_WATER))
+    {
+        isolation_flush();
+        sleep_ms(ISOLATION_DRAIN_MS);
+    }
+}
+
+void isolation_flush(void)
+{
+    bool capturing = (s_isolation_mode & ISOLATE_DEFER_OUTPUT) != 0;
+
+    if (capturing)
+    {
+        isolation_capture(false);
+    }
+
+    //  Binary results can't have their line ends translated
+    if (s_isolation_log_used != 0)
+    {
+        stdio_put_string(s_isolation_log, s_isolation_log_used, false, result_get_format() != RESULT_FORMAT_BINARY);
+    }
+    if (s_isolation_log_dropped != 0)
+    {
+        printf("Isolation log dropped, %lu\n", (long unsigned int)s_isolation_log_dropped);
+    }
+    stdio_flush();
+
+    s_isolation_log_used = 0;
+    s_isolation_log_dropped = 0;
+
+    if (capturing)
+    {
+        isolation_capture(true);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Isolated timed regions
+//
+//  Deferred output captures everything written through stdio in an SRAM log
+//  (a stdio driver that all output is filtered to) so nothing is queued for
+//  USB while a test runs, and flushes it afterwards.  Timed regions can also
+//  run with interrupts disabled, or with just the USB interrupt parked.
+//  Disabling interrupts holds off the USB stack for the whole region, keep
+//  loop scales small in that mode.
+
+#ifndef ISOLATION_H
+#define ISOLATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ISOLATE_DEFER_OUTPUT    0x01            //  Buffer stdio output in SRAM until isolation_flush()
+#define ISOLATE_NO_IRQ          0x02            //  Interrupts off inside isolate_begin() / isolate_end()
+#define ISOLATE_PARK_USB        0x04            //  Just the USB controller interrupt off
+
+#define ISOLATION_LOG_SIZE      (32 * 1024)
+#define ISOLATION_HIGH_WATER    (ISOLATION_LOG_SIZE * 3 / 4)
+#define ISOLATION_DRAIN_MS      20              //  Let USB finish sending a flush before the next timed region
+
+void isolation_set_mode(uint32_t flags);
+uint32_t isolation_get_mode(void);
+
+//  Wrap every timed region
+void isolate_begin(void);
+void isolate_end(void);
+
+//  Write out the SRAM log, safe to call in any mode
+void isolation_flush(void);
+
+#endif
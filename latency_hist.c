@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "latency_hist.h"
+
+void latency_hist_reset(latency_hist *hist)
+{
+    for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        hist->counts[i] = 0;
+    }
+    hist->count = 0;
+    hist->min = 0xFFFFFFFF;
+    hist->max = 0;
+    hist->sum = 0;
+}
+
+uint32_t latency_hist_bucket_low(uint32_t bucket)
+{
+    if (bucket < LATENCY_HIST_LINEAR)
+    {
+        return bucket;
+    }
+
+    uint32_t msb = (bucket >> LATENCY_HIST_SUB_BITS) + LATENCY_HIST_SUB_BITS - 1;
+    uint32_t sub = bucket & (LATENCY_HIST_SUB_COUNT - 1);
+    return (1u << msb) | (sub << (msb - LATENCY_HIST_SUB_BITS));
+}
+
+uint32_t latency_hist_bucket_high(uint32_t bucket)
+{
+    if (bucket < LATENCY_HIST_LINEAR)
+    {
+        return bucket;
+    }
+
+    uint32_t msb = (bucket >> LATENCY_HIST_SUB_BITS) + LATENCY_HIST_SUB_BITS - 1;
+    return latency_hist_bucket_low(bucket) + ((1u << (msb - LATENCY_HIST_SUB_BITS)) - 1);
+}
+
+uint32_t latency_hist_percentile(const latency_hist *hist, float fraction)
+{
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+
+    //  Rank of the sample we want, 1 based
+    uint64_t rank = (uint64_t)((double)fraction * hist->count + 0.5);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        seen += hist->counts[i];
+        if (seen >= rank)
+        {
+            uint32_t high = latency_hist_bucket_high(i);
+            return (high < hist->max) ? high : hist->max;
+        }
+    }
+
+    return hist->max;
+}
+
+uint32_t latency_hist_mean(const latency_hist *hist)
+{
+    return (hist->count != 0) ? (uint32_t)(hist->sum / hist->count) : 0;
+}
@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Log bucketed latency histogram
+//
+//  Values below 8 get their own bucket, above that every power of two is
+//  split into 4 sub-buckets (<= 25% error), which covers the full 32 bit
+//  range in 124 buckets.
+
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LATENCY_HIST_SUB_BITS   2
+#define LATENCY_HIST_SUB_COUNT  (1u << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_LINEAR     (2 * LATENCY_HIST_SUB_COUNT)
+#define LATENCY_HIST_BUCKETS    ((32 - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB_COUNT)
+
+typedef struct
+{
+    uint32_t counts[LATENCY_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} latency_hist;
+
+void latency_hist_reset(latency_hist *hist);
+
+static inline uint32_t latency_hist_bucket(uint32_t value)
+{
+    if (value < LATENCY_HIST_LINEAR)
+    {
+        return value;
+    }
+
+    uint32_t msb = 31 - __builtin_clz(value);
+    uint32_t sub = (value >> (msb - LATENCY_HIST_SUB_BITS)) & (LATENCY_HIST_SUB_COUNT - 1);
+    return ((msb - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS) + sub;
+}
+
+static inline void latency_hist_add(latency_hist *hist, uint32_t value)
+{
+    hist->counts[latency_hist_bucket(value)]++;
+    hist->count++;
+    hist->sum += value;
+    if (value < hist->min)
+    {
+        hist->min = value;
+    }
+    if (value > hist->max)
+    {
+        hist->max = value;
+    }
+}
+
+//  Smallest / largest value that lands in bucket
+uint32_t latency_hist_bucket_low(uint32_t bucket);
+uint32_t latency_hist_bucket_high(uint32_t bucket);
+
+//  Upper bound of the bucket holding the given fraction (0.5, 0.99, 0.999) of
+//  the samples, clamped to the exact max
+uint32_t latency_hist_percentile(const latency_hist *hist, float fraction);
+
+uint32_t latency_hist_mean(const latency_hist *hist);
+
+#endif
@@ -0,0 +1,358 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include "portable.h"
+#include "mem_kernels.h"
+
+uint32_t s_value = 0;
+
+//  Optional precomputed SRAM index table for the random kernels, replaces the
+//  inline LCG.  Indices are already reduced to s_index_table_size.
+uint32_t *s_index_table = NULL;
+uint32_t s_index_table_size = 0;
+
+bool index_table_init(uint32_t buffer_size)
+{
+    index_table_free();
+
+    s_index_table = malloc(buffer_size * sizeof(uint32_t));
+    if (s_index_table == NULL)
+    {
+        return false;
+    }
+
+    uint32_t seed_value = 0xDEADBEEF;
+    for (int i = 0; i < buffer_size; i++)
+    {
+        seed_value = (seed_value * 1103515245U + 12345U);
+        s_index_table[i] = is_power_of_two(buffer_size) ? (seed_value & (buffer_size - 1)) : range_reduce(seed_value, buffer_size);
+    }
+    s_index_table_size = buffer_size;
+
+    return true;
+}
+
+void index_table_free(void)
+{
+    free(s_index_table);
+    s_index_table = NULL;
+    s_index_table_size = 0;
+}
+
+static inline bool index_table_usable(uint32_t buffer_size)
+{
+    return (s_index_table != NULL) && (s_index_table_size == buffer_size);
+}
+
+//  Between passes over the buffer, read once per kernel run
+static mem_kernel_pass_hook s_pass_hook = NULL;
+
+#define KERNEL_PASS(hook)   do { if ((hook) != NULL) { (hook)(); } } while (0)
+
+void mem_kernel_set_pass_hook(mem_kernel_pass_hook hook)
+{
+    s_pass_hook = hook;
+}
+
+uint64_t __time_critical_func(memory_test)(uint32_t *buffer, uint32_t buffer_size, int loop_scale, bool read, bool rnd)
+{
+    uint64_t start = time_us_64();
+    int loop_count = 100 * loop_scale;
+    uint32_t value = 0;
+    mem_kernel_pass_hook pass_hook = s_pass_hook;
+
+    if (rnd && index_table_usable(buffer_size))
+    {
+        //  Random from the index table, same pass every loop
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value += buffer[s_index_table[i]];
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    buffer[s_index_table[i]] = value++;
+                }
+            }
+        }
+    }
+    else if (rnd && !is_power_of_two(buffer_size))
+    {
+        uint32_t seed_value = 0xDEADBEEF;
+
+        //  Random, any size
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value += buffer[range_reduce(seed_value, buffer_size)];
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    buffer[range_reduce(seed_value, buffer_size)] = value++;
+                }
+            }
+        }
+    }
+    else if (rnd)
+    {
+        uint32_t seed_value = 0xDEADBEEF;
+
+        //  Random
+        if (read)
+        {
+            //  Read
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value += buffer[seed_value & (buffer_size - 1)];
+                }
+            }
+        }
+        else
+        {
+            //  Write
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    buffer[seed_value & (buffer_size - 1)] = value++;
+                }
+            }
+        }
+    }
+    else
+    {
+        //  Seqential
+        if (read)
+        {
+            //  Read
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value += buffer[i];
+                }
+            }
+        }
+        else
+        {
+            //  Write
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    buffer[i] = value++;
+                }
+            }
+        }
+    }
+
+    uint64_t delta = time_us_64() - start;
+
+    s_value = value;
+
+    return delta;
+}
+
+//  memory_test() with every memory access replaced by a register operation,
+//  what's left is the loop, LCG / index table and masking cost.  Same loops
+//  in the same order, a read adds the index instead of loading it and a
+//  write xors the index into the value instead of storing it.
+uint64_t __time_critical_func(memory_test_overhead)(uint32_t buffer_size, int loop_scale, bool read, bool rnd)
+{
+    uint64_t start = time_us_64();
+    int loop_count = 100 * loop_scale;
+    uint32_t value = 0;
+    mem_kernel_pass_hook pass_hook = s_pass_hook;
+
+    if (rnd && index_table_usable(buffer_size))
+    {
+        //  Random from the index table
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value += s_index_table[i];
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value = (value + 1) ^ s_index_table[i];
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+    }
+    else if (rnd && !is_power_of_two(buffer_size))
+    {
+        uint32_t seed_value = 0xDEADBEEF;
+
+        //  Random, any size
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value += range_reduce(seed_value, buffer_size);
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value = (value + 1) ^ range_reduce(seed_value, buffer_size);
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+    }
+    else if (rnd)
+    {
+        uint32_t seed_value = 0xDEADBEEF;
+
+        //  Random
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value += seed_value & (buffer_size - 1);
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value = (value + 1) ^ (seed_value & (buffer_size - 1));
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+    }
+    else
+    {
+        //  Seqential
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value += i;
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                KERNEL_PASS(pass_hook);
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value++;
+                    KEEP_REGISTER(value);
+                }
+            }
+        }
+    }
+
+    uint64_t delta = time_us_64() - start;
+
+    s_value = value;
+
+    return delta;
+}
+
+//  Overhead is measured at 1 / CALIBRATION_DIVISOR of the loops and scaled up
+#define CALIBRATION_DIVISOR     10
+
+uint64_t calibrate_overhead(uint32_t buffer_size, int loop_scale, bool read, bool rnd)
+{
+    int calibration_scale = (loop_scale >= CALIBRATION_DIVISOR) ? (loop_scale / CALIBRATION_DIVISOR) : 1;
+
+    return (memory_test_overhead(buffer_size, calibration_scale, read, rnd) * loop_scale) / calibration_scale;
+}
@@ -0,0 +1,70 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Timed memory kernels, portable so the host can run the same loops
+
+#ifndef MEM_KERNELS_H
+#define MEM_KERNELS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//  Lemire's multiply-shift range reduction, maps a 32 bit value onto [0, range)
+//  without a divide, used when the buffer size isn't a power of two
+static inline uint32_t range_reduce(uint32_t value, uint32_t range)
+{
+    return (uint32_t)(((uint64_t)value * range) >> 32);
+}
+
+static inline bool is_power_of_two(uint32_t value)
+{
+    return (value & (value - 1)) == 0;
+}
+
+//  Keep a value in a register every iteration so the calibration loops aren't folded away
+#define KEEP_REGISTER(x)    __asm volatile("" : "+r"(x))
+
+//  Timed read / write kernel, buffer_size in words, runs 100 * loop_scale passes.
+//  Random kernels mask power of two sizes and range reduce any other size.
+uint64_t memory_test(uint32_t *buffer, uint32_t buffer_size, int loop_scale, bool read, bool rnd);
+
+//  Kernel results land here so the loops aren't optimised away
+extern uint32_t s_value;
+
+//  Same loops as memory_test() without the memory accesses, and that scaled
+//  from a shorter run
+uint64_t memory_test_overhead(uint32_t buffer_size, int loop_scale, bool read, bool rnd);
+uint64_t calibrate_overhead(uint32_t buffer_size, int loop_scale, bool read, bool rnd);
+
+//  Called before every pass over the buffer by memory_test() and the
+//  calibration alike, so its cost comes out with the overhead.  Lets a long
+//  run feed a watchdog, NULL for none.
+typedef void (*mem_kernel_pass_hook)(void);
+void mem_kernel_set_pass_hook(mem_kernel_pass_hook hook);
+
+//  Precomputed SRAM index table for the random kernels instead of the inline LCG
+bool index_table_init(uint32_t buffer_size);
+void index_table_free(void);
+
+#endif
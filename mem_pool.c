@@ -0,0 +1,198 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mem_pool.h"
+#include "portable.h"
+
+static inline uintptr_t align_up(uintptr_t x, uintptr_t align)
+{
+    return (x + (align - 1)) & ~(align - 1);
+}
+
+//  Pool
+
+bool mem_pool_init(mem_pool *pool, void *region, size_t region_size, size_t object_size)
+{
+    uint8_t *start = (uint8_t *)align_up((uintptr_t)region, MEM_PAGE_SIZE);
+    size_t lost = (size_t)(start - (uint8_t *)region);
+
+    pool->base = start;
+    pool->capacity = 0;
+    mem_pool_reset(pool);
+
+    if ((object_size == 0) || (region_size <= lost))
+    {
+        return false;
+    }
+    region_size -= lost;
+
+    //  Room for the free list link
+    if (object_size < sizeof(void *))
+    {
+        object_size = sizeof(void *);
+    }
+
+    if (object_size <= MEM_PAGE_SIZE)
+    {
+        pool->object_size = align_up(object_size, MEM_LINE_SIZE);
+        pool->objects_per_group = MEM_PAGE_SIZE / pool->object_size;
+        pool->group_stride = MEM_PAGE_SIZE;
+    }
+    else
+    {
+        pool->object_size = align_up(object_size, MEM_PAGE_SIZE);
+        pool->objects_per_group = 1;
+        pool->group_stride = pool->object_size;
+    }
+
+    //  Whole groups, plus whatever fits in the tail
+    size_t groups = region_size / pool->group_stride;
+    size_t tail = region_size - (groups * pool->group_stride);
+    pool->capacity = (uint32_t)(groups * pool->objects_per_group);
+    if (pool->objects_per_group > 1)
+    {
+        pool->capacity += (uint32_t)(tail / pool->object_size);
+    }
+
+    return pool->capacity != 0;
+}
+
+void *__time_critical_func(mem_pool_alloc)(mem_pool *pool)
+{
+    void *ptr = pool->free_list;
+
+    if (ptr != NULL)
+    {
+        pool->free_list = *(void **)ptr;
+    }
+    else if (pool->fresh_index < pool->capacity)
+    {
+        uint32_t group = pool->fresh_index / pool->objects_per_group;
+        uint32_t index = pool->fresh_index % pool->objects_per_group;
+        ptr = pool->base + (group * pool->group_stride) + (index * pool->object_size);
+        pool->fresh_index++;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    pool->used++;
+    return ptr;
+}
+
+void __time_critical_func(mem_pool_free)(mem_pool *pool, void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    *(void **)ptr = pool->free_list;
+    pool->free_list = ptr;
+    pool->used--;
+}
+
+bool mem_pool_owns(const mem_pool *pool, const void *ptr)
+{
+    if (((const uint8_t *)ptr < pool->base) || (pool->capacity == 0))
+    {
+        return false;
+    }
+
+    size_t offset = (size_t)((const uint8_t *)ptr - pool->base);
+    uint32_t group = offset / pool->group_stride;
+    size_t within = offset % pool->group_stride;
+    if ((within % pool->object_size) != 0)
+    {
+        return false;
+    }
+
+    uint32_t index = within / pool->object_size;
+    return (index < pool->objects_per_group) && (((group * pool->objects_per_group) + index) < pool->capacity);
+}
+
+void mem_pool_reset(mem_pool *pool)
+{
+    pool->fresh_index = 0;
+    pool->used = 0;
+    pool->free_list = NULL;
+}
+
+//  Arena
+
+void mem_arena_init(mem_arena *arena, void *region, size_t region_size)
+{
+    arena->base = (uint8_t *)region;
+    arena->end = (uint8_t *)region + region_size;
+    mem_arena_reset(arena);
+}
+
+void *__time_critical_func(mem_arena_alloc_aligned)(mem_arena *arena, size_t size, size_t align)
+{
+    if (align < MEM_LINE_SIZE)
+    {
+        align = MEM_LINE_SIZE;
+    }
+
+    uintptr_t start = align_up((uintptr_t)arena->next, align);
+    size = align_up(size, MEM_LINE_SIZE);
+
+    //  Move anything that fits in a page off the page break
+    if ((size <= MEM_PAGE_SIZE) && ((start / MEM_PAGE_SIZE) != ((start + size - 1) / MEM_PAGE_SIZE)))
+    {
+        start = align_up(start + 1, MEM_PAGE_SIZE);
+    }
+
+    if ((size == 0) || (start + size > (uintptr_t)arena->end) || (start < (uintptr_t)arena->next))
+    {
+        return NULL;
+    }
+
+    arena->wasted += start - (uintptr_t)arena->next;
+    arena->next = (uint8_t *)(start + size);
+
+    return (void *)start;
+}
+
+void *__time_critical_func(mem_arena_alloc)(mem_arena *arena, size_t size)
+{
+    return mem_arena_alloc_aligned(arena, size, MEM_LINE_SIZE);
+}
+
+void mem_arena_reset(mem_arena *arena)
+{
+    arena->next = (uint8_t *)align_up((uintptr_t)arena->base, MEM_LINE_SIZE);
+    arena->wasted = 0;
+}
+
+size_t mem_arena_used(const mem_arena *arena)
+{
+    return (size_t)(arena->next - arena->base);
+}
+
+size_t mem_arena_remaining(const mem_arena *arena)
+{
+    return (arena->next < arena->end) ? (size_t)(arena->end - arena->next) : 0;
+}
@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Fixed size pool and bump arena allocators
+//
+//  Both pack objects on XIP cache line boundaries and never let an object of
+//  up to a QMI page straddle a page break, so walking objects in allocation
+//  order touches each line and each PSRAM page once.  Regions are plain
+//  memory so they can be simulated on the host.
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define MEM_LINE_SIZE           8               //  XIP cache line
+#define MEM_PAGE_SIZE           1024            //  QMI M1 page break (QMI_M1_TIMING_PAGEBREAK_VALUE_1024)
+
+typedef struct
+{
+    uint8_t *base;                              //  Region start rounded up to a page
+    size_t object_size;                         //  Rounded up to a line (or page multiple when larger than a page)
+    size_t group_stride;                        //  Bytes per group of objects_per_group
+    uint32_t objects_per_group;
+    uint32_t capacity;
+    uint32_t fresh_index;                       //  Objects never handed out start here
+    uint32_t used;
+    void *free_list;
+} mem_pool;
+
+typedef struct
+{
+    uint8_t *base;
+    uint8_t *end;
+    uint8_t *next;
+    size_t wasted;                              //  Bytes skipped to keep objects off page breaks
+} mem_arena;
+
+//  Pool of object_size objects, false if not even one fits
+bool mem_pool_init(mem_pool *pool, void *region, size_t region_size, size_t object_size);
+void *mem_pool_alloc(mem_pool *pool);
+void mem_pool_free(mem_pool *pool, void *ptr);
+bool mem_pool_owns(const mem_pool *pool, const void *ptr);
+void mem_pool_reset(mem_pool *pool);
+
+void mem_arena_init(mem_arena *arena, void *region, size_t region_size);
+void *mem_arena_alloc(mem_arena *arena, size_t size);
+void *mem_arena_alloc_aligned(mem_arena *arena, size_t size, size_t align);
+void mem_arena_reset(mem_arena *arena);
+size_t mem_arena_used(const mem_arena *arena);
+size_t mem_arena_remaining(const mem_arena *arena);
+
+#endif
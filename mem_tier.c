@@ -0,0 +1,278 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include "portable.h"
+#include "mem_tier.h"
+
+#if PICO_ON_DEVICE
+#include <malloc.h>
+#include "hardware/xip_cache.h"
+#include "PicoMemPerf.h"
+
+#define SRAM_START      _u(0x20000000)
+#define SRAM_END        _u(0x20082000)
+#endif
+
+const mem_tier_policy mem_tier_default_policy =
+{
+    "HINTED",
+    {
+        [MEM_HINT_HOT]       = { MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE },
+        [MEM_HINT_LATENCY]   = { MEM_TIER_SRAM, MEM_TIER_PSRAM, MEM_TIER_PSRAM_NOCACHE },
+        [MEM_HINT_COLD]      = { MEM_TIER_PSRAM_NOCACHE, MEM_TIER_PSRAM, MEM_TIER_SRAM },
+        [MEM_HINT_STREAMING] = { MEM_TIER_PSRAM_NOCACHE, MEM_TIER_PSRAM, MEM_TIER_SRAM },
+    },
+    0xFFFFFFFF
+};
+
+static const mem_tier_policy *s_mem_tier_policy = &mem_tier_default_policy;
+static mem_tier_stats s_mem_tier_stats;
+
+
+//  Device backend, newlib heap and PSRAM heap
+
+#if PICO_ON_DEVICE
+
+//  XIP cache lines of a PSRAM heap block, by its cached address
+static inline uintptr_t psram_block_offset(const void *ptr)
+{
+    return ((uintptr_t)ptr - XIP_BASE) & ~(uintptr_t)7;
+}
+
+static inline uintptr_t psram_block_lines(const void *ptr)
+{
+    return ((((uintptr_t)ptr + tlsf_block_size((void *)ptr) + 7) & ~(uintptr_t)7) - ((uintptr_t)ptr & ~(uintptr_t)7));
+}
+
+static void *device_malloc(void *context, mem_tier tier, size_t size)
+{
+    switch (tier)
+    {
+        case MEM_TIER_SRAM:
+            //  Leave the reserve for everyone else
+            return (getFreeHeap() < size + MEM_TIER_SRAM_RESERVE) ? NULL : malloc(size);
+
+        case MEM_TIER_PSRAM:
+            return psram_malloc(size);
+
+        case MEM_TIER_PSRAM_NOCACHE:
+        {
+            void *ptr = psram_malloc(size);
+            if (ptr == NULL)
+            {
+                return NULL;
+            }
+
+            //  TLSF kept its free list links in the block through the cached
+            //  alias, written back later they'd land on top of the caller's
+            //  uncached writes
+            xip_cache_clean_range(psram_block_offset(ptr), psram_block_lines(ptr));
+            xip_cache_invalidate_range(psram_block_offset(ptr), psram_block_lines(ptr));
+            return PSRAM_NOCACHE(ptr);
+        }
+
+        default:
+            return NULL;
+    }
+}
+
+static void device_free(void *context, mem_tier tier, void *ptr)
+{
+    switch (tier)
+    {
+        case MEM_TIER_SRAM:
+            free(ptr);
+            break;
+
+        case MEM_TIER_PSRAM:
+            psram_free(ptr);
+            break;
+
+        case MEM_TIER_PSRAM_NOCACHE:
+        {
+            void *cached = (uint8_t *)ptr - XIP_NOCACHE_OFFSET;
+
+            //  Nothing cached of the block may outlive what was written uncached
+            xip_cache_invalidate_range(psram_block_offset(cached), psram_block_lines(cached));
+            psram_free(cached);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+static size_t device_block_size(void *context, mem_tier tier, void *ptr)
+{
+    if (tier == MEM_TIER_SRAM)
+    {
+        return malloc_usable_size(ptr);
+    }
+
+    return tlsf_block_size((tier == MEM_TIER_PSRAM_NOCACHE) ? (uint8_t *)ptr - XIP_NOCACHE_OFFSET : ptr);
+}
+
+static mem_tier device_tier_of(void *context, const void *ptr)
+{
+    uintptr_t address = (uintptr_t)ptr;
+
+    if ((address >= SRAM_START) && (address < SRAM_END))
+    {
+        return MEM_TIER_SRAM;
+    }
+    if ((address >= PSRAM_LOCATION) && (address < PSRAM_LOCATION + _psram_size))
+    {
+        return MEM_TIER_PSRAM;
+    }
+    if ((address >= PSRAM_LOCATION + XIP_NOCACHE_OFFSET) && (address < PSRAM_LOCATION + XIP_NOCACHE_OFFSET + _psram_size))
+    {
+        return MEM_TIER_PSRAM_NOCACHE;
+    }
+
+    return MEM_TIER_NONE;
+}
+
+static const mem_tier_backend s_mem_tier_device_backend = { device_malloc, device_free, device_block_size, device_tier_of, NULL };
+#define MEM_TIER_DEFAULT_BACKEND    (&s_mem_tier_device_backend)
+
+#else
+
+#define MEM_TIER_DEFAULT_BACKEND    NULL
+
+#endif
+
+static const mem_tier_backend *s_mem_tier_backend = MEM_TIER_DEFAULT_BACKEND;
+
+
+//  Policy and accounting
+
+void mem_tier_set_backend(const mem_tier_backend *backend)
+{
+    s_mem_tier_backend = (backend != NULL) ? backend : MEM_TIER_DEFAULT_BACKEND;
+}
+
+void mem_tier_set_policy(const mem_tier_policy *policy)
+{
+    s_mem_tier_policy = (policy != NULL) ? policy : &mem_tier_default_policy;
+}
+
+const mem_tier_policy *mem_tier_get_policy(void)
+{
+    return s_mem_tier_policy;
+}
+
+static void *tier_malloc(mem_tier tier, size_t size)
+{
+    //  Stay inside the policy's SRAM budget
+    if ((tier == MEM_TIER_SRAM) && (s_mem_tier_stats.bytes[MEM_TIER_SRAM] + size > s_mem_tier_policy->sram_budget))
+    {
+        return NULL;
+    }
+
+    return s_mem_tier_backend->malloc(s_mem_tier_backend->context, tier, size);
+}
+
+void *mem_tier_malloc(size_t size, mem_hint hint)
+{
+    if (hint >= MEM_HINT_COUNT)
+    {
+        hint = MEM_HINT_HOT;
+    }
+
+    for (int i = 0; (s_mem_tier_backend != NULL) && (i < MEM_TIER_COUNT); i++)
+    {
+        mem_tier tier = s_mem_tier_policy->order[hint][i];
+        if (tier == MEM_TIER_NONE)
+        {
+            break;
+        }
+
+        void *ptr = tier_malloc(tier, size);
+        if (ptr != NULL)
+        {
+            s_mem_tier_stats.bytes[tier] += s_mem_tier_backend->block_size(s_mem_tier_backend->context, tier, ptr);
+            s_mem_tier_stats.allocs[tier]++;
+            if (i != 0)
+            {
+                s_mem_tier_stats.fallbacks++;
+            }
+            return ptr;
+        }
+    }
+
+    s_mem_tier_stats.failures++;
+    return NULL;
+}
+
+void mem_tier_free(void *ptr)
+{
+    mem_tier tier = mem_tier_of(ptr);
+    if (tier == MEM_TIER_NONE)
+    {
+        return;
+    }
+
+    s_mem_tier_stats.bytes[tier] -= s_mem_tier_backend->block_size(s_mem_tier_backend->context, tier, ptr);
+    s_mem_tier_backend->free(s_mem_tier_backend->context, tier, ptr);
+}
+
+mem_tier mem_tier_of(const void *ptr)
+{
+    if ((ptr == NULL) || (s_mem_tier_backend == NULL))
+    {
+        return MEM_TIER_NONE;
+    }
+
+    return s_mem_tier_backend->tier_of(s_mem_tier_backend->context, ptr);
+}
+
+void mem_tier_get_stats(mem_tier_stats *stats)
+{
+    *stats = s_mem_tier_stats;
+}
+
+//  Live byte counts are kept, only the counters restart
+void mem_tier_reset_stats(void)
+{
+    for (int i = 0; i < MEM_TIER_COUNT; i++)
+    {
+        s_mem_tier_stats.allocs[i] = 0;
+    }
+    s_mem_tier_stats.fallbacks = 0;
+    s_mem_tier_stats.failures = 0;
+}
+
+char *mem_tier_name(mem_tier tier)
+{
+    switch (tier)
+    {
+        case MEM_TIER_SRAM:             return "SRAM";
+        case MEM_TIER_PSRAM:            return "PSRAM";
+        case MEM_TIER_PSRAM_NOCACHE:    return "PSRAM NOCACHE";
+        default:                        return "NONE";
+    }
+}
@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Tiered SRAM / PSRAM allocator
+//
+//  One malloc style entry point that takes a placement hint and picks SRAM
+//  (newlib heap), cached PSRAM or uncached PSRAM (PSRAM heap) from the
+//  active policy, falling back to the next tier when one is full.  The
+//  policy and accounting are portable, the heaps are behind a backend.
+
+#ifndef MEM_TIER_H
+#define MEM_TIER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    MEM_HINT_HOT,               //  Touched often, cache friendly
+    MEM_HINT_LATENCY,           //  Random access on a latency critical path
+    MEM_HINT_COLD,              //  Rarely touched, keep it out of the XIP cache
+    MEM_HINT_STREAMING,         //  Read / written once in order, keep it out of the XIP cache
+    MEM_HINT_COUNT
+} mem_hint;
+
+typedef enum
+{
+    MEM_TIER_SRAM,
+    MEM_TIER_PSRAM,
+    MEM_TIER_PSRAM_NOCACHE,
+    MEM_TIER_COUNT,
+    MEM_TIER_NONE = MEM_TIER_COUNT
+} mem_tier;
+
+typedef struct
+{
+    char * policy_name;
+    mem_tier order[MEM_HINT_COUNT][MEM_TIER_COUNT];     //  Tiers to try for each hint, fill every entry, MEM_TIER_NONE ends early
+    uint32_t sram_budget;                               //  Max bytes this allocator may place in SRAM
+} mem_tier_policy;
+
+typedef struct
+{
+    uint32_t bytes[MEM_TIER_COUNT];
+    uint32_t allocs[MEM_TIER_COUNT];
+    uint32_t fallbacks;                                 //  Allocations that missed their first choice tier
+    uint32_t failures;
+} mem_tier_stats;
+
+//  Where each tier's memory comes from.  On the device the default is the
+//  newlib heap and the PSRAM heap, the host tests give simulated regions.
+typedef struct
+{
+    void *(*malloc)(void *context, mem_tier tier, size_t size);
+    void (*free)(void *context, mem_tier tier, void *ptr);
+    size_t (*block_size)(void *context, mem_tier tier, void *ptr);
+    mem_tier (*tier_of)(void *context, const void *ptr);
+    void *context;
+} mem_tier_backend;
+
+//  SRAM left for the stack and everything else using newlib malloc
+#define MEM_TIER_SRAM_RESERVE   (32 * 1024)
+
+//  Hinted policy: hot / latency in SRAM, cold / streaming in uncached PSRAM
+extern const mem_tier_policy mem_tier_default_policy;
+
+//  NULL for the device heaps (none on the host).  Live allocations must go back to the backend they came from.
+void mem_tier_set_backend(const mem_tier_backend *backend);
+
+void mem_tier_set_policy(const mem_tier_policy *policy);
+const mem_tier_policy *mem_tier_get_policy(void);
+
+void *mem_tier_malloc(size_t size, mem_hint hint);
+void mem_tier_free(void *ptr);
+
+mem_tier mem_tier_of(const void *ptr);
+void mem_tier_get_stats(mem_tier_stats *stats);
+void mem_tier_reset_stats(void);
+
+char *mem_tier_name(mem_tier tier);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+
+#include "monitor_trend.h"
+
+void monitor_trend_reset(monitor_trend *trend)
+{
+    memset(trend, 0, sizeof(monitor_trend));
+}
+
+void monitor_trend_add(monitor_trend *trend, float value, float alpha)
+{
+    if (trend->samples == 0)
+    {
+        trend->ewma = value;
+        trend->min = value;
+        trend->max = value;
+    }
+    else
+    {
+        trend->ewma += alpha * (value - trend->ewma);
+        trend->min = (value < trend->min) ? value : trend->min;
+        trend->max = (value > trend->max) ? value : trend->max;
+    }
+
+    //  Running mean until the baseline is complete
+    if (trend->samples < MONITOR_BASELINE_SAMPLES)
+    {
+        trend->baseline += (value - trend->baseline) / (float)(trend->samples + 1);
+    }
+
+    trend->last = value;
+    trend->samples++;
+}
+
+bool monitor_trend_settled(const monitor_trend *trend)
+{
+    return trend->samples >= MONITOR_BASELINE_SAMPLES;
+}
+
+float monitor_trend_drift(const monitor_trend *trend)
+{
+    return monitor_trend_settled(trend) ? (trend->ewma - trend->baseline) : 0.0f;
+}
+
+float monitor_trend_drift_pct(const monitor_trend *trend)
+{
+    return (monitor_trend_settled(trend) && (trend->baseline != 0.0f)) ? (100.0f * (trend->ewma - trend->baseline) / trend->baseline) : 0.0f;
+}
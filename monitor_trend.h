@@ -0,0 +1,59 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Running trend of one measurement for the background monitor: last,
+//  EWMA, min, max, and the mean of the first few samples as the baseline
+//  that drift is measured from.  Portable, the host build has it too.
+
+#ifndef MONITOR_TREND_H
+#define MONITOR_TREND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MONITOR_BASELINE_SAMPLES    4
+
+typedef struct
+{
+    uint32_t samples;
+    float last;
+    float ewma;
+    float min;
+    float max;
+    float baseline;                     //  Mean of the first MONITOR_BASELINE_SAMPLES
+} monitor_trend;
+
+void monitor_trend_reset(monitor_trend *trend);
+
+//  alpha is the weight of the new sample, 0..1
+void monitor_trend_add(monitor_trend *trend, float value, float alpha);
+
+//  Baseline complete, drift means something
+bool monitor_trend_settled(const monitor_trend *trend);
+
+//  EWMA less the baseline, and as a percentage of it
+float monitor_trend_drift(const monitor_trend *trend);
+float monitor_trend_drift_pct(const monitor_trend *trend);
+
+#endif
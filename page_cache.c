@@ -0,0 +1,203 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "page_cache.h"
+#include "portable.h"
+
+static inline size_t align_up(size_t x, size_t align)
+{
+    return (x + (align - 1)) & ~(align - 1);
+}
+
+static inline bool is_power_of_two(uint32_t x)
+{
+    return (x != 0) && ((x & (x - 1)) == 0);
+}
+
+size_t page_cache_workspace_size(const page_cache_config *config)
+{
+    size_t lines = config->sets * config->ways;
+
+    return (lines * config->page_size) + align_up(lines * sizeof(page_cache_entry), 8) + config->sets;
+}
+
+bool page_cache_init(page_cache *cache, const page_cache_config *config, void *workspace, size_t workspace_size, const page_cache_backend *backend)
+{
+    if (!is_power_of_two(config->page_size) || (config->page_size < PAGE_CACHE_MIN_PAGE) || (config->page_size > PAGE_CACHE_MAX_PAGE) ||
+        !is_power_of_two(config->sets) || (config->ways == 0) || (config->ways > PAGE_CACHE_MAX_WAYS) ||
+        (workspace_size < page_cache_workspace_size(config)) || (((uintptr_t)workspace & 7) != 0))
+    {
+        return false;
+    }
+
+    size_t lines = config->sets * config->ways;
+
+    cache->config = *config;
+    cache->backend = *backend;
+    cache->page_shift = __builtin_ctz(config->page_size);
+    cache->page_mask = config->page_size - 1;
+    cache->data = (uint8_t *)workspace;
+    cache->entries = (page_cache_entry *)(cache->data + (lines * config->page_size));
+    cache->hands = (uint8_t *)cache->entries + align_up(lines * sizeof(page_cache_entry), 8);
+
+    page_cache_stats empty = { 0 };
+    cache->stats = empty;
+
+    page_cache_invalidate(cache);
+
+    return true;
+}
+
+static uint32_t __time_critical_func(choose_victim)(page_cache *cache, uint32_t set, page_cache_entry *entries)
+{
+    uint32_t ways = cache->config.ways;
+
+    for (uint32_t way = 0; way < ways; way++)
+    {
+        if (entries[way].tag == PAGE_CACHE_INVALID)
+        {
+            return way;
+        }
+    }
+
+    if (cache->config.policy == PAGE_CACHE_CLOCK)
+    {
+        //  Second chance, clear reference bits until we find one already clear
+        while (true)
+        {
+            uint32_t way = cache->hands[set];
+            cache->hands[set] = (way + 1 < ways) ? way + 1 : 0;
+            if (entries[way].stamp == 0)
+            {
+                return way;
+            }
+            entries[way].stamp = 0;
+        }
+    }
+
+    uint32_t victim = 0;
+    for (uint32_t way = 1; way < ways; way++)
+    {
+        //  Wrap safe oldest
+        if ((int32_t)(entries[way].stamp - entries[victim].stamp) < 0)
+        {
+            victim = way;
+        }
+    }
+    return victim;
+}
+
+uint8_t *__time_critical_func(page_cache_lookup)(page_cache *cache, uint32_t offset, bool write)
+{
+    uint32_t page = offset >> cache->page_shift;
+    uint32_t set = page & (cache->config.sets - 1);
+    uint32_t first = set * cache->config.ways;
+    page_cache_entry *entries = &cache->entries[first];
+    uint32_t way;
+
+    cache->stats.lookups++;
+
+    for (way = 0; way < cache->config.ways; way++)
+    {
+        if (entries[way].tag == page)
+        {
+            break;
+        }
+    }
+
+    uint8_t *data;
+
+    if (way == cache->config.ways)
+    {
+        //  Miss
+        cache->stats.misses++;
+        way = choose_victim(cache, set, entries);
+        data = cache->data + ((first + way) << cache->page_shift);
+
+        if ((entries[way].tag != PAGE_CACHE_INVALID) && entries[way].dirty)
+        {
+            cache->backend.write_back(cache->backend.context, entries[way].tag << cache->page_shift, data, cache->config.page_size);
+            cache->stats.write_backs++;
+        }
+
+        cache->backend.fill(cache->backend.context, data, page << cache->page_shift, cache->config.page_size);
+        entries[way].tag = page;
+        entries[way].dirty = false;
+    }
+    else
+    {
+        data = cache->data + ((first + way) << cache->page_shift);
+    }
+
+    entries[way].stamp = (cache->config.policy == PAGE_CACHE_CLOCK) ? 1 : ++cache->tick;
+    if (write)
+    {
+        entries[way].dirty = true;
+    }
+
+    cache->last_page = page;
+    cache->last_data = data;
+    cache->last_dirty = entries[way].dirty;
+
+    return data + (offset & cache->page_mask);
+}
+
+void page_cache_flush(page_cache *cache)
+{
+    uint32_t lines = cache->config.sets * cache->config.ways;
+
+    for (uint32_t line = 0; line < lines; line++)
+    {
+        page_cache_entry *entry = &cache->entries[line];
+        if ((entry->tag != PAGE_CACHE_INVALID) && entry->dirty)
+        {
+            cache->backend.write_back(cache->backend.context, entry->tag << cache->page_shift, cache->data + (line << cache->page_shift), cache->config.page_size);
+            cache->stats.write_backs++;
+            entry->dirty = false;
+        }
+    }
+
+    cache->last_dirty = false;
+}
+
+void page_cache_invalidate(page_cache *cache)
+{
+    uint32_t lines = cache->config.sets * cache->config.ways;
+
+    for (uint32_t line = 0; line < lines; line++)
+    {
+        cache->entries[line].tag = PAGE_CACHE_INVALID;
+        cache->entries[line].stamp = 0;
+        cache->entries[line].dirty = false;
+    }
+    for (uint32_t set = 0; set < cache->config.sets; set++)
+    {
+        cache->hands[set] = 0;
+    }
+
+    cache->tick = 0;
+    cache->last_page = PAGE_CACHE_INVALID;
+    cache->last_data = NULL;
+    cache->last_dirty = false;
+}
@@ -0,0 +1,132 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Software managed SRAM page cache in front of PSRAM
+//
+//  Set associative cache of page_size pages held in an SRAM workspace, with
+//  LRU or CLOCK replacement and write-back of dirty pages.  Pages are moved
+//  by a backend (DMA on the device, a simulated slow store on the host) and
+//  addressed by byte offset into the backing store.
+
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define PAGE_CACHE_MIN_PAGE     256
+#define PAGE_CACHE_MAX_PAGE     4096
+#define PAGE_CACHE_MAX_WAYS     16
+#define PAGE_CACHE_INVALID      0xFFFFFFFFu
+
+typedef enum
+{
+    PAGE_CACHE_LRU,
+    PAGE_CACHE_CLOCK
+} page_cache_policy;
+
+typedef struct
+{
+    uint32_t page_size;                 //  Power of two, PAGE_CACHE_MIN_PAGE - PAGE_CACHE_MAX_PAGE
+    uint32_t sets;                      //  Power of two
+    uint32_t ways;                      //  1 - PAGE_CACHE_MAX_WAYS
+    page_cache_policy policy;
+} page_cache_config;
+
+typedef struct
+{
+    void (*fill)(void *context, void *dst, uint32_t offset, uint32_t size);
+    void (*write_back)(void *context, uint32_t offset, const void *src, uint32_t size);
+    void *context;
+} page_cache_backend;
+
+typedef struct
+{
+    uint32_t tag;                       //  Page number or PAGE_CACHE_INVALID
+    uint32_t stamp;                     //  LRU: last use, CLOCK: referenced
+    bool dirty;
+} page_cache_entry;
+
+typedef struct
+{
+    uint32_t lookups;                   //  Slow path only, repeat hits on the last page aren't counted
+    uint32_t misses;
+    uint32_t write_backs;
+} page_cache_stats;
+
+typedef struct
+{
+    page_cache_config config;
+    page_cache_backend backend;
+
+    uint32_t page_shift;
+    uint32_t page_mask;
+    uint8_t *data;                      //  sets * ways pages
+    page_cache_entry *entries;          //  sets * ways
+    uint8_t *hands;                     //  CLOCK hand per set
+    uint32_t tick;
+
+    //  Fast path for repeat accesses to the same page
+    uint32_t last_page;
+    uint8_t *last_data;
+    bool last_dirty;
+
+    page_cache_stats stats;
+} page_cache;
+
+//  SRAM needed for the pages and the bookkeeping
+size_t page_cache_workspace_size(const page_cache_config *config);
+
+bool page_cache_init(page_cache *cache, const page_cache_config *config, void *workspace, size_t workspace_size, const page_cache_backend *backend);
+
+//  Pointer to offset in the cache, valid until the next lookup
+uint8_t *page_cache_lookup(page_cache *cache, uint32_t offset, bool write);
+
+//  Write back every dirty page
+void page_cache_flush(page_cache *cache);
+
+//  Drop every page without writing back, use after the backing store changed underneath
+void page_cache_invalidate(page_cache *cache);
+
+static inline uint32_t page_cache_read32(page_cache *cache, uint32_t offset)
+{
+    if ((offset >> cache->page_shift) == cache->last_page)
+    {
+        return *(uint32_t *)(cache->last_data + (offset & cache->page_mask));
+    }
+    return *(uint32_t *)page_cache_lookup(cache, offset, false);
+}
+
+static inline void page_cache_write32(page_cache *cache, uint32_t offset, uint32_t value)
+{
+    if (((offset >> cache->page_shift) == cache->last_page) && cache->last_dirty)
+    {
+        *(uint32_t *)(cache->last_data + (offset & cache->page_mask)) = value;
+        return;
+    }
+    *(uint32_t *)page_cache_lookup(cache, offset, true) = value;
+}
+
+#endif
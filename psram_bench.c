@@ -0,0 +1,440 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "PicoMemPerf.h"
+#include "psram_bench.h"
+#include "psram_dma.h"
+#include "page_cache.h"
+#include "psram_stream.h"
+#include "write_combine.h"
+
+//  Kernel shapes shared by the benchmarks here
+typedef struct
+{
+    bool read;
+    bool random;
+    char * test_name;
+} psram_bench_kernel;
+
+static const psram_bench_kernel s_psram_bench_kernels[] =
+{
+    { true, false, "SEQ" },
+    { true, true, "RND" },
+    { false, false, "SEQ" },
+    { false, true, "RND" },
+};
+
+#define PSRAM_BENCH_KERNELS     (sizeof(s_psram_bench_kernels) / sizeof(psram_bench_kernel))
+
+
+//  Page cache
+
+#define PAGE_BENCH_LOOP_SCALE   1
+#define PAGE_BENCH_CACHE_SIZE   (32 * 1024)     //  Half of the 64K test buffer
+
+typedef struct
+{
+    page_cache_config config;
+    char * test_name;
+} page_bench_config;
+
+static const page_bench_config s_page_bench_configs[] =
+{
+    { { 256, PAGE_BENCH_CACHE_SIZE / (256 * 4), 4, PAGE_CACHE_LRU }, "PC 256 4W LRU" },
+    { { 1024, PAGE_BENCH_CACHE_SIZE / (1024 * 4), 4, PAGE_CACHE_LRU }, "PC 1K 4W LRU" },
+    { { 4096, PAGE_BENCH_CACHE_SIZE / (4096 * 4), 4, PAGE_CACHE_LRU }, "PC 4K 4W LRU" },
+    { { 1024, PAGE_BENCH_CACHE_SIZE / (1024 * 4), 4, PAGE_CACHE_CLOCK }, "PC 1K 4W CLOCK" },
+    { { 1024, PAGE_BENCH_CACHE_SIZE / 1024, 1, PAGE_CACHE_LRU }, "PC 1K DIRECT" },
+};
+
+//  memory_test() with every access going through the page cache, includes the final flush
+uint64_t __time_critical_func(page_cache_test)(page_cache *cache, uint32_t buffer_size, int loop_scale, bool read, bool rnd)
+{
+    uint64_t start = time_us_64();
+    int loop_count = 100 * loop_scale;
+    uint32_t value = 0;
+
+    if (rnd)
+    {
+        uint32_t seed_value = 0xDEADBEEF;
+
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    value += page_cache_read32(cache, (seed_value & (buffer_size - 1)) * sizeof(uint32_t));
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    seed_value = (seed_value * 1103515245U + 12345U);
+                    page_cache_write32(cache, (seed_value & (buffer_size - 1)) * sizeof(uint32_t), value++);
+                }
+            }
+        }
+    }
+    else
+    {
+        if (read)
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    value += page_cache_read32(cache, i * sizeof(uint32_t));
+                }
+            }
+        }
+        else
+        {
+            for (int loop = 0; loop < loop_count; loop++)
+            {
+                for (int i = 0; i < buffer_size; i++)
+                {
+                    page_cache_write32(cache, i * sizeof(uint32_t), value++);
+                }
+            }
+        }
+    }
+
+    page_cache_flush(cache);
+
+    uint64_t delta = time_us_64() - start;
+
+    s_value = value;
+
+    return delta;
+}
+
+void run_page_cache_bench(void)
+{
+    page_cache_backend backend;
+
+    if (!psram_dma_init())
+    {
+        printf("Page cache bench, no DMA channel\n");
+        return;
+    }
+
+    psram_page_cache_backend(&backend, s_psram_test_memory);
+
+    for (int k = 0; k < PSRAM_BENCH_KERNELS; k++)
+    {
+        const psram_bench_kernel *kernel = &s_psram_bench_kernels[k];
+        const char *direction = kernel->read ? "READ" : "WRITE";
+
+        uint64_t cached = memory_test(s_psram_test_memory, TEST_SIZE, PAGE_BENCH_LOOP_SCALE, kernel->read, kernel->random);
+        uint64_t uncached = memory_test((uint32_t *)PSRAM_NOCACHE(s_psram_test_memory), TEST_SIZE, PAGE_BENCH_LOOP_SCALE, kernel->read, kernel->random);
+
+        printf("Page cache, %s PSRAM %s, %d, %d\n", kernel->test_name, direction, TEST_SIZE, (int)cached);
+        printf("Page cache, %s PSRAM NOCACHE %s, %d, %d\n", kernel->test_name, direction, TEST_SIZE, (int)uncached);
+
+        for (int i = 0; i < (sizeof(s_page_bench_configs) / sizeof(page_bench_config)); i++)
+        {
+            page_cache cache;
+            const page_bench_config *config = &s_page_bench_configs[i];
+            size_t workspace_size = page_cache_workspace_size(&config->config);
+            void *workspace = malloc(workspace_size);
+
+            if ((workspace == NULL) || !page_cache_init(&cache, &config->config, workspace, workspace_size, &backend))
+            {
+                printf("Page cache, %s, failed to create cache\n", config->test_name);
+                free(workspace);
+                continue;
+            }
+
+            uint64_t result = page_cache_test(&cache, TEST_SIZE, PAGE_BENCH_LOOP_SCALE, kernel->read, kernel->random);
+
+            printf("Page cache, %s %s %s, %d, %d, lookups, %lu, misses, %lu, write_backs, %lu\n", kernel->test_name, config->test_name, direction,
+                   TEST_SIZE, (int)result, (long unsigned int)cache.stats.lookups, (long unsigned int)cache.stats.misses, (long unsigned int)cache.stats.write_backs);
+
+            free(workspace);
+        }
+    }
+}
+
+
+//  Streaming pipeline
+
+#define STREAM_BENCH_LOOP_SCALE 10
+#define STREAM_BENCH_MAX_CHUNK  4096            //  Words
+
+static const uint32_t s_stream_bench_chunks[] = { 64, 256, 1024, 4096 };
+
+uint64_t __time_critical_func(stream_test)(const uint32_t *buffer, uint32_t buffer_size, uint32_t *chunk_buffer, uint32_t chunk_words, int loop_scale, uint64_t *stall_us)
+{
+    int loop_count = 100 * loop_scale;
+    uint32_t value = 0;
+    psram_stream stream;
+    const uint32_t *chunk;
+    uint32_t words;
+
+    //  Claiming the channel and cleaning the source is set up, not streaming, so
+    //  it's done before the clock starts and each pass just rewinds
+    *stall_us = 0;
+    if (!psram_stream_init(&stream, buffer, buffer_size, chunk_buffer, chunk_words))
+    {
+        psram_stream_deinit(&stream);
+        return 0;
+    }
+
+    uint64_t start = time_us_64();
+
+    for (int loop = 0; loop < loop_count; loop++)
+    {
+        while ((chunk = psram_stream_next(&stream, &words)) != NULL)
+        {
+            for (int i = 0; i < words; i++)
+            {
+                value += chunk[i];
+            }
+        }
+        psram_stream_rewind(&stream);
+    }
+
+    uint64_t delta = time_us_64() - start;
+
+    *stall_us = stream.stall_us;
+    psram_stream_deinit(&stream);
+
+    s_value = value;
+
+    return delta;
+}
+
+//  MB/s * 100 for bytes moved in us
+static int throughput(uint64_t bytes, uint64_t us)
+{
+    return (us != 0) ? (int)((bytes * 100) / us) : 0;
+}
+
+void run_stream_bench(void)
+{
+    uint32_t *chunk_buffer = malloc(2 * STREAM_BENCH_MAX_CHUNK * sizeof(uint32_t));
+    uint64_t bytes = (uint64_t)TEST_SIZE * sizeof(uint32_t) * 100 * STREAM_BENCH_LOOP_SCALE;
+
+    if (chunk_buffer == NULL)
+    {
+        printf("Stream bench, failed to get buffer\n");
+        return;
+    }
+
+    //  Direct reads for reference
+    uint64_t sram = memory_test(s_test_memory, TEST_SIZE, STREAM_BENCH_LOOP_SCALE, true, false);
+    uint64_t cached = memory_test(s_psram_test_memory, TEST_SIZE, STREAM_BENCH_LOOP_SCALE, true, false);
+    uint64_t uncached = memory_test((uint32_t *)PSRAM_NOCACHE(s_psram_test_memory), TEST_SIZE, STREAM_BENCH_LOOP_SCALE, true, false);
+
+    printf("Stream, SEQ SRAM READ, %d, %d, MBps_x100, %d\n", TEST_SIZE, (int)sram, throughput(bytes, sram));
+    printf("Stream, SEQ PSRAM READ, %d, %d, MBps_x100, %d\n", TEST_SIZE, (int)cached, throughput(bytes, cached));
+    printf("Stream, SEQ PSRAM NOCACHE READ, %d, %d, MBps_x100, %d\n", TEST_SIZE, (int)uncached, throughput(bytes, uncached));
+
+    for (int i = 0; i < (sizeof(s_stream_bench_chunks) / sizeof(uint32_t)); i++)
+    {
+        uint32_t chunk_words = s_stream_bench_chunks[i];
+        uint64_t stall_us;
+
+        uint64_t result = stream_test(s_psram_test_memory, TEST_SIZE, chunk_buffer, chunk_words, STREAM_BENCH_LOOP_SCALE, &stall_us);
+
+        printf("Stream, SEQ PSRAM STREAM READ, %d, %d, MBps_x100, %d, chunk_bytes, %d, stall_us, %d\n", TEST_SIZE, (int)result,
+               throughput(bytes, result), (int)(chunk_words * sizeof(uint32_t)), (int)stall_us);
+    }
+
+    free(chunk_buffer);
+}
+
+
+//  Write combining
+
+#define COMBINE_BENCH_LOOP_SCALE    2
+#define COMBINE_BENCH_RUN           64          //  Writes before the window moves
+
+typedef struct
+{
+    uint32_t window;                            //  Words, power of two
+    bool add;                                   //  Histogram style increments
+    char * test_name;
+} combine_bench_workload;
+
+static const combine_bench_workload s_combine_bench_workloads[] =
+{
+    { TEST_SIZE, false, "RND PSRAM WRITE" },
+    { 1024, false, "RND 4K PSRAM WRITE" },
+    { 256, false, "RND 1K PSRAM WRITE" },
+    { TEST_SIZE, true, "RND PSRAM HIST" },
+};
+
+static const uint32_t s_combine_bench_capacities[] = { 0, 256, 1024, 4096 };
+
+//  Random writes confined to a window that jumps every COMBINE_BENCH_RUN writes, direct when combine is NULL
+uint64_t __time_critical_func(combine_test)(uint32_t *buffer, uint32_t buffer_size, write_combine *combine, const combine_bench_workload *workload, int loop_scale)
+{
+    uint64_t start = time_us_64();
+    int loop_count = 100 * loop_scale;
+    uint32_t value = 0;
+    uint32_t seed_value = 0xDEADBEEF;
+    uint32_t base = 0;
+    uint32_t window_mask = workload->window - 1;
+
+    for (int loop = 0; loop < loop_count; loop++)
+    {
+        for (int i = 0; i < buffer_size; i++)
+        {
+            seed_value = (seed_value * 1103515245U + 12345U);
+            if ((i & (COMBINE_BENCH_RUN - 1)) == 0)
+            {
+                base = seed_value & (buffer_size - 1) & ~window_mask;
+            }
+            uint32_t index = base + ((seed_value >> 8) & window_mask);
+
+            if (combine != NULL)
+            {
+                if (workload->add)
+                {
+                    write_combine_add(combine, index, 1);
+                }
+                else
+                {
+                    write_combine_store(combine, index, value++);
+                }
+            }
+            else if (workload->add)
+            {
+                buffer[index] += 1;
+            }
+            else
+            {
+                buffer[index] = value++;
+            }
+        }
+    }
+
+    if (combine != NULL)
+    {
+        write_combine_flush(combine);
+    }
+
+    return time_us_64() - start;
+}
+
+void run_write_combine_bench(void)
+{
+    for (int w = 0; w < (sizeof(s_combine_bench_workloads) / sizeof(combine_bench_workload)); w++)
+    {
+        const combine_bench_workload *workload = &s_combine_bench_workloads[w];
+
+        for (int c = 0; c < (sizeof(s_combine_bench_capacities) / sizeof(uint32_t)); c++)
+        {
+            uint32_t capacity = s_combine_bench_capacities[c];
+            write_combine combine;
+            void *workspace = NULL;
+
+            if (capacity != 0)
+            {
+                workspace = malloc(write_combine_workspace_size(capacity));
+                if (!write_combine_init(&combine, s_psram_test_memory, TEST_SIZE, workspace, capacity))
+                {
+                    printf("Write combine, %s, %d, failed to create buffer\n", workload->test_name, (int)capacity);
+                    free(workspace);
+                    continue;
+                }
+            }
+
+            uint64_t result = combine_test(s_psram_test_memory, TEST_SIZE, (capacity != 0) ? &combine : NULL, workload, COMBINE_BENCH_LOOP_SCALE);
+
+            if (capacity != 0)
+            {
+                printf("Write combine, %s, %d, %d, capacity, %d, applied, %lu, pages, %lu\n", workload->test_name, TEST_SIZE, (int)result,
+                       (int)capacity, (long unsigned int)combine.stats.applied, (long unsigned int)combine.stats.pages);
+            }
+            else
+            {
+                printf("Write combine, %s, %d, %d, capacity, 0\n", workload->test_name, TEST_SIZE, (int)result);
+            }
+
+            free(workspace);
+        }
+    }
+}
+
+
+//  Address heatmap
+
+void run_heatmap(const heatmap_config *config)
+{
+    uint32_t window_bytes = config->window_words * sizeof(uint32_t);
+    uint64_t accesses = (uint64_t)config->window_words * 100 * config->loop_scale;
+
+    if ((config->step_bytes == 0) || (_psram_size < window_bytes))
+    {
+        printf("Heatmap, bad config\n");
+        return;
+    }
+
+    //  Same loops at every offset, so calibrate once
+    uint64_t rnd_overhead = calibrate_overhead(config->window_words, config->loop_scale, true, true);
+    uint64_t seq_overhead = calibrate_overhead(config->window_words, config->loop_scale, true, false);
+
+    result_csv_line("Heatmap, offset, address, row, column, rnd_read_ns, seq_read_MBps\n");
+
+    for (uint32_t offset = 0; offset + window_bytes <= _psram_size; offset += config->step_bytes)
+    {
+        uint8_t *window = (uint8_t *)PSRAM_LOCATION + offset;
+        if (config->nocache)
+        {
+            window = PSRAM_NOCACHE(window);
+        }
+
+        uint64_t rnd = memory_test((uint32_t *)window, config->window_words, config->loop_scale, true, true);
+        uint64_t seq = memory_test((uint32_t *)window, config->window_words, config->loop_scale, true, false);
+
+        rnd = (rnd > rnd_overhead) ? (rnd - rnd_overhead) : 0;
+        seq = (seq > seq_overhead) ? (seq - seq_overhead) : 0;
+
+        float rnd_ns = (float)(rnd * 1000) / (float)accesses;
+        float seq_mbps = (seq != 0) ? (float)(accesses * sizeof(uint32_t)) / (float)seq : 0.0f;
+
+        result_record record;
+
+        result_begin(&record, "Heatmap");
+        result_u64(&record, "offset", offset);
+        result_hex(&record, "address", (uint32_t)(uintptr_t)window);
+        result_u64(&record, "row", offset / HEATMAP_ROW_BYTES);
+        result_u64(&record, "column", (offset % HEATMAP_ROW_BYTES) / config->step_bytes);
+        result_f32(&record, "rnd_read_ns", rnd_ns);
+        result_f32(&record, "seq_read_MBps", seq_mbps);
+        result_end(&record);
+    }
+}
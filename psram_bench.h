@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  PSRAM access strategy benchmarks
+
+#ifndef PSRAM_BENCH_H
+#define PSRAM_BENCH_H
+
+//  SEQ / RND kernels through the software page cache vs direct cached and
+//  uncached PSRAM
+void run_page_cache_bench(void);
+
+//  SEQ read / sum through the DMA ping-pong pipeline at several chunk sizes
+void run_stream_bench(void);
+
+//  Scattered writes / increments direct vs through the write-combining buffer
+//  at several buffer sizes and write localities
+void run_write_combine_bench(void);
+
+//  Read latency / bandwidth of a window slid across the whole PSRAM
+#define HEATMAP_WINDOW_WORDS    4096            //  16K
+#define HEATMAP_STEP_BYTES      (64 * 1024)
+#define HEATMAP_ROW_BYTES       (1024 * 1024)   //  Heatmap row, for pivoting the CSV
+#define HEATMAP_LOOP_SCALE      1
+
+typedef struct
+{
+    uint32_t window_words;                      //  Power of two
+    uint32_t step_bytes;
+    int loop_scale;
+    bool nocache;                               //  Through the uncached window, so the XIP cache doesn't hide the device
+} heatmap_config;
+
+//  Emits a "Heatmap" CSV row per offset, reads only so the PSRAM heap survives
+void run_heatmap(const heatmap_config *config);
+
+#endif
@@ -0,0 +1,92 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/xip_cache.h"
+
+#include "PicoMemPerf.h"
+#include "psram_dma.h"
+
+static int s_psram_dma_channel = -1;
+
+bool psram_dma_init(void)
+{
+    if (s_psram_dma_channel < 0)
+    {
+        s_psram_dma_channel = dma_claim_unused_channel(false);
+    }
+
+    return s_psram_dma_channel >= 0;
+}
+
+void __time_critical_func(psram_dma_copy)(void *dst, const void *src, uint32_t size)
+{
+    dma_channel_config config = dma_channel_get_default_config(s_psram_dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, true);
+
+    dma_channel_configure(s_psram_dma_channel, &config, dst, src, size / sizeof(uint32_t), true);
+    dma_channel_wait_for_finish_blocking(s_psram_dma_channel);
+}
+
+//  XIP cache range of the cached alias of an uncached PSRAM range, widened to whole 8 byte lines
+static inline uintptr_t psram_cache_offset(const void *nocache)
+{
+    return ((uintptr_t)nocache - XIP_NOCACHE_OFFSET - XIP_BASE) & ~(uintptr_t)7;
+}
+
+static inline uintptr_t psram_cache_size(const void *nocache, uint32_t size)
+{
+    return ((((uintptr_t)nocache + size + 7) & ~(uintptr_t)7) - ((uintptr_t)nocache & ~(uintptr_t)7));
+}
+
+//  The XIP cache is write back: anything written through the cached alias is
+//  cleaned out before the DMA reads the page, and the cached copy is dropped
+//  once the DMA has written it
+static void __time_critical_func(psram_page_fill)(void *context, void *dst, uint32_t offset, uint32_t size)
+{
+    uint8_t *src = (uint8_t *)context + offset;
+
+    xip_cache_clean_range(psram_cache_offset(src), psram_cache_size(src, size));
+    psram_dma_copy(dst, src, size);
+}
+
+static void __time_critical_func(psram_page_write_back)(void *context, uint32_t offset, const void *src, uint32_t size)
+{
+    uint8_t *dst = (uint8_t *)context + offset;
+
+    psram_dma_copy(dst, src, size);
+    xip_cache_invalidate_range(psram_cache_offset(dst), psram_cache_size(dst, size));
+}
+
+void psram_page_cache_backend(page_cache_backend *backend, void *psram)
+{
+    psram_dma_init();
+
+    backend->fill = psram_page_fill;
+    backend->write_back = psram_page_write_back;
+    backend->context = PSRAM_NOCACHE(psram);
+}
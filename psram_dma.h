@@ -0,0 +1,47 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  DMA helpers for moving data between SRAM and PSRAM
+
+#ifndef PSRAM_DMA_H
+#define PSRAM_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "page_cache.h"
+
+//  Claim the DMA channel used for PSRAM copies
+bool psram_dma_init(void);
+
+//  Blocking word copy, size in bytes and a multiple of 4
+void psram_dma_copy(void *dst, const void *src, uint32_t size);
+
+//  Page cache backend moving pages between SRAM and psram by DMA through the
+//  uncached window.  Each page is cleaned from the XIP cache before it's read
+//  and invalidated after it's written, so the cached alias stays coherent
+//  between transfers, but a page held by the page cache must only be touched
+//  through the page cache until it's flushed.
+void psram_page_cache_backend(page_cache_backend *backend, void *psram);
+
+#endif
@@ -0,0 +1,141 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/xip_cache.h"
+
+#include "PicoMemPerf.h"
+#include "psram_stream.h"
+
+static void __time_critical_func(psram_stream_issue)(psram_stream *stream)
+{
+    uint32_t words = stream->total_words - stream->issued_words;
+    if (words > stream->chunk_words)
+    {
+        words = stream->chunk_words;
+    }
+
+    stream->ready_words = words;
+    if (words == 0)
+    {
+        return;
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(stream->channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, true);
+
+    dma_channel_configure(stream->channel, &config, stream->buffers[stream->ready], stream->source + stream->issued_words, words, true);
+    stream->issued_words += words;
+}
+
+bool psram_stream_init(psram_stream *stream, const uint32_t *source, uint32_t total_words, uint32_t *buffer, uint32_t chunk_words)
+{
+    //  Safe to deinit even if this fails
+    stream->channel = -1;
+
+    if ((chunk_words == 0) || (buffer == NULL))
+    {
+        return false;
+    }
+
+    stream->channel = dma_claim_unused_channel(false);
+    if (stream->channel < 0)
+    {
+        return false;
+    }
+
+    //  Cached aliases are read through the uncached window so streaming doesn't evict the XIP cache,
+    //  once anything written through the cached alias has been cleaned out to PSRAM
+    if (((uintptr_t)source >= PSRAM_LOCATION) && ((uintptr_t)source < PSRAM_LOCATION + _psram_size))
+    {
+        uintptr_t start = ((uintptr_t)source - XIP_BASE) & ~(uintptr_t)7;
+        uintptr_t end = ((uintptr_t)(source + total_words) - XIP_BASE + 7) & ~(uintptr_t)7;
+        xip_cache_clean_range(start, end - start);
+        source = (const uint32_t *)PSRAM_NOCACHE(source);
+    }
+
+    stream->source = source;
+    stream->total_words = total_words;
+    stream->chunk_words = chunk_words;
+    stream->buffers[0] = buffer;
+    stream->buffers[1] = buffer + chunk_words;
+    stream->issued_words = 0;
+    stream->ready = 0;
+    stream->stall_us = 0;
+
+    psram_stream_issue(stream);
+
+    return true;
+}
+
+const uint32_t *__time_critical_func(psram_stream_next)(psram_stream *stream, uint32_t *words)
+{
+    if (stream->ready_words == 0)
+    {
+        *words = 0;
+        return NULL;
+    }
+
+    if (dma_channel_is_busy(stream->channel))
+    {
+        uint64_t start = time_us_64();
+        dma_channel_wait_for_finish_blocking(stream->channel);
+        stream->stall_us += time_us_64() - start;
+    }
+
+    const uint32_t *chunk = stream->buffers[stream->ready];
+    *words = stream->ready_words;
+
+    //  Fetch the following chunk into the other half while the caller works on this one
+    stream->ready ^= 1;
+    psram_stream_issue(stream);
+
+    return chunk;
+}
+
+void __time_critical_func(psram_stream_rewind)(psram_stream *stream)
+{
+    //  Whatever is still in flight belongs to the pass being dropped
+    if (dma_channel_is_busy(stream->channel))
+    {
+        dma_channel_abort(stream->channel);
+    }
+
+    stream->issued_words = 0;
+    stream->ready = 0;
+    psram_stream_issue(stream);
+}
+
+void psram_stream_deinit(psram_stream *stream)
+{
+    if (stream->channel >= 0)
+    {
+        dma_channel_abort(stream->channel);
+        dma_channel_unclaim(stream->channel);
+        stream->channel = -1;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Double buffered DMA streaming from PSRAM into SRAM
+//
+//  While the CPU processes one SRAM chunk the DMA fetches the next one into
+//  the other half of the ping-pong buffer, so sequential processing of a
+//  PSRAM array only waits when the DMA can't keep up.
+//
+//      psram_stream stream;
+//      psram_stream_init(&stream, psram_array, words, sram_buffer, chunk_words);
+//      while ((chunk = psram_stream_next(&stream, &count)) != NULL)
+//          process(chunk, count);
+//      psram_stream_deinit(&stream);
+
+#ifndef PSRAM_STREAM_H
+#define PSRAM_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    const uint32_t *source;         //  Uncached view of the PSRAM array
+    uint32_t total_words;
+    uint32_t chunk_words;
+    uint32_t *buffers[2];           //  SRAM ping-pong halves
+    uint32_t issued_words;          //  Words handed to the DMA so far
+    uint32_t ready;                 //  Buffer the in flight DMA is filling
+    uint32_t ready_words;
+    int channel;
+    uint64_t stall_us;              //  Time psram_stream_next() spent waiting for the DMA
+} psram_stream;
+
+//  buffer holds 2 * chunk_words words of SRAM, starts fetching the first chunk
+bool psram_stream_init(psram_stream *stream, const uint32_t *source, uint32_t total_words, uint32_t *buffer, uint32_t chunk_words);
+
+//  Next filled chunk (and starts the one after), NULL at the end.  The chunk
+//  returned by the previous call is reused, so finish with it first.
+const uint32_t *psram_stream_next(psram_stream *stream, uint32_t *words);
+
+//  Back to the first chunk on the same channel, for another pass over the
+//  same array.  The cache isn't cleaned again, anything written through the
+//  cached alias since init needs a psram_stream_init().
+void psram_stream_rewind(psram_stream *stream);
+
+//  Stop any DMA and release the channel
+void psram_stream_deinit(psram_stream *stream);
+
+#endif
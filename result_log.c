@@ -0,0 +1,356 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "result_log.h"
+#include "result_out.h"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t sequence;                  //  Goes up by one per sector written, the highest is the newest
+    uint32_t reserved[2];
+} result_log_header;
+
+//  Where the next frame goes
+static int s_log_sector = RESULT_LOG_SECTORS - 1;
+static uint32_t s_log_head = FLASH_SECTOR_SIZE;      //  Offset in the sector, full until the first flush
+static uint32_t s_log_sequence = 0;
+
+static bool s_log_enabled = false;
+static uint8_t s_log_stage[RESULT_LOG_STAGE_SIZE];
+static uint32_t s_log_staged = 0;
+static uint32_t s_log_frame_left = 0;   //  Bytes still to come of the frame being written
+static bool s_log_full = false;         //  Dropping until the next flush
+static uint32_t s_log_dropped = 0;      //  Frames
+
+//  The sector being appended to
+static uint8_t s_log_sector_image[FLASH_SECTOR_SIZE];
+
+static const uint8_t *log_sector_data(int sector)
+{
+    return (const uint8_t *)(XIP_BASE + RESULT_LOG_FLASH_OFFSET + sector * FLASH_SECTOR_SIZE);
+}
+
+static const result_log_header *log_sector_header(int sector)
+{
+    const result_log_header *header = (const result_log_header *)log_sector_data(sector);
+    return (header->magic == RESULT_LOG_MAGIC) ? header : NULL;
+}
+
+//  Frames come in as prefix, payload and checksum, a frame is staged whole or not at all
+static void result_log_write(const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    if (s_log_frame_left == 0)
+    {
+        if ((length < 3) || (bytes[0] != RESULT_FRAME_MAGIC))
+        {
+            return;
+        }
+        s_log_frame_left = (bytes[1] | (bytes[2] << 8)) + RESULT_FRAME_OVERHEAD;
+        if (!s_log_full && (s_log_staged + s_log_frame_left > RESULT_LOG_STAGE_SIZE))
+        {
+            s_log_full = true;
+        }
+        if (s_log_full)
+        {
+            s_log_dropped++;
+        }
+    }
+
+    length = (length < s_log_frame_left) ? length : s_log_frame_left;
+    s_log_frame_left -= length;
+    if (!s_log_full)
+    {
+        memcpy(s_log_stage + s_log_staged, bytes, length);
+        s_log_staged += length;
+    }
+}
+
+void result_log_init(bool enable)
+{
+    //  Newest sector, then the first page after its last used one
+    bool found = false;
+
+    for (int sector = 0; sector < RESULT_LOG_SECTORS; sector++)
+    {
+        const result_log_header *header = log_sector_header(sector);
+        if ((header != NULL) && (!found || ((int32_t)(header->sequence - s_log_sequence) > 0)))
+        {
+            found = true;
+            s_log_sector = sector;
+            s_log_sequence = header->sequence;
+        }
+    }
+
+    if (found)
+    {
+        const uint8_t *data = log_sector_data(s_log_sector);
+        uint32_t end = FLASH_SECTOR_SIZE;
+
+        while ((end > sizeof(result_log_header)) && (data[end - 1] == 0xFF))
+        {
+            end--;
+        }
+        s_log_head = (end + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+    }
+
+    result_log_enable(enable);
+}
+
+void result_log_enable(bool enable)
+{
+    s_log_enabled = enable;
+    s_log_staged = 0;
+    s_log_frame_left = 0;
+    s_log_full = false;
+    result_set_log(enable ? result_log_write : NULL);
+}
+
+bool result_log_enabled(void)
+{
+    return s_log_enabled;
+}
+
+typedef struct
+{
+    uint32_t offset;                    //  Of the sector in flash
+    bool erase;
+    uint32_t from;                      //  Pages from..to of s_log_sector_image to program
+    uint32_t to;
+} result_log_program;
+
+//  Runs with the other core and interrupts locked out, see bench_plan.c
+static void __not_in_flash_func(result_log_program_sector)(void *param)
+{
+    const result_log_program *program = (const result_log_program *)param;
+
+    if (program->erase)
+    {
+        flash_range_erase(program->offset, FLASH_SECTOR_SIZE);
+    }
+    if (program->to > program->from)
+    {
+        flash_range_program(program->offset + program->from, s_log_sector_image + program->from, program->to - program->from);
+    }
+}
+
+static bool log_program(bool erase, uint32_t from, uint32_t to)
+{
+    result_log_program program =
+    {
+        RESULT_LOG_FLASH_OFFSET + s_log_sector * FLASH_SECTOR_SIZE,
+        erase,
+        from & ~(FLASH_PAGE_SIZE - 1),
+        (to + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1)
+    };
+    int result = flash_safe_execute(result_log_program_sector, &program, RESULT_LOG_TIMEOUT_MS);
+
+    if (result != PICO_OK)
+    {
+        printf("Error, log flash write, %d\n", result);
+        return false;
+    }
+    return true;
+}
+
+bool result_log_flush(void)
+{
+    //  Where each schema id was last defined in the staged frames, and
+    //  whether the sector being filled has it yet
+    uint32_t schema_at[RESULT_MAX_SCHEMAS];
+    uint32_t schema_length[RESULT_MAX_SCHEMAS];
+    uint32_t in_sector = 0;
+    bool erase = false;
+    bool ok = true;
+
+    if (s_log_staged == 0)
+    {
+        return true;
+    }
+
+    memset(schema_length, 0, sizeof(schema_length));
+    memcpy(s_log_sector_image, log_sector_data(s_log_sector), FLASH_SECTOR_SIZE);
+    uint32_t dirty = s_log_head;
+
+    for (uint32_t at = 0; ok && (at + 3 < s_log_staged); )
+    {
+        const uint8_t *frame = s_log_stage + at;
+        uint32_t length = (frame[1] | (frame[2] << 8)) + RESULT_FRAME_OVERHEAD;
+        uint8_t kind = frame[3];
+        uint8_t id = frame[4] % RESULT_MAX_SCHEMAS;
+        bool need_schema = (kind == RESULT_FRAME_RECORD) && !(in_sector & (1u << id)) && (schema_length[id] != 0);
+        uint32_t needed = length + (need_schema ? schema_length[id] : 0);
+
+        if (kind == RESULT_FRAME_SCHEMA)
+        {
+            schema_at[id] = at;
+            schema_length[id] = length;
+        }
+
+        //  Full, finish this sector and start the next one, the oldest in the ring
+        if (s_log_head + needed > FLASH_SECTOR_SIZE)
+        {
+            if (s_log_head > dirty)
+            {
+                ok = log_program(erase, dirty, s_log_head);
+            }
+
+            s_log_sector = (s_log_sector + 1) % RESULT_LOG_SECTORS;
+            s_log_sequence++;
+            memset(s_log_sector_image, 0xFF, FLASH_SECTOR_SIZE);
+
+            result_log_header header = { RESULT_LOG_MAGIC, s_log_sequence, { 0, 0 } };
+            memcpy(s_log_sector_image, &header, sizeof(header));
+            s_log_head = sizeof(header);
+            dirty = 0;
+            erase = true;
+            in_sector = 0;
+            need_schema = (kind == RESULT_FRAME_RECORD) && (schema_length[id] != 0);
+        }
+
+        if (need_schema)
+        {
+            memcpy(s_log_sector_image + s_log_head, s_log_stage + schema_at[id], schema_length[id]);
+            s_log_head += schema_length[id];
+        }
+        in_sector |= 1u << id;
+
+        memcpy(s_log_sector_image + s_log_head, frame, length);
+        s_log_head += length;
+        at += length;
+    }
+
+    //  A zero after the last frame so init finds the end even if the frame ends in 0xFF
+    if ((s_log_head & (FLASH_PAGE_SIZE - 1)) != 0)
+    {
+        s_log_sector_image[s_log_head++] = 0x00;
+    }
+
+    if (ok && (s_log_head > dirty))
+    {
+        ok = log_program(erase, dirty, s_log_head);
+    }
+
+    //  Next flush starts on a fresh page, with its own schemas
+    s_log_head = (s_log_head + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+    s_log_staged = 0;
+    s_log_full = false;
+    result_reset_log_schemas();
+
+    return ok;
+}
+
+//  Frames in a sector, the padding between flushes is skipped
+static uint32_t log_dump_sector(int sector)
+{
+    const uint8_t *data = log_sector_data(sector);
+    uint32_t at = sizeof(result_log_header);
+    uint32_t frames = 0;
+
+    while (at + RESULT_FRAME_OVERHEAD < FLASH_SECTOR_SIZE)
+    {
+        if (data[at] != RESULT_FRAME_MAGIC)
+        {
+            at = (at + FLASH_PAGE_SIZE) & ~(FLASH_PAGE_SIZE - 1);
+            continue;
+        }
+
+        uint32_t length = (data[at + 1] | (data[at + 2] << 8)) + RESULT_FRAME_OVERHEAD;
+        if (at + length > FLASH_SECTOR_SIZE)
+        {
+            break;
+        }
+        stdio_put_string((const char *)data + at, (int)length, false, false);
+        at += length;
+        frames++;
+    }
+
+    return frames;
+}
+
+void result_log_dump(void)
+{
+    uint32_t frames = 0;
+    int sectors = 0;
+
+    result_log_flush();
+    printf("Log dump, begin\n");
+    stdio_flush();
+
+    //  Oldest first, the one after the head and round
+    for (int i = 1; i <= RESULT_LOG_SECTORS; i++)
+    {
+        int sector = (s_log_sector + i) % RESULT_LOG_SECTORS;
+        if (log_sector_header(sector) != NULL)
+        {
+            frames += log_dump_sector(sector);
+            sectors++;
+        }
+    }
+
+    stdio_flush();
+    printf("Log dump, end, sectors, %d, frames, %lu\n", sectors, (long unsigned int)frames);
+}
+
+void result_log_status(void)
+{
+    int sectors = 0;
+
+    for (int sector = 0; sector < RESULT_LOG_SECTORS; sector++)
+    {
+        sectors += (log_sector_header(sector) != NULL) ? 1 : 0;
+    }
+
+    printf("Log, enabled, %d, sectors, %d, of, %d, sequence, %lu, head, %lu, staged, %lu, dropped, %lu\n",
+           s_log_enabled ? 1 : 0, sectors, RESULT_LOG_SECTORS, (long unsigned int)s_log_sequence,
+           (long unsigned int)s_log_head, (long unsigned int)s_log_staged, (long unsigned int)s_log_dropped);
+}
+
+static void __not_in_flash_func(result_log_erase_all)(void *param)
+{
+    flash_range_erase(RESULT_LOG_FLASH_OFFSET, RESULT_LOG_FLASH_SIZE);
+}
+
+bool result_log_erase(void)
+{
+    int result = flash_safe_execute(result_log_erase_all, NULL, RESULT_LOG_TIMEOUT_MS * 4);
+
+    s_log_sector = RESULT_LOG_SECTORS - 1;
+    s_log_head = FLASH_SECTOR_SIZE;
+    s_log_sequence = 0;
+    s_log_staged = 0;
+    s_log_full = false;
+    s_log_dropped = 0;
+    result_reset_log_schemas();
+
+    return result == PICO_OK;
+}
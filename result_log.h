@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Result log in flash, for boards that run with nothing attached
+//
+//  Every result record is also encoded in binary (result_set_log) into an
+//  SRAM staging buffer, nothing touches flash while tests run.  When a run
+//  or shell command is over result_log_flush() appends the staged frames to
+//  a ring of 4K sectors in front of the plan partition, erasing the oldest
+//  sector when it wraps.  Each sector starts with a small header and carries
+//  the schemas its records need, so whatever is left after a wrap still
+//  decodes.  "log dump" sends it all back as binary frames for
+//  host/result_decode or host/serial_driver.
+
+#ifndef RESULT_LOG_H
+#define RESULT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bench_plan.h"
+
+//  Log partition, just below the plan partition.  Keep the image out of both.
+#define RESULT_LOG_FLASH_SIZE       (256 * 1024)
+#define RESULT_LOG_FLASH_OFFSET     (PLAN_FLASH_OFFSET - RESULT_LOG_FLASH_SIZE)
+#define RESULT_LOG_SECTORS          (RESULT_LOG_FLASH_SIZE / FLASH_SECTOR_SIZE)
+#define RESULT_LOG_MAGIC            0x474F4C52      //  "RLOG"
+#define RESULT_LOG_STAGE_SIZE       (16 * 1024)     //  Records between flushes, more are dropped
+#define RESULT_LOG_TIMEOUT_MS       1000
+
+//  Find the end of the log, and start staging records if enable
+void result_log_init(bool enable);
+
+void result_log_enable(bool enable);
+bool result_log_enabled(void);
+
+//  Staged records to flash, only call it outside timed code
+bool result_log_flush(void);
+
+//  Every sector oldest first, as binary frames between two text lines
+void result_log_dump(void);
+
+//  Sectors, bytes used, staged and dropped
+void result_log_status(void);
+
+bool result_log_erase(void);
+
+#endif
@@ -0,0 +1,550 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+
+#include "result_out.h"
+
+typedef struct
+{
+    const char *type;
+    int field_count;
+    uint8_t field_types[RESULT_MAX_FIELDS];
+    const char *field_keys[RESULT_MAX_FIELDS];
+} result_schema;
+
+//  Where records go and, for binary, which schemas the reader already has
+typedef struct
+{
+    result_format format;
+    result_writer writer;
+    result_schema schemas[RESULT_MAX_SCHEMAS];
+    int schema_count;
+} result_stream;
+
+//  Encoded bytes of one frame or line
+typedef struct
+{
+    size_t length;
+    bool overflow;
+    char data[RESULT_RECORD_SIZE];
+} result_buffer;
+
+static result_stream s_result_out = { RESULT_FORMAT_CSV, NULL };
+static result_stream s_result_log = { RESULT_FORMAT_BINARY, NULL };
+
+static const char * const s_result_format_names[RESULT_FORMAT_COUNT] = { "csv", "json", "binary" };
+
+void result_set_format(result_format format)
+{
+    s_result_out.format = format;
+    result_reset_schemas();
+}
+
+result_format result_get_format(void)
+{
+    return s_result_out.format;
+}
+
+const char *result_format_name(result_format format)
+{
+    return (format < RESULT_FORMAT_COUNT) ? s_result_format_names[format] : "?";
+}
+
+int result_format_match(const char *text)
+{
+    for (int i = 0; i < RESULT_FORMAT_COUNT; i++)
+    {
+        if (strcasecmp(text, s_result_format_names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void result_set_writer(result_writer writer)
+{
+    s_result_out.writer = writer;
+}
+
+void result_reset_schemas(void)
+{
+    s_result_out.schema_count = 0;
+}
+
+void result_set_log(result_writer writer)
+{
+    s_result_log.writer = writer;
+    result_reset_log_schemas();
+}
+
+void result_reset_log_schemas(void)
+{
+    s_result_log.schema_count = 0;
+}
+
+static void result_write(const result_stream *stream, const void *data, size_t length)
+{
+    if (stream->writer != NULL)
+    {
+        stream->writer(data, length);
+    }
+    else
+    {
+        fwrite(data, 1, length, stdout);
+    }
+}
+
+
+//  Encoding helpers
+
+size_t result_put_varint(uint8_t *out, uint64_t value)
+{
+    size_t length = 0;
+
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[length++] = byte | ((value != 0) ? 0x80 : 0);
+    }
+    while (value != 0);
+
+    return length;
+}
+
+uint8_t result_checksum(const uint8_t *data, size_t length)
+{
+    uint8_t checksum = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        checksum ^= data[i];
+    }
+    return checksum;
+}
+
+static void buffer_append(result_buffer *buffer, const void *data, size_t length)
+{
+    if (buffer->length + length > RESULT_RECORD_SIZE)
+    {
+        buffer->overflow = true;
+        return;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+}
+
+static void buffer_printf(result_buffer *buffer, const char *format, ...)
+{
+    va_list args;
+    size_t space = RESULT_RECORD_SIZE - buffer->length;
+
+    va_start(args, format);
+    int length = vsnprintf(buffer->data + buffer->length, space, format, args);
+    va_end(args);
+
+    if ((length < 0) || ((size_t)length >= space))
+    {
+        buffer->overflow = true;
+        return;
+    }
+    buffer->length += length;
+}
+
+//  Binary strings are length prefixed, text strings quoted when they need it
+static void buffer_string(result_buffer *buffer, result_format format, const char *value)
+{
+    size_t length = strlen(value);
+
+    if (length > RESULT_MAX_STRING)
+    {
+        length = RESULT_MAX_STRING;
+    }
+
+    switch (format)
+    {
+        case RESULT_FORMAT_BINARY:
+        {
+            uint8_t prefix = (uint8_t)length;
+            buffer_append(buffer, &prefix, 1);
+            buffer_append(buffer, value, length);
+            break;
+        }
+        case RESULT_FORMAT_JSON:
+            buffer_append(buffer, "\"", 1);
+            for (size_t i = 0; i < length; i++)
+            {
+                char c = value[i];
+                if ((c == '"') || (c == '\\'))
+                {
+                    buffer_append(buffer, "\\", 1);
+                    buffer_append(buffer, &c, 1);
+                }
+                else if ((unsigned char)c < ' ')
+                {
+                    buffer_printf(buffer, "\\u%04x", (unsigned)c);
+                }
+                else
+                {
+                    buffer_append(buffer, &c, 1);
+                }
+            }
+            buffer_append(buffer, "\"", 1);
+            break;
+        default:
+            //  RFC 4180, only when there's a comma, quote or line break in it
+            if (strpbrk(value, ",\"\r\n") == NULL)
+            {
+                buffer_append(buffer, value, length);
+                break;
+            }
+            buffer_append(buffer, "\"", 1);
+            for (size_t i = 0; i < length; i++)
+            {
+                if (value[i] == '"')
+                {
+                    buffer_append(buffer, "\"", 1);
+                }
+                buffer_append(buffer, &value[i], 1);
+            }
+            buffer_append(buffer, "\"", 1);
+            break;
+    }
+}
+
+static void buffer_value(result_buffer *buffer, result_format format, uint8_t type, const result_field_value *value)
+{
+    switch (type)
+    {
+        case RESULT_TYPE_STR:
+            buffer_string(buffer, format, value->s);
+            break;
+
+        case RESULT_TYPE_U64:
+        case RESULT_TYPE_I64:
+            if (format == RESULT_FORMAT_BINARY)
+            {
+                //  Zigzag so small negatives stay short
+                uint8_t varint[10];
+                uint64_t bits = (type == RESULT_TYPE_U64) ? value->u : ((uint64_t)value->i << 1) ^ (uint64_t)(value->i >> 63);
+                buffer_append(buffer, varint, result_put_varint(varint, bits));
+            }
+            else if (type == RESULT_TYPE_U64)
+            {
+                buffer_printf(buffer, "%llu", (unsigned long long)value->u);
+            }
+            else
+            {
+                buffer_printf(buffer, "%lld", (long long)value->i);
+            }
+            break;
+
+        case RESULT_TYPE_HEX:
+            if (format == RESULT_FORMAT_BINARY)
+            {
+                uint32_t bits = (uint32_t)value->u;
+                uint8_t bytes[4] = { bits, bits >> 8, bits >> 16, bits >> 24 };
+                buffer_append(buffer, bytes, 4);
+            }
+            else
+            {
+                buffer_printf(buffer, (format == RESULT_FORMAT_JSON) ? "\"0x%08lX\"" : "0x%08lX", (long unsigned int)value->u);
+            }
+            break;
+
+        default:
+        {
+            float f = value->f;
+
+            if (format == RESULT_FORMAT_BINARY)
+            {
+                uint32_t bits;
+                memcpy(&bits, &f, sizeof(bits));
+                uint8_t bytes[4] = { bits, bits >> 8, bits >> 16, bits >> 24 };
+                buffer_append(buffer, bytes, 4);
+            }
+            else if (format == RESULT_FORMAT_JSON)
+            {
+                //  JSON has no NaN / Inf
+                if ((f != f) || (f > 3.4e38f) || (f < -3.4e38f))
+                {
+                    buffer_append(buffer, "null", 4);
+                }
+                else
+                {
+                    buffer_printf(buffer, "%.6g", (double)f);
+                }
+            }
+            else
+            {
+                buffer_printf(buffer, "%.2f", (double)f);
+            }
+            break;
+        }
+    }
+}
+
+
+//  Records, the values are kept until result_end() encodes them for each stream
+
+void result_begin(result_record *record, const char *type)
+{
+    record->type = type;
+    record->field_count = 0;
+    record->overflow = false;
+    memset(record->field_labels, 0, sizeof(record->field_labels));
+}
+
+static result_field_value *record_field(result_record *record, const char *key, uint8_t type)
+{
+    if (record->field_count == RESULT_MAX_FIELDS)
+    {
+        record->overflow = true;
+        return NULL;
+    }
+
+    record->field_types[record->field_count] = type;
+    record->field_keys[record->field_count] = key;
+    return &record->values[record->field_count++];
+}
+
+void result_str(result_record *record, const char *key, const char *value)
+{
+    result_field_value *field = record_field(record, key, RESULT_TYPE_STR);
+    if (field != NULL)
+    {
+        field->s = value;
+    }
+}
+
+void result_u64(result_record *record, const char *key, uint64_t value)
+{
+    result_field_value *field = record_field(record, key, RESULT_TYPE_U64);
+    if (field != NULL)
+    {
+        field->u = value;
+    }
+}
+
+void result_i64(result_record *record, const char *key, int64_t value)
+{
+    result_field_value *field = record_field(record, key, RESULT_TYPE_I64);
+    if (field != NULL)
+    {
+        field->i = value;
+    }
+}
+
+void result_hex(result_record *record, const char *key, uint32_t value)
+{
+    result_field_value *field = record_field(record, key, RESULT_TYPE_HEX);
+    if (field != NULL)
+    {
+        field->u = value;
+    }
+}
+
+void result_f32(result_record *record, const char *key, float value)
+{
+    result_field_value *field = record_field(record, key, RESULT_TYPE_F32);
+    if (field != NULL)
+    {
+        field->f = value;
+    }
+}
+
+void result_label(result_record *record, const char *label)
+{
+    record->field_labels[record->field_count] = label;
+}
+
+//  Schema id for the record's type and field list, sending the schema if it's new
+static int result_schema_id(result_stream *stream, const result_record *record)
+{
+    for (int i = 0; i < stream->schema_count; i++)
+    {
+        const result_schema *schema = &stream->schemas[i];
+        bool match = (schema->field_count == record->field_count) && (strcmp(schema->type, record->type) == 0);
+
+        for (int f = 0; match && (f < record->field_count); f++)
+        {
+            match = (schema->field_types[f] == record->field_types[f]) && (strcmp(schema->field_keys[f], record->field_keys[f]) == 0);
+        }
+        if (match)
+        {
+            return i;
+        }
+    }
+
+    //  Full, start again from id 0, the reader replaces a schema when an id is sent again
+    if (stream->schema_count == RESULT_MAX_SCHEMAS)
+    {
+        stream->schema_count = 0;
+    }
+
+    int id = stream->schema_count++;
+    result_schema *schema = &stream->schemas[id];
+    result_buffer frame;
+    uint8_t header[3] = { RESULT_FRAME_SCHEMA, (uint8_t)id, (uint8_t)record->field_count };
+
+    schema->type = record->type;
+    schema->field_count = record->field_count;
+    memcpy(schema->field_types, record->field_types, sizeof(schema->field_types));
+    memcpy(schema->field_keys, record->field_keys, sizeof(schema->field_keys));
+
+    //  kind, id, field count, type name, then a type byte and key per field
+    frame.length = 0;
+    frame.overflow = false;
+    buffer_append(&frame, header, sizeof(header));
+    buffer_string(&frame, RESULT_FORMAT_BINARY, record->type);
+    for (int f = 0; f < record->field_count; f++)
+    {
+        buffer_append(&frame, &record->field_types[f], 1);
+        buffer_string(&frame, RESULT_FORMAT_BINARY, record->field_keys[f]);
+    }
+
+    if (frame.overflow)
+    {
+        stream->schema_count--;
+        return -1;
+    }
+
+    uint8_t prefix[3] = { RESULT_FRAME_MAGIC, frame.length & 0xFF, frame.length >> 8 };
+    uint8_t checksum = result_checksum((const uint8_t *)frame.data, frame.length);
+    result_write(stream, prefix, sizeof(prefix));
+    result_write(stream, frame.data, frame.length);
+    result_write(stream, &checksum, 1);
+
+    return id;
+}
+
+static void result_encode(result_stream *stream, const result_record *record)
+{
+    static result_buffer s_buffer;
+    result_format format = stream->format;
+    result_buffer *buffer = &s_buffer;
+
+    buffer->length = 0;
+    buffer->overflow = false;
+
+    if (format == RESULT_FORMAT_JSON)
+    {
+        buffer_append(buffer, "{\"type\":", 8);
+        buffer_string(buffer, format, record->type);
+    }
+    else if (format == RESULT_FORMAT_CSV)
+    {
+        buffer_string(buffer, format, record->type);
+    }
+
+    for (int f = 0; f <= record->field_count; f++)
+    {
+        //  CSV labels sit in front of a field, or after the last
+        if ((format == RESULT_FORMAT_CSV) && (record->field_labels[f] != NULL))
+        {
+            buffer_append(buffer, ", ", 2);
+            buffer_string(buffer, format, record->field_labels[f]);
+        }
+        if (f == record->field_count)
+        {
+            break;
+        }
+
+        if (format == RESULT_FORMAT_JSON)
+        {
+            buffer_append(buffer, ",", 1);
+            buffer_string(buffer, format, record->field_keys[f]);
+            buffer_append(buffer, ":", 1);
+        }
+        else if (format == RESULT_FORMAT_CSV)
+        {
+            buffer_append(buffer, ", ", 2);
+        }
+        buffer_value(buffer, format, record->field_types[f], &record->values[f]);
+    }
+
+    if (format != RESULT_FORMAT_BINARY)
+    {
+        bool json = (format == RESULT_FORMAT_JSON);
+        buffer_append(buffer, json ? "}\n" : "\n", json ? 2 : 1);
+        if (!buffer->overflow)
+        {
+            result_write(stream, buffer->data, buffer->length);
+        }
+        return;
+    }
+
+    int id;
+    if (buffer->overflow || ((id = result_schema_id(stream, record)) < 0))
+    {
+        return;
+    }
+
+    size_t length = buffer->length + 2;
+    uint8_t prefix[5] = { RESULT_FRAME_MAGIC, length & 0xFF, length >> 8, RESULT_FRAME_RECORD, (uint8_t)id };
+    uint8_t checksum = prefix[3] ^ prefix[4] ^ result_checksum((const uint8_t *)buffer->data, buffer->length);
+
+    result_write(stream, prefix, sizeof(prefix));
+    result_write(stream, buffer->data, buffer->length);
+    result_write(stream, &checksum, 1);
+}
+
+void result_end(result_record *record)
+{
+    if (record->overflow)
+    {
+        return;
+    }
+
+    result_encode(&s_result_out, record);
+    if (s_result_log.writer != NULL)
+    {
+        result_encode(&s_result_log, record);
+    }
+}
+
+void result_csv_line(const char *format, ...)
+{
+    if (s_result_out.format != RESULT_FORMAT_CSV)
+    {
+        return;
+    }
+
+    char line[RESULT_RECORD_SIZE];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (length > 0)
+    {
+        result_write(&s_result_out, line, ((size_t)length < sizeof(line)) ? (size_t)length : sizeof(line) - 1);
+    }
+}
@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Result records in CSV, JSON Lines or a compact binary stream
+//
+//  A record is a type name and a list of typed fields, encoded in whichever
+//  format is selected and written in one go:
+//
+//      result_record r;
+//      result_begin(&r, "Test");
+//      result_str(&r, "test", name);
+//      result_u64(&r, "result", us);
+//      result_end(&r);
+//
+//  CSV is what the firmware has always printed, "Type, value, value", with
+//  result_label() adding the inline labels the old lines had.  JSON Lines
+//  gives {"type":"Test","test":"...","result":123}.  Binary frames are
+//
+//      0xA5, length (u16 LE), payload, checksum (xor of payload)
+//
+//  The first record of each type / field list is preceded by a schema frame
+//  with its name, field keys and field types, after that a record is its
+//  type id and the values (varints, 4 byte hex / float, length prefixed
+//  strings).  host/result_decode.h turns the stream back into records.
+//
+//  The values are kept and encoded by result_end(), once for the output and
+//  once more for the log copy when there is one.  Keys and type names have
+//  to outlive the encoder (string literals).
+
+#ifndef RESULT_OUT_H
+#define RESULT_OUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum
+{
+    RESULT_FORMAT_CSV,
+    RESULT_FORMAT_JSON,
+    RESULT_FORMAT_BINARY,
+    RESULT_FORMAT_COUNT
+} result_format;
+
+//  Field types, also the binary schema codes
+#define RESULT_TYPE_STR         1
+#define RESULT_TYPE_U64         2
+#define RESULT_TYPE_I64         3
+#define RESULT_TYPE_HEX         4       //  32 bit, 0x%08X in text
+#define RESULT_TYPE_F32         5
+
+//  Binary framing
+#define RESULT_FRAME_MAGIC      0xA5
+#define RESULT_FRAME_SCHEMA     0x01
+#define RESULT_FRAME_RECORD     0x02
+#define RESULT_FRAME_OVERHEAD   4       //  Magic, length, checksum
+
+#define RESULT_RECORD_SIZE      384     //  Encoded payload
+#define RESULT_MAX_FIELDS       24
+#define RESULT_MAX_SCHEMAS      32
+#define RESULT_MAX_STRING       255
+
+typedef union
+{
+    uint64_t u;                         //  U64 / HEX
+    int64_t i;
+    float f;
+    const char *s;                      //  Has to last until result_end()
+} result_field_value;
+
+typedef struct
+{
+    const char *type;
+    int field_count;
+    uint8_t field_types[RESULT_MAX_FIELDS];
+    const char *field_keys[RESULT_MAX_FIELDS];
+    const char *field_labels[RESULT_MAX_FIELDS + 1];    //  CSV label in front of each field, and after the last
+    result_field_value values[RESULT_MAX_FIELDS];
+    bool overflow;                      //  Too many fields, the record is dropped
+} result_record;
+
+typedef void (*result_writer)(const void *data, size_t length);
+
+//  Changing format forgets the binary schemas so they're sent again
+void result_set_format(result_format format);
+result_format result_get_format(void);
+const char *result_format_name(result_format format);
+int result_format_match(const char *text);
+
+//  Where encoded records go, NULL for stdout
+void result_set_writer(result_writer writer);
+
+//  Send schemas again before the next records, for a reader that joins late
+void result_reset_schemas(void);
+
+//  Second copy of every record, always binary, e.g. to the flash result log.
+//  NULL to stop.  It has its own schemas, reset them wherever a reader of
+//  the copy may have to start.
+void result_set_log(result_writer writer);
+void result_reset_log_schemas(void);
+
+void result_begin(result_record *record, const char *type);
+void result_str(result_record *record, const char *key, const char *value);
+void result_u64(result_record *record, const char *key, uint64_t value);
+void result_i64(result_record *record, const char *key, int64_t value);
+void result_hex(result_record *record, const char *key, uint32_t value);
+void result_f32(result_record *record, const char *key, float value);
+void result_label(result_record *record, const char *label);       //  CSV only
+void result_end(result_record *record);
+
+//  Column headings and other text that only makes sense in CSV
+void result_csv_line(const char *format, ...);
+
+//  Helpers shared with the decoder
+size_t result_put_varint(uint8_t *out, uint64_t value);
+uint8_t result_checksum(const uint8_t *data, size_t length);
+
+#endif
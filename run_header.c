@@ -0,0 +1,178 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pico/stdlib.h"
+#include "pico/version.h"
+#include "pico/unique_id.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/qmi.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "hardware/structs/powman.h"
+#include <stdio.h>
+
+#include "PicoMemPerf.h"
+#include "run_header.h"
+
+//  Passed in by CMakeLists.txt
+#ifndef PICOMEMPERF_GIT_REVISION
+#define PICOMEMPERF_GIT_REVISION    "unknown"
+#endif
+#ifndef PICOMEMPERF_C_FLAGS
+#define PICOMEMPERF_C_FLAGS         "unknown"
+#endif
+#ifndef PICOMEMPERF_BUILD_TYPE
+#define PICOMEMPERF_BUILD_TYPE      "unknown"
+#endif
+
+//  POWMAN VREG VSEL to mV
+static const uint16_t s_vreg_mv[32] =
+{
+     550,  600,  650,  700,  750,  800,  850,  900,  950, 1000, 1050, 1100, 1150, 1200, 1250, 1300,
+    1350, 1400, 1500, 1600, 1650, 1700, 1800, 1900, 2000, 2350, 2500, 2650, 2800, 3000, 3150, 3300
+};
+
+static void header_string(const char *key, const char *value)
+{
+    result_record record;
+
+    result_begin(&record, "Header");
+    result_str(&record, "key", key);
+    result_str(&record, "value", value);
+    result_end(&record);
+}
+
+static void header_int(const char *key, int value)
+{
+    result_record record;
+
+    result_begin(&record, "Header");
+    result_str(&record, "key", key);
+    result_i64(&record, "value", value);
+    result_end(&record);
+}
+
+static void header_hex(const char *key, uint32_t value)
+{
+    result_record record;
+
+    result_begin(&record, "Header");
+    result_str(&record, "key", key);
+    result_hex(&record, "value", value);
+    result_end(&record);
+}
+
+#define HEADER_FIELD(reg, field)    (((reg) & field##_BITS) >> field##_LSB)
+
+static void header_qmi_window(int window)
+{
+    char key[32];
+    uint32_t timing = qmi_hw->m[window].timing;
+
+    snprintf(key, sizeof(key), "qmi_m%d_timing", window);
+    header_hex(key, timing);
+    snprintf(key, sizeof(key), "qmi_m%d_rfmt", window);
+    header_hex(key, qmi_hw->m[window].rfmt);
+    snprintf(key, sizeof(key), "qmi_m%d_rcmd", window);
+    header_hex(key, qmi_hw->m[window].rcmd);
+    snprintf(key, sizeof(key), "qmi_m%d_wfmt", window);
+    header_hex(key, qmi_hw->m[window].wfmt);
+    snprintf(key, sizeof(key), "qmi_m%d_wcmd", window);
+    header_hex(key, qmi_hw->m[window].wcmd);
+
+    //  The timing fields have the same layout in both windows
+    result_record record;
+
+    snprintf(key, sizeof(key), "qmi_m%d_timing_fields", window);
+    result_begin(&record, "Header");
+    result_str(&record, "key", key);
+    result_label(&record, "clkdiv");
+    result_u64(&record, "clkdiv", HEADER_FIELD(timing, QMI_M1_TIMING_CLKDIV));
+    result_label(&record, "rxdelay");
+    result_u64(&record, "rxdelay", HEADER_FIELD(timing, QMI_M1_TIMING_RXDELAY));
+    result_label(&record, "cooldown");
+    result_u64(&record, "cooldown", HEADER_FIELD(timing, QMI_M1_TIMING_COOLDOWN));
+    result_label(&record, "pagebreak");
+    result_u64(&record, "pagebreak", HEADER_FIELD(timing, QMI_M1_TIMING_PAGEBREAK));
+    result_label(&record, "select_setup");
+    result_u64(&record, "select_setup", HEADER_FIELD(timing, QMI_M1_TIMING_SELECT_SETUP));
+    result_label(&record, "select_hold");
+    result_u64(&record, "select_hold", HEADER_FIELD(timing, QMI_M1_TIMING_SELECT_HOLD));
+    result_label(&record, "max_select");
+    result_u64(&record, "max_select", HEADER_FIELD(timing, QMI_M1_TIMING_MAX_SELECT));
+    result_label(&record, "min_deselect");
+    result_u64(&record, "min_deselect", HEADER_FIELD(timing, QMI_M1_TIMING_MIN_DESELECT));
+    result_end(&record);
+}
+
+void print_run_header(void)
+{
+    char board_id[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+    uint32_t vsel = HEADER_FIELD(powman_hw->vreg, POWMAN_VREG_VSEL);
+
+    pico_get_unique_board_id_string(board_id, sizeof(board_id));
+
+    //  Binary readers joining now get the schemas again
+    result_reset_schemas();
+    header_int("begin", RUN_HEADER_FORMAT);
+
+    //  Build
+#ifdef PICO_PROGRAM_NAME
+    header_string("program", PICO_PROGRAM_NAME);
+#endif
+#ifdef PICO_PROGRAM_VERSION_STRING
+    header_string("program_version", PICO_PROGRAM_VERSION_STRING);
+#endif
+    header_string("git_revision", PICOMEMPERF_GIT_REVISION);
+    header_string("build_date", __DATE__ " " __TIME__);
+    header_string("sdk_version", PICO_SDK_VERSION_STRING);
+#ifdef PICO_BOARD
+    header_string("board", PICO_BOARD);
+#endif
+    header_string("compiler", __VERSION__);
+    header_string("build_type", PICOMEMPERF_BUILD_TYPE);
+    header_string("c_flags", PICOMEMPERF_C_FLAGS);
+
+    //  Chip and clocks
+    header_string("board_id", board_id);
+    header_int("chip_version", rp2350_chip_version());
+    header_int("clk_sys_hz", (int)clock_get_hz(clk_sys));
+    header_int("clk_peri_hz", (int)clock_get_hz(clk_peri));
+    header_int("vreg_vsel", (int)vsel);
+    header_int("vreg_mv", s_vreg_mv[vsel & 0x1F]);
+
+    //  Memory setup
+    header_hex("psram_id", (s_psram_kgd << 8) | s_psram_eid);
+    header_int("psram_size", (int)_psram_size);
+    header_hex("xip_ctrl", xip_ctrl_hw->ctrl);
+    header_qmi_window(0);
+    header_qmi_window(1);
+
+    //  Test setup
+    header_int("test_size", TEST_SIZE);
+    header_int("loop_scale", LOOP_SCALE);
+    header_hex("isolation", isolation_get_mode());
+    header_string("result_format", result_format_name(result_get_format()));
+
+    header_string("end", "");
+}
@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "self_check.h"
+
+static uint32_t golden_checksum(const golden_baseline *golden)
+{
+    const uint8_t *data = (const uint8_t *)golden;
+    uint32_t hash = 0x811C9DC5;
+
+    for (size_t i = 0; i < offsetof(golden_baseline, checksum); i++)
+    {
+        hash = (hash ^ data[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+void golden_init(golden_baseline *golden, uint32_t clock_hz, uint32_t psram_size, uint32_t psram_id)
+{
+    //  Zeroed so the unused entries and padding checksum the same every time
+    memset(golden, 0, sizeof(golden_baseline));
+    golden->magic = GOLDEN_MAGIC;
+    golden->version = GOLDEN_VERSION;
+    golden->clock_hz = clock_hz;
+    golden->psram_size = psram_size;
+    golden->psram_id = psram_id;
+}
+
+bool golden_add(golden_baseline *golden, const char *name, uint32_t size, uint32_t loop_scale, uint64_t us)
+{
+    if ((golden->count == GOLDEN_MAX_TESTS) || (strlen(name) >= GOLDEN_NAME_SIZE) || (us > UINT32_MAX))
+    {
+        return false;
+    }
+
+    golden_entry *entry = &golden->entries[golden->count++];
+    strcpy(entry->name, name);
+    entry->size = size;
+    entry->loop_scale = loop_scale;
+    entry->us = (uint32_t)us;
+    return true;
+}
+
+void golden_seal(golden_baseline *golden)
+{
+    golden->checksum = golden_checksum(golden);
+}
+
+bool golden_valid(const golden_baseline *golden)
+{
+    return (golden->magic == GOLDEN_MAGIC) && (golden->version == GOLDEN_VERSION) &&
+           (golden->count <= GOLDEN_MAX_TESTS) && (golden->checksum == golden_checksum(golden));
+}
+
+const golden_entry *golden_find(const golden_baseline *golden, const char *name)
+{
+    for (uint32_t i = 0; i < golden->count; i++)
+    {
+        if (strcmp(golden->entries[i].name, name) == 0)
+        {
+            return &golden->entries[i];
+        }
+    }
+    return NULL;
+}
+
+self_check_grade self_check_grade_result(const golden_entry *entry, uint64_t us, const self_check_bands *bands, int32_t *deviation)
+{
+    *deviation = 0;
+    if ((entry == NULL) || (entry->us == 0) || (us == 0))
+    {
+        return SELF_CHECK_FAIL;
+    }
+
+    //  Tenths of a percent, in 64 bits so big counts can't overflow
+    int64_t difference = (int64_t)us - (int64_t)entry->us;
+    int64_t permille = (difference * 1000) / (int64_t)entry->us;
+    uint64_t magnitude = (permille < 0) ? -permille : permille;
+
+    *deviation = (permille > INT32_MAX) ? INT32_MAX : (int32_t)permille;
+
+    if (magnitude <= (uint64_t)bands->degraded_pct * 10)
+    {
+        return SELF_CHECK_PASS;
+    }
+    if (magnitude <= (uint64_t)bands->fail_pct * 10)
+    {
+        return SELF_CHECK_DEGRADED;
+    }
+    return SELF_CHECK_FAIL;
+}
+
+self_check_grade self_check_grade_board(const golden_baseline *golden, uint32_t clock_hz, uint32_t psram_size, uint32_t psram_id)
+{
+    if ((golden->psram_size != psram_size) || (golden->psram_id != psram_id))
+    {
+        return SELF_CHECK_FAIL;
+    }
+    if (golden->clock_hz != clock_hz)
+    {
+        return SELF_CHECK_DEGRADED;
+    }
+    return SELF_CHECK_PASS;
+}
+
+const char *self_check_grade_name(self_check_grade grade)
+{
+    static const char * const names[] = { "pass", "degraded", "fail" };
+    return (grade <= SELF_CHECK_FAIL) ? names[grade] : "?";
+}
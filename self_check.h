@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Golden baseline and self check grading
+//
+//  A golden baseline is the times of a short profile of tests run
+//  on a known good board, with the clock and PSRAM it had.  A self check
+//  runs the same profile and grades every test by how far it is from the
+//  baseline, either way, since a faster result is just as suspect (wrong
+//  window, cache on):
+//
+//      within degraded_pct             pass
+//      within fail_pct                 degraded
+//      further, or missing             fail
+//
+//  A different PSRAM (ID or size) fails the whole check, a different clock
+//  makes times incomparable so it's degraded at best.  Nothing in
+//  here touches the SDK, the host build uses the same grading.
+
+#ifndef SELF_CHECK_H
+#define SELF_CHECK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GOLDEN_MAX_TESTS            16
+#define GOLDEN_NAME_SIZE            32
+#define GOLDEN_MAGIC                0x444C4F47      //  "GOLD"
+#define GOLDEN_VERSION              2               //  Profile over a small window since 2
+
+#define SELF_CHECK_DEGRADED_PCT     5
+#define SELF_CHECK_FAIL_PCT         25
+
+typedef enum
+{
+    SELF_CHECK_PASS,
+    SELF_CHECK_DEGRADED,
+    SELF_CHECK_FAIL,
+} self_check_grade;
+
+typedef struct
+{
+    char name[GOLDEN_NAME_SIZE];
+    uint32_t size;                      //  Words
+    uint32_t loop_scale;
+    uint32_t us;                        //  Overhead corrected memory_test() time
+} golden_entry;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t clock_hz;
+    uint32_t psram_size;
+    uint32_t psram_id;                  //  KGD << 8 | EID
+    uint32_t reserved[2];
+    golden_entry entries[GOLDEN_MAX_TESTS];
+    uint32_t checksum;                  //  FNV-1a of everything before it
+} golden_baseline;
+
+typedef struct
+{
+    uint32_t degraded_pct;
+    uint32_t fail_pct;
+} self_check_bands;
+
+void golden_init(golden_baseline *golden, uint32_t clock_hz, uint32_t psram_size, uint32_t psram_id);
+bool golden_add(golden_baseline *golden, const char *name, uint32_t size, uint32_t loop_scale, uint64_t us);
+
+//  Checksum it once it's complete, golden_valid() checks magic, version, count and checksum
+void golden_seal(golden_baseline *golden);
+bool golden_valid(const golden_baseline *golden);
+
+const golden_entry *golden_find(const golden_baseline *golden, const char *name);
+
+//  Grade one result, deviation from the baseline in tenths of a percent, + is slower
+self_check_grade self_check_grade_result(const golden_entry *entry, uint64_t us, const self_check_bands *bands, int32_t *deviation);
+
+//  Grade the board against the one the baseline came from
+self_check_grade self_check_grade_board(const golden_baseline *golden, uint32_t clock_hz, uint32_t psram_size, uint32_t psram_id);
+
+static inline self_check_grade self_check_worse(self_check_grade a, self_check_grade b)
+{
+    return (a > b) ? a : b;
+}
+
+const char *self_check_grade_name(self_check_grade grade);
+
+#endif
@@ -0,0 +1,290 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "shell.h"
+
+void shell_init(shell *sh, const shell_command *commands, int command_count, const char *prompt, bool echo)
+{
+    sh->commands = commands;
+    sh->command_count = command_count;
+    sh->prompt = prompt;
+    sh->capture = NULL;
+    sh->echo = echo;
+    sh->overflow = false;
+    sh->length = 0;
+}
+
+void shell_capture(shell *sh, shell_line_handler handler)
+{
+    sh->capture = handler;
+}
+
+void shell_prompt(const shell *sh)
+{
+    if (sh->capture != NULL)
+    {
+        return;
+    }
+    printf("%s", sh->prompt);
+    fflush(stdout);
+}
+
+void shell_help(const shell *sh)
+{
+    for (int i = 0; i < sh->command_count; i++)
+    {
+        const shell_command *command = &sh->commands[i];
+        printf("  %s %s\n      %s\n", command->name, command->args ? command->args : "", command->help);
+    }
+}
+
+bool shell_input_char(shell *sh, int c)
+{
+    if ((c == '\r') || (c == '\n'))
+    {
+        if (sh->echo)
+        {
+            printf("\n");
+        }
+
+        //  CR LF is one line, the LF gives an empty line which is dropped
+        if (sh->overflow)
+        {
+            printf("Error, line too long\n");
+        }
+        else if (sh->length != 0)
+        {
+            sh->line[sh->length] = 0;
+            if (sh->capture != NULL)
+            {
+                sh->capture(sh, sh->line);
+            }
+            else
+            {
+                shell_execute(sh, sh->line);
+            }
+        }
+
+        bool executed = sh->overflow || (sh->length != 0);
+        sh->overflow = false;
+        sh->length = 0;
+
+        if (executed)
+        {
+            shell_prompt(sh);
+        }
+        return executed;
+    }
+
+    if ((c == '\b') || (c == 0x7F))
+    {
+        if (sh->length > 0)
+        {
+            sh->length--;
+            if (sh->echo)
+            {
+                printf("\b \b");
+            }
+        }
+        return false;
+    }
+
+    if (c == '\t')
+    {
+        c = ' ';
+    }
+    if ((c < ' ') || (c > '~'))
+    {
+        return false;
+    }
+
+    if (sh->length < (SHELL_LINE_SIZE - 1))
+    {
+        sh->line[sh->length++] = (char)c;
+        if (sh->echo)
+        {
+            putchar(c);
+        }
+    }
+    else
+    {
+        sh->overflow = true;
+    }
+    fflush(stdout);
+
+    return false;
+}
+
+int shell_tokenize(char *line, char **argv, int max_args)
+{
+    int argc = 0;
+    char *p = line;
+
+    while (true)
+    {
+        while ((*p == ' ') || (*p == '\t'))
+        {
+            p++;
+        }
+        if ((*p == 0) || (*p == '#'))
+        {
+            break;
+        }
+        if (argc == max_args)
+        {
+            return -1;
+        }
+
+        argv[argc++] = p;
+        while ((*p != 0) && (*p != ' ') && (*p != '\t'))
+        {
+            p++;
+        }
+        if (*p != 0)
+        {
+            *p++ = 0;
+        }
+    }
+
+    return argc;
+}
+
+int shell_execute(shell *sh, char *line)
+{
+    char *argv[SHELL_MAX_ARGS];
+    int argc = shell_tokenize(line, argv, SHELL_MAX_ARGS);
+
+    if (argc < 0)
+    {
+        printf("Error, too many arguments\n");
+        return SHELL_TOO_LONG;
+    }
+    if (argc == 0)
+    {
+        return SHELL_EMPTY;
+    }
+
+    for (int i = 0; i < sh->command_count; i++)
+    {
+        const shell_command *command = &sh->commands[i];
+        if (strcasecmp(argv[0], command->name) == 0)
+        {
+            int result = command->handler(sh, argc, argv);
+            if (result == SHELL_USAGE)
+            {
+                printf("Usage, %s %s\n", command->name, command->args ? command->args : "");
+            }
+            return result;
+        }
+    }
+
+    printf("Error, unknown command, %s\n", argv[0]);
+    return SHELL_UNKNOWN;
+}
+
+bool shell_parse_uint(const char *text, uint32_t *value)
+{
+    uint64_t result = 0;
+    uint32_t base = 10;
+    const char *p = text;
+    const char *digits;
+
+    if ((p[0] == '0') && ((p[1] == 'x') || (p[1] == 'X')))
+    {
+        base = 16;
+        p += 2;
+    }
+    if (*p == 0)
+    {
+        return false;
+    }
+
+    for (digits = p; *p != 0; p++)
+    {
+        uint32_t digit;
+
+        if ((*p >= '0') && (*p <= '9'))
+        {
+            digit = *p - '0';
+        }
+        else if ((base == 16) && (*p >= 'a') && (*p <= 'f'))
+        {
+            digit = *p - 'a' + 10;
+        }
+        else if ((base == 16) && (*p >= 'A') && (*p <= 'F'))
+        {
+            digit = *p - 'A' + 10;
+        }
+        else
+        {
+            break;
+        }
+
+        result = result * base + digit;
+        if (result > UINT32_MAX)
+        {
+            return false;
+        }
+    }
+
+    //  At least one digit, then a suffix has to be the last character
+    if (p == digits)
+    {
+        return false;
+    }
+    if ((*p == 'k') || (*p == 'K'))
+    {
+        result *= 1024;
+        p++;
+    }
+    else if ((*p == 'm') || (*p == 'M'))
+    {
+        result *= 1024 * 1024;
+        p++;
+    }
+
+    if ((*p != 0) || (result > UINT32_MAX))
+    {
+        return false;
+    }
+
+    *value = (uint32_t)result;
+    return true;
+}
+
+int shell_match(const char *text, const char * const *names, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (strcasecmp(text, names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Line oriented command shell
+//
+//  Characters are fed in one at a time from whatever stdio has (USB CDC or
+//  UART), a complete line is split on whitespace and dispatched through a
+//  table of commands.  Nothing in here touches the SDK so the parser builds
+//  on the host too.  '#' starts a comment, so scripts can be pasted in.
+
+#ifndef SHELL_H
+#define SHELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SHELL_LINE_SIZE     128
+#define SHELL_MAX_ARGS      12
+
+//  shell_execute() results, handlers return SHELL_OK or SHELL_USAGE / SHELL_ERROR
+#define SHELL_OK            0
+#define SHELL_EMPTY         1           //  Blank or comment line
+#define SHELL_USAGE         -1          //  Bad arguments, usage printed
+#define SHELL_ERROR         -2          //  Handler failed, it printed why
+#define SHELL_UNKNOWN       -3          //  No such command
+#define SHELL_TOO_LONG      -4          //  Line or argument count overflow
+
+typedef struct shell shell;
+
+typedef int (*shell_handler)(shell *sh, int argc, char **argv);
+
+//  Takes whole lines in place of the command table, e.g. while a plan is pasted in
+typedef int (*shell_line_handler)(shell *sh, char *line);
+
+typedef struct
+{
+    const char *name;
+    const char *args;                   //  Usage, shown by help
+    const char *help;
+    shell_handler handler;
+} shell_command;
+
+struct shell
+{
+    const shell_command *commands;
+    int command_count;
+    const char *prompt;
+    shell_line_handler capture;         //  NULL for commands
+    bool echo;                          //  Echo input, terminals don't do it for us
+    bool overflow;                      //  Current line is too long, discard it
+    int length;
+    char line[SHELL_LINE_SIZE];
+};
+
+void shell_init(shell *sh, const shell_command *commands, int command_count, const char *prompt, bool echo);
+void shell_prompt(const shell *sh);
+void shell_help(const shell *sh);
+
+//  Send lines to handler until it calls shell_capture(sh, NULL)
+void shell_capture(shell *sh, shell_line_handler handler);
+
+//  Feed one input character, returns true when it completed a line
+bool shell_input_char(shell *sh, int c);
+
+//  Run one line, line is modified
+int shell_execute(shell *sh, char *line);
+
+//  Split line in place on whitespace, returns the argument count or -1 if there are too many
+int shell_tokenize(char *line, char **argv, int max_args);
+
+//  Decimal or 0x hex, with an optional K or M suffix
+bool shell_parse_uint(const char *text, uint32_t *value);
+
+//  Index into a table of names, -1 if none match
+int shell_match(const char *text, const char * const *names, int count);
+
+#endif
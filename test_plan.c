@@ -0,0 +1,404 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "shell.h"
+#include "test_plan.h"
+#include "result_out.h"
+
+static const char * const s_plan_region_names[PLAN_REGION_COUNT] = { "sram", "rom", "psram", "nocache" };
+static const char * const s_plan_kernel_names[PLAN_KERNEL_COUNT] = { "lcg", "table" };
+static const char * const s_plan_pattern_names[] = { "seq", "rnd" };
+static const char * const s_plan_op_names[] = { "write", "read" };
+
+const char *test_plan_region_name(plan_region region)
+{
+    return (region < PLAN_REGION_COUNT) ? s_plan_region_names[region] : "?";
+}
+
+int test_plan_region_match(const char *text)
+{
+    return shell_match(text, s_plan_region_names, PLAN_REGION_COUNT);
+}
+
+void test_plan_init(test_plan *plan)
+{
+    memset(plan, 0, sizeof(test_plan));
+}
+
+static int plan_error(test_plan *plan, int line_number, const char *message, const char *detail)
+{
+    plan->error_line = line_number;
+    snprintf(plan->error, PLAN_ERROR_SIZE, "%s%s%s", message, detail ? ", " : "", detail ? detail : "");
+    return PLAN_ERROR;
+}
+
+static bool copy_name(char *name, const char *text)
+{
+    if (strlen(text) >= PLAN_NAME_SIZE)
+    {
+        return false;
+    }
+    strcpy(name, text);
+    return true;
+}
+
+//  "first" or "first..last"
+static bool parse_size_range(char *text, uint32_t *first, uint32_t *last)
+{
+    char *range = strstr(text, "..");
+
+    if (range == NULL)
+    {
+        if (!shell_parse_uint(text, first))
+        {
+            return false;
+        }
+        *last = *first;
+        return true;
+    }
+
+    *range = 0;
+    return shell_parse_uint(text, first) && shell_parse_uint(range + 2, last);
+}
+
+static int parse_entry(test_plan *plan, int argc, char **argv, int line_number)
+{
+    if (argc < 2)
+    {
+        return plan_error(plan, line_number, "test needs a name", NULL);
+    }
+    if (plan->count == PLAN_MAX_ENTRIES)
+    {
+        return plan_error(plan, line_number, "too many tests", NULL);
+    }
+
+    plan_entry *entry = &plan->entries[plan->count];
+
+    memset(entry, 0, sizeof(plan_entry));
+    if (!copy_name(entry->name, argv[1]))
+    {
+        return plan_error(plan, line_number, "name too long", argv[1]);
+    }
+    entry->region = PLAN_REGION_SRAM;
+    entry->kernel = PLAN_KERNEL_LCG;
+    entry->read = true;
+    entry->random = false;
+    entry->size_first = PLAN_DEFAULT_SIZE;
+    entry->size_last = PLAN_DEFAULT_SIZE;
+    entry->size_factor = PLAN_DEFAULT_FACTOR;
+    entry->loop_scale = PLAN_DEFAULT_LOOPS;
+    entry->repetitions = 1;
+
+    for (int i = 2; i < argc; i++)
+    {
+        char *key = argv[i];
+        char *value = strchr(key, '=');
+        int match;
+        bool ok;
+
+        if (value == NULL)
+        {
+            return plan_error(plan, line_number, "expected key=value", key);
+        }
+        *value++ = 0;
+
+        if (strcmp(key, "region") == 0)
+        {
+            ok = ((match = shell_match(value, s_plan_region_names, PLAN_REGION_COUNT)) >= 0);
+            entry->region = (plan_region)match;
+        }
+        else if (strcmp(key, "kernel") == 0)
+        {
+            ok = ((match = shell_match(value, s_plan_kernel_names, PLAN_KERNEL_COUNT)) >= 0);
+            entry->kernel = (plan_kernel)match;
+        }
+        else if (strcmp(key, "op") == 0)
+        {
+            ok = ((match = shell_match(value, s_plan_op_names, 2)) >= 0);
+            entry->read = (match == 1);
+        }
+        else if (strcmp(key, "pattern") == 0)
+        {
+            ok = ((match = shell_match(value, s_plan_pattern_names, 2)) >= 0);
+            entry->random = (match == 1);
+        }
+        else if (strcmp(key, "size") == 0)
+        {
+            ok = parse_size_range(value, &entry->size_first, &entry->size_last);
+        }
+        else if (strcmp(key, "factor") == 0)
+        {
+            ok = shell_parse_uint(value, &entry->size_factor);
+        }
+        else if (strcmp(key, "loops") == 0)
+        {
+            ok = shell_parse_uint(value, &entry->loop_scale);
+        }
+        else if (strcmp(key, "offset") == 0)
+        {
+            ok = shell_parse_uint(value, &entry->offset);
+        }
+        else if (strcmp(key, "reps") == 0)
+        {
+            ok = shell_parse_uint(value, &entry->repetitions);
+        }
+        else
+        {
+            return plan_error(plan, line_number, "unknown key", key);
+        }
+
+        if (!ok)
+        {
+            return plan_error(plan, line_number, "bad value", key);
+        }
+    }
+
+    plan->count++;
+    return PLAN_OK;
+}
+
+int test_plan_parse_line(test_plan *plan, char *line, int line_number)
+{
+    char *argv[SHELL_MAX_ARGS];
+    int argc = shell_tokenize(line, argv, SHELL_MAX_ARGS);
+
+    if (argc < 0)
+    {
+        return plan_error(plan, line_number, "too many fields", NULL);
+    }
+    if (argc == 0)
+    {
+        return PLAN_OK;
+    }
+    if (plan->complete)
+    {
+        return plan_error(plan, line_number, "text after end", argv[0]);
+    }
+
+    if (strcmp(argv[0], "plan") == 0)
+    {
+        if (plan->started)
+        {
+            return plan_error(plan, line_number, "plan already started", NULL);
+        }
+        if ((argc != 2) || !copy_name(plan->name, argv[1]))
+        {
+            return plan_error(plan, line_number, "plan needs a short name", NULL);
+        }
+        plan->started = true;
+        return PLAN_OK;
+    }
+
+    if (!plan->started)
+    {
+        return plan_error(plan, line_number, "expected plan <name>", argv[0]);
+    }
+
+    if (strcmp(argv[0], "test") == 0)
+    {
+        return parse_entry(plan, argc, argv, line_number);
+    }
+
+    if (strcmp(argv[0], "end") == 0)
+    {
+        plan->complete = true;
+        return PLAN_DONE;
+    }
+
+    return plan_error(plan, line_number, "unknown line", argv[0]);
+}
+
+bool test_plan_parse(test_plan *plan, const char *text, size_t length, const plan_limits *limits)
+{
+    char line[SHELL_LINE_SIZE];
+    int line_number = 1;
+    size_t used = 0;
+
+    test_plan_init(plan);
+
+    for (size_t i = 0; i <= length; i++)
+    {
+        char c = (i < length) ? text[i] : '\n';
+
+        if ((c == '\n') || (c == 0))
+        {
+            line[used] = 0;
+            if (test_plan_parse_line(plan, line, line_number) == PLAN_ERROR)
+            {
+                return false;
+            }
+            used = 0;
+            line_number++;
+
+            if (c == 0)
+            {
+                break;
+            }
+        }
+        else if (c != '\r')
+        {
+            if (used == (SHELL_LINE_SIZE - 1))
+            {
+                plan_error(plan, line_number, "line too long", NULL);
+                return false;
+            }
+            line[used++] = c;
+        }
+    }
+
+    if (!plan->complete)
+    {
+        plan_error(plan, line_number, "missing end", NULL);
+        return false;
+    }
+
+    return (limits == NULL) || test_plan_validate(plan, limits);
+}
+
+const char *test_plan_check_entry(const plan_entry *entry, const plan_limits *limits)
+{
+    uint64_t end = entry->offset + ((uint64_t)entry->size_last * sizeof(uint32_t));
+
+    if ((entry->size_first == 0) || (entry->size_last < entry->size_first))
+    {
+        return "bad size range";
+    }
+    if ((entry->size_last != entry->size_first) && (entry->size_factor < 2))
+    {
+        return "sweep factor must be 2 or more";
+    }
+    if ((entry->loop_scale == 0) || (entry->loop_scale > INT32_MAX))
+    {
+        return "bad loops";
+    }
+    if ((entry->repetitions == 0) || (entry->repetitions > PLAN_MAX_REPETITIONS))
+    {
+        return "bad reps";
+    }
+    if ((entry->offset % sizeof(uint32_t)) != 0)
+    {
+        return "offset must be word aligned";
+    }
+    if ((entry->kernel == PLAN_KERNEL_TABLE) && !entry->random)
+    {
+        return "kernel=table needs pattern=rnd";
+    }
+    if ((entry->region == PLAN_REGION_ROM) && !entry->read)
+    {
+        return "rom is read only";
+    }
+
+    //  Writes stay in the test buffers, PSRAM reads can run over the whole device
+    if (end > (uint64_t)limits->buffer_words * sizeof(uint32_t))
+    {
+        bool psram = (entry->region == PLAN_REGION_PSRAM) || (entry->region == PLAN_REGION_NOCACHE);
+
+        if (!entry->read || !psram)
+        {
+            return "window past the test buffer";
+        }
+        if (end > limits->psram_bytes)
+        {
+            return "window past the end of PSRAM";
+        }
+    }
+
+    return NULL;
+}
+
+bool test_plan_validate(test_plan *plan, const plan_limits *limits)
+{
+    for (int i = 0; i < plan->count; i++)
+    {
+        const char *error = test_plan_check_entry(&plan->entries[i], limits);
+        if (error != NULL)
+        {
+            plan->error_line = 0;
+            snprintf(plan->error, PLAN_ERROR_SIZE, "%s, %s", plan->entries[i].name, error);
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t test_plan_format(const test_plan *plan, char *buffer, size_t size)
+{
+    size_t used = 0;
+
+#define PLAN_APPEND(...)    used += snprintf(buffer + ((used < size) ? used : size), (used < size) ? (size - used) : 0, __VA_ARGS__)
+
+    PLAN_APPEND("plan %s\n", plan->name);
+    for (int i = 0; i < plan->count; i++)
+    {
+        const plan_entry *entry = &plan->entries[i];
+
+        PLAN_APPEND("test %s region=%s op=%s pattern=%s kernel=%s size=%lu", entry->name,
+                    s_plan_region_names[entry->region], s_plan_op_names[entry->read ? 1 : 0],
+                    s_plan_pattern_names[entry->random ? 1 : 0], s_plan_kernel_names[entry->kernel],
+                    (long unsigned int)entry->size_first);
+        if (entry->size_last != entry->size_first)
+        {
+            PLAN_APPEND("..%lu factor=%lu", (long unsigned int)entry->size_last, (long unsigned int)entry->size_factor);
+        }
+        PLAN_APPEND(" loops=%lu offset=%lu reps=%lu\n", (long unsigned int)entry->loop_scale,
+                    (long unsigned int)entry->offset, (long unsigned int)entry->repetitions);
+    }
+    PLAN_APPEND("end\n");
+
+#undef PLAN_APPEND
+
+    return used;
+}
+
+bool test_plan_next_size(const plan_entry *entry, uint32_t *size)
+{
+    uint64_t next = (uint64_t)*size * entry->size_factor;
+
+    if ((entry->size_last == entry->size_first) || (next > entry->size_last))
+    {
+        return false;
+    }
+    *size = (uint32_t)next;
+    return true;
+}
+
+void plan_result(const test_plan *plan, const plan_entry *entry, uint32_t size, uint32_t rep, uint32_t window,
+                 uint64_t result, uint64_t overhead, uint64_t corrected)
+{
+    result_record record;
+
+    result_begin(&record, "Plan");
+    result_str(&record, "plan", plan->name);
+    result_str(&record, "test", entry->name);
+    result_u64(&record, "size", size);
+    result_u64(&record, "rep", rep);
+    result_hex(&record, "window", window);
+    result_u64(&record, "result", result);
+    result_u64(&record, "overhead", overhead);
+    result_u64(&record, "corrected", corrected);
+    result_end(&record);
+}
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Declarative test plans
+//
+//  A plan is plain text, one test per line, so it can be pasted into the
+//  shell, kept in the flash plan partition or checked on the host:
+//
+//      plan psram_campaign
+//      test rnd_psram region=psram op=read pattern=rnd size=256..16K factor=2 loops=50 reps=3
+//      test seq_sram region=sram op=write pattern=seq size=16K
+//      test rnd_table region=nocache op=read pattern=rnd kernel=table size=12K
+//      end
+//
+//  Anything not given takes the default below.  A size range is a sweep,
+//  multiplying by factor each step.  '#' starts a comment.
+
+#ifndef TEST_PLAN_H
+#define TEST_PLAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PLAN_MAX_ENTRIES        32
+#define PLAN_NAME_SIZE          24
+#define PLAN_ERROR_SIZE         64
+#define PLAN_MAX_REPETITIONS    1000
+
+//  Defaults, the same as the built in table
+#define PLAN_DEFAULT_SIZE       (16 * 1024)
+#define PLAN_DEFAULT_LOOPS      200
+#define PLAN_DEFAULT_FACTOR     2
+
+//  test_plan_parse_line() results
+#define PLAN_OK                 0
+#define PLAN_DONE               1           //  "end" seen, the plan is complete
+#define PLAN_ERROR              -1
+
+typedef enum
+{
+    PLAN_REGION_SRAM,
+    PLAN_REGION_ROM,
+    PLAN_REGION_PSRAM,
+    PLAN_REGION_NOCACHE,
+    PLAN_REGION_COUNT
+} plan_region;
+
+typedef enum
+{
+    PLAN_KERNEL_LCG,                        //  Inline LCG, masked or range reduced
+    PLAN_KERNEL_TABLE,                      //  Precomputed index table
+    PLAN_KERNEL_COUNT
+} plan_kernel;
+
+typedef struct
+{
+    char name[PLAN_NAME_SIZE];
+    plan_region region;
+    plan_kernel kernel;
+    bool read;
+    bool random;
+    uint32_t size_first;                    //  Words
+    uint32_t size_last;
+    uint32_t size_factor;
+    uint32_t loop_scale;
+    uint32_t offset;                        //  Bytes into the region
+    uint32_t repetitions;
+} plan_entry;
+
+typedef struct
+{
+    char name[PLAN_NAME_SIZE];
+    bool started;                           //  "plan" line seen
+    bool complete;                          //  "end" line seen
+    int count;
+    plan_entry entries[PLAN_MAX_ENTRIES];
+    int error_line;
+    char error[PLAN_ERROR_SIZE];
+} test_plan;
+
+//  What the target has, for validation
+typedef struct
+{
+    uint32_t buffer_words;                  //  Size of each test buffer, writes have to fit
+    uint32_t psram_bytes;                   //  Reads from PSRAM can run this far
+} plan_limits;
+
+void test_plan_init(test_plan *plan);
+
+//  Parse one line, line is modified.  Returns PLAN_OK, PLAN_DONE or PLAN_ERROR
+//  with plan->error / error_line set.
+int test_plan_parse_line(test_plan *plan, char *line, int line_number);
+
+//  Parse a whole text plan, true if it's complete and valid for limits
+bool test_plan_parse(test_plan *plan, const char *text, size_t length, const plan_limits *limits);
+
+//  Check every entry fits the target, sets plan->error on the first that doesn't
+bool test_plan_validate(test_plan *plan, const plan_limits *limits);
+const char *test_plan_check_entry(const plan_entry *entry, const plan_limits *limits);
+
+//  Back to text, returns the length needed (like snprintf)
+size_t test_plan_format(const test_plan *plan, char *buffer, size_t size);
+
+//  Next size in an entry's sweep, false after the last
+bool test_plan_next_size(const plan_entry *entry, uint32_t *size);
+
+//  One "Plan" result record, the same from the board and the host runner
+#define PLAN_RESULT_CSV_HEADER  "Plan, plan, test, size, rep, window, result, overhead, corrected\n"
+
+void plan_result(const test_plan *plan, const plan_entry *entry, uint32_t size, uint32_t rep, uint32_t window,
+                 uint64_t result, uint64_t overhead, uint64_t corrected);
+
+const char *test_plan_region_name(plan_region region);
+int test_plan_region_match(const char *text);
+
+#endif
@@ -0,0 +1,588 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "tlsf.h"
+#include "portable.h"
+#include <string.h>
+
+//  Block layout
+//
+//  Every block starts with a header holding the previous physical block and
+//  the payload size.  The low bit of the size marks the block as free.  While
+//  a block is free the first two words of its payload hold the free list
+//  links, which sets the minimum payload size.  The pool ends with a zero
+//  sized used sentinel block so merging never runs off the end.
+
+struct tlsf_block
+{
+    tlsf_block *prev_phys;
+    size_t size;
+
+    //  Only valid while the block is free
+    tlsf_block *next_free;
+    tlsf_block *prev_free;
+};
+
+#define BLOCK_HEADER_SIZE   (offsetof(tlsf_block, next_free))
+#define BLOCK_MIN_SIZE      (sizeof(tlsf_block) - BLOCK_HEADER_SIZE)
+#define BLOCK_MAX_SIZE      (((size_t)1 << TLSF_FL_MAX) - TLSF_ALIGN_SIZE)
+#define BLOCK_FREE_BIT      ((size_t)1)
+#define BLOCK_SIZE_MASK     (~(size_t)(TLSF_ALIGN_SIZE - 1))
+
+static inline size_t align_up(size_t x, size_t align)
+{
+    return (x + (align - 1)) & ~(align - 1);
+}
+
+static inline int tlsf_fls(size_t x)
+{
+    return (int)(sizeof(unsigned long) * 8) - 1 - __builtin_clzl((unsigned long)x);
+}
+
+static inline int tlsf_ffs(uint32_t x)
+{
+    return __builtin_ctz(x);
+}
+
+static inline size_t block_size(const tlsf_block *block)
+{
+    return block->size & BLOCK_SIZE_MASK;
+}
+
+static inline bool block_is_free(const tlsf_block *block)
+{
+    return (block->size & BLOCK_FREE_BIT) != 0;
+}
+
+static inline void block_set_size(tlsf_block *block, size_t size)
+{
+    block->size = size | (block->size & BLOCK_FREE_BIT);
+}
+
+static inline void block_set_free(tlsf_block *block, bool free)
+{
+    block->size = free ? (block->size | BLOCK_FREE_BIT) : (block->size & ~BLOCK_FREE_BIT);
+}
+
+static inline void *block_to_ptr(tlsf_block *block)
+{
+    return (uint8_t *)block + BLOCK_HEADER_SIZE;
+}
+
+static inline tlsf_block *block_from_ptr(void *ptr)
+{
+    return (tlsf_block *)((uint8_t *)ptr - BLOCK_HEADER_SIZE);
+}
+
+static inline tlsf_block *block_next(tlsf_block *block)
+{
+    return (tlsf_block *)((uint8_t *)block_to_ptr(block) + block_size(block));
+}
+
+//  Size to list index
+
+static inline void mapping_insert(size_t size, int *fl, int *sl)
+{
+    if (size < TLSF_SMALL_BLOCK)
+    {
+        *fl = 0;
+        *sl = (int)(size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT));
+    }
+    else
+    {
+        int f = tlsf_fls(size);
+        *sl = (int)((size >> (f - TLSF_SL_SHIFT)) ^ TLSF_SL_COUNT);
+        *fl = f - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+//  Round the size up to the next list so any block found there is big enough
+static inline void mapping_search(size_t size, int *fl, int *sl)
+{
+    if (size >= TLSF_SMALL_BLOCK)
+    {
+        size += ((size_t)1 << (tlsf_fls(size) - TLSF_SL_SHIFT)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static inline size_t adjust_request(size_t size)
+{
+    if ((size == 0) || (size > BLOCK_MAX_SIZE))
+    {
+        return 0;
+    }
+
+    size = align_up(size, TLSF_ALIGN_SIZE);
+    return (size < BLOCK_MIN_SIZE) ? BLOCK_MIN_SIZE : size;
+}
+
+//  Free lists
+
+static void __time_critical_func(insert_free_block)(tlsf_heap *heap, tlsf_block *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+
+    tlsf_block *head = heap->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head != NULL)
+    {
+        head->prev_free = block;
+    }
+    heap->blocks[fl][sl] = block;
+    heap->fl_bitmap |= (1u << fl);
+    heap->sl_bitmap[fl] |= (1u << sl);
+}
+
+static void __time_critical_func(remove_free_block)(tlsf_heap *heap, tlsf_block *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+
+    tlsf_block *prev = block->prev_free;
+    tlsf_block *next = block->next_free;
+    if (next != NULL)
+    {
+        next->prev_free = prev;
+    }
+    if (prev != NULL)
+    {
+        prev->next_free = next;
+    }
+    else
+    {
+        heap->blocks[fl][sl] = next;
+        if (next == NULL)
+        {
+            heap->sl_bitmap[fl] &= ~(1u << sl);
+            if (heap->sl_bitmap[fl] == 0)
+            {
+                heap->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+}
+
+static tlsf_block *__time_critical_func(find_suitable_block)(tlsf_heap *heap, int fl, int sl)
+{
+    uint32_t sl_map = heap->sl_bitmap[fl] & (~0u << sl);
+    if (sl_map == 0)
+    {
+        uint32_t fl_map = heap->fl_bitmap & (~0u << (fl + 1));
+        if (fl_map == 0)
+        {
+            return NULL;
+        }
+        fl = tlsf_ffs(fl_map);
+        sl_map = heap->sl_bitmap[fl];
+    }
+    sl = tlsf_ffs(sl_map);
+
+    return heap->blocks[fl][sl];
+}
+
+//  Absorb next (free, already off its list) into block
+static inline void merge_next(tlsf_block *block, tlsf_block *next)
+{
+    block_set_size(block, block_size(block) + BLOCK_HEADER_SIZE + block_size(next));
+    block_next(block)->prev_phys = block;
+}
+
+//  Cut the tail of a used block beyond size into a new free block
+static void __time_critical_func(trim_used_block)(tlsf_heap *heap, tlsf_block *block, size_t size)
+{
+    if (block_size(block) < (size + BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE))
+    {
+        return;
+    }
+
+    tlsf_block *remaining = (tlsf_block *)((uint8_t *)block_to_ptr(block) + size);
+    remaining->prev_phys = block;
+    remaining->size = (block_size(block) - size - BLOCK_HEADER_SIZE) | BLOCK_FREE_BIT;
+    block_set_size(block, size);
+
+    tlsf_block *next = block_next(remaining);
+    next->prev_phys = remaining;
+    if (block_is_free(next))
+    {
+        remove_free_block(heap, next);
+        merge_next(remaining, next);
+    }
+
+    insert_free_block(heap, remaining);
+}
+
+//  Public API
+
+bool tlsf_create(tlsf_heap *heap, void *pool, size_t pool_size)
+{
+    memset(heap, 0, sizeof(tlsf_heap));
+
+    uint8_t *start = (uint8_t *)align_up((uintptr_t)pool, TLSF_ALIGN_SIZE);
+    size_t lost = (size_t)(start - (uint8_t *)pool);
+    if (pool_size < lost + (2 * BLOCK_HEADER_SIZE) + BLOCK_MIN_SIZE)
+    {
+        return false;
+    }
+
+    size_t size = (pool_size - lost - (2 * BLOCK_HEADER_SIZE)) & ~(size_t)(TLSF_ALIGN_SIZE - 1);
+    if (size > BLOCK_MAX_SIZE)
+    {
+        size = BLOCK_MAX_SIZE;
+    }
+
+    heap->pool = start;
+    heap->pool_size = size + (2 * BLOCK_HEADER_SIZE);
+
+    tlsf_block *block = (tlsf_block *)start;
+    block->prev_phys = NULL;
+    block->size = size | BLOCK_FREE_BIT;
+
+    tlsf_block *sentinel = block_next(block);
+    sentinel->prev_phys = block;
+    sentinel->size = 0;
+
+    insert_free_block(heap, block);
+
+    return true;
+}
+
+tlsf_heap *tlsf_create_in_place(void *mem, size_t mem_size)
+{
+    tlsf_heap *heap = (tlsf_heap *)align_up((uintptr_t)mem, sizeof(void *));
+    size_t control_size = align_up((size_t)((uint8_t *)heap - (uint8_t *)mem) + sizeof(tlsf_heap), TLSF_ALIGN_SIZE);
+    if (mem_size <= control_size)
+    {
+        return NULL;
+    }
+
+    if (!tlsf_create(heap, (uint8_t *)mem + control_size, mem_size - control_size))
+    {
+        return NULL;
+    }
+
+    return heap;
+}
+
+void *__time_critical_func(tlsf_malloc)(tlsf_heap *heap, size_t size)
+{
+    size_t adjust = adjust_request(size);
+    int fl, sl;
+
+    if (adjust != 0)
+    {
+        mapping_search(adjust, &fl, &sl);
+        if (fl < TLSF_FL_COUNT)
+        {
+            tlsf_block *block = find_suitable_block(heap, fl, sl);
+            if (block != NULL)
+            {
+                remove_free_block(heap, block);
+                block_set_free(block, false);
+                trim_used_block(heap, block, adjust);
+
+                heap->used_size += block_size(block);
+                if (heap->used_size > heap->peak_used_size)
+                {
+                    heap->peak_used_size = heap->used_size;
+                }
+                heap->alloc_count++;
+
+                return block_to_ptr(block);
+            }
+        }
+    }
+
+    heap->fail_count++;
+    return NULL;
+}
+
+void __time_critical_func(tlsf_free)(tlsf_heap *heap, void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    tlsf_block *block = block_from_ptr(ptr);
+    heap->used_size -= block_size(block);
+    heap->free_count++;
+
+    block_set_free(block, true);
+
+    tlsf_block *prev = block->prev_phys;
+    if ((prev != NULL) && block_is_free(prev))
+    {
+        remove_free_block(heap, prev);
+        merge_next(prev, block);
+        block = prev;
+    }
+
+    tlsf_block *next = block_next(block);
+    if (block_is_free(next))
+    {
+        remove_free_block(heap, next);
+        merge_next(block, next);
+    }
+
+    insert_free_block(heap, block);
+}
+
+void *__time_critical_func(tlsf_realloc)(tlsf_heap *heap, void *ptr, size_t size)
+{
+    if (ptr == NULL)
+    {
+        return tlsf_malloc(heap, size);
+    }
+    if (size == 0)
+    {
+        tlsf_free(heap, ptr);
+        return NULL;
+    }
+
+    size_t adjust = adjust_request(size);
+    if (adjust == 0)
+    {
+        heap->fail_count++;
+        return NULL;
+    }
+
+    tlsf_block *block = block_from_ptr(ptr);
+    size_t current = block_size(block);
+
+    if (adjust > current)
+    {
+        tlsf_block *next = block_next(block);
+        if (!block_is_free(next) || ((current + BLOCK_HEADER_SIZE + block_size(next)) < adjust))
+        {
+            //  Can't grow in place
+            void *moved = tlsf_malloc(heap, size);
+            if (moved != NULL)
+            {
+                memcpy(moved, ptr, current);
+                tlsf_free(heap, ptr);
+            }
+            return moved;
+        }
+
+        remove_free_block(heap, next);
+        merge_next(block, next);
+    }
+
+    trim_used_block(heap, block, adjust);
+
+    heap->used_size = heap->used_size - current + block_size(block);
+    if (heap->used_size > heap->peak_used_size)
+    {
+        heap->peak_used_size = heap->used_size;
+    }
+
+    return ptr;
+}
+
+void *tlsf_memalign(tlsf_heap *heap, size_t align, size_t size)
+{
+    const size_t gap_min = BLOCK_HEADER_SIZE + BLOCK_MIN_SIZE;
+    size_t adjust = adjust_request(size);
+    int fl, sl;
+
+    if (align <= TLSF_ALIGN_SIZE)
+    {
+        return tlsf_malloc(heap, size);
+    }
+
+    //  Room to cut a free block off the front to get to the alignment
+    if ((adjust != 0) && ((align & (align - 1)) == 0) && (adjust <= (BLOCK_MAX_SIZE - align - gap_min)))
+    {
+        mapping_search(adjust + align + gap_min, &fl, &sl);
+        tlsf_block *block = (fl < TLSF_FL_COUNT) ? find_suitable_block(heap, fl, sl) : NULL;
+        if (block != NULL)
+        {
+            remove_free_block(heap, block);
+
+            uint8_t *ptr = (uint8_t *)block_to_ptr(block);
+            uint8_t *aligned = (uint8_t *)align_up((uintptr_t)ptr, align);
+            if ((aligned != ptr) && ((size_t)(aligned - ptr) < gap_min))
+            {
+                aligned = (uint8_t *)align_up((uintptr_t)(ptr + gap_min), align);
+            }
+
+            //  The front stays free, its previous block is used since free blocks are always merged
+            size_t gap = (size_t)(aligned - ptr);
+            if (gap != 0)
+            {
+                tlsf_block *aligned_block = block_from_ptr(aligned);
+                aligned_block->prev_phys = block;
+                aligned_block->size = block_size(block) - gap;
+                block_next(aligned_block)->prev_phys = aligned_block;
+                block_set_size(block, gap - BLOCK_HEADER_SIZE);
+                insert_free_block(heap, block);
+                block = aligned_block;
+            }
+
+            block_set_free(block, false);
+            trim_used_block(heap, block, adjust);
+
+            heap->used_size += block_size(block);
+            if (heap->used_size > heap->peak_used_size)
+            {
+                heap->peak_used_size = heap->used_size;
+            }
+            heap->alloc_count++;
+
+            return block_to_ptr(block);
+        }
+    }
+
+    heap->fail_count++;
+    return NULL;
+}
+
+size_t tlsf_block_size(void *ptr)
+{
+    return (ptr != NULL) ? block_size(block_from_ptr(ptr)) : 0;
+}
+
+void tlsf_get_stats(tlsf_heap *heap, tlsf_stats *stats)
+{
+    memset(stats, 0, sizeof(tlsf_stats));
+
+    //  Never created, e.g. no PSRAM found
+    if (heap->pool == NULL)
+    {
+        return;
+    }
+
+    for (tlsf_block *block = (tlsf_block *)heap->pool; block_size(block) != 0; block = block_next(block))
+    {
+        size_t size = block_size(block);
+        if (block_is_free(block))
+        {
+            stats->free_blocks++;
+            stats->free_size += size;
+            if (size > stats->largest_free)
+            {
+                stats->largest_free = size;
+            }
+        }
+        else
+        {
+            stats->used_blocks++;
+            stats->used_size += size;
+        }
+    }
+
+    stats->total_size = heap->pool_size - (2 * BLOCK_HEADER_SIZE);
+    stats->peak_used_size = heap->peak_used_size;
+    stats->alloc_count = heap->alloc_count;
+    stats->free_count = heap->free_count;
+    stats->fail_count = heap->fail_count;
+    stats->fragmentation = (stats->free_size != 0) ? (1.0f - ((float)stats->largest_free / (float)stats->free_size)) : 0.0f;
+}
+
+bool tlsf_check(tlsf_heap *heap)
+{
+    uint32_t free_blocks = 0;
+    size_t used_size = 0;
+    tlsf_block *prev = NULL;
+    tlsf_block *block = (tlsf_block *)heap->pool;
+
+    //  Physical chain
+    while (true)
+    {
+        if (block->prev_phys != prev)
+        {
+            return false;
+        }
+        if (block_size(block) == 0)
+        {
+            break;
+        }
+        if ((block_size(block) < BLOCK_MIN_SIZE) || (((uintptr_t)block_to_ptr(block) & (TLSF_ALIGN_SIZE - 1)) != 0))
+        {
+            return false;
+        }
+        if (block_is_free(block))
+        {
+            if ((prev != NULL) && block_is_free(prev))
+            {
+                return false;
+            }
+            free_blocks++;
+        }
+        else
+        {
+            used_size += block_size(block);
+        }
+
+        prev = block;
+        block = block_next(block);
+        if ((uint8_t *)block >= heap->pool + heap->pool_size)
+        {
+            return false;
+        }
+    }
+
+    if (used_size != heap->used_size)
+    {
+        return false;
+    }
+
+    //  Free lists and bitmaps
+    uint32_t listed_blocks = 0;
+    for (int fl = 0; fl < TLSF_FL_COUNT; fl++)
+    {
+        bool fl_set = (heap->fl_bitmap & (1u << fl)) != 0;
+        if (fl_set != (heap->sl_bitmap[fl] != 0))
+        {
+            return false;
+        }
+
+        for (int sl = 0; sl < (int)TLSF_SL_COUNT; sl++)
+        {
+            bool sl_set = (heap->sl_bitmap[fl] & (1u << sl)) != 0;
+            if (sl_set != (heap->blocks[fl][sl] != NULL))
+            {
+                return false;
+            }
+
+            tlsf_block *list_prev = NULL;
+            for (tlsf_block *free = heap->blocks[fl][sl]; free != NULL; free = free->next_free)
+            {
+                int block_fl, block_sl;
+                mapping_insert(block_size(free), &block_fl, &block_sl);
+                if (!block_is_free(free) || (free->prev_free != list_prev) || (block_fl != fl) || (block_sl != sl))
+                {
+                    return false;
+                }
+                list_prev = free;
+                listed_blocks++;
+            }
+        }
+    }
+
+    return listed_blocks == free_blocks;
+}
@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Two-Level Segregated Fit (TLSF) allocator
+//
+//  O(1) malloc / free over a single contiguous pool.  Free blocks are kept in
+//  size-class lists indexed by a first level (power of two) and second level
+//  (linear split of that power of two) bitmap, so finding a fit is two
+//  find-first-set operations.
+//
+//  The control structure (bitmaps + list heads) is separate from the pool so
+//  it can live in SRAM while the pool lives in PSRAM, or it can be placed at
+//  the start of the pool with tlsf_create_in_place().  Block headers are always
+//  inline in the pool.
+//
+//  No SDK dependencies - this file also builds on the host (see host/).
+
+#ifndef TLSF_H
+#define TLSF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define TLSF_ALIGN_SHIFT    3                                   //  8 byte alignment, one XIP cache line
+#define TLSF_ALIGN_SIZE     (1u << TLSF_ALIGN_SHIFT)
+#define TLSF_SL_SHIFT       4                                   //  16 second level lists per first level
+#define TLSF_SL_COUNT       (1u << TLSF_SL_SHIFT)
+#define TLSF_FL_SHIFT       (TLSF_SL_SHIFT + TLSF_ALIGN_SHIFT)
+#define TLSF_FL_MAX         24                                  //  Largest block < 16 MiB
+#define TLSF_FL_COUNT       (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_BLOCK    (1u << TLSF_FL_SHIFT)               //  Sizes below this all map to fl 0
+
+typedef struct tlsf_block tlsf_block;
+
+typedef struct
+{
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    tlsf_block *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+    uint8_t *pool;
+    size_t pool_size;
+
+    //  Running statistics
+    size_t used_size;
+    size_t peak_used_size;
+    uint32_t alloc_count;
+    uint32_t free_count;
+    uint32_t fail_count;
+} tlsf_heap;
+
+typedef struct
+{
+    size_t total_size;          //  Bytes available for payload when the pool is empty
+    size_t used_size;           //  Payload bytes in allocated blocks
+    size_t free_size;           //  Payload bytes in free blocks
+    size_t peak_used_size;
+    size_t largest_free;        //  Largest single allocation that would currently succeed
+    uint32_t used_blocks;
+    uint32_t free_blocks;
+    uint32_t alloc_count;
+    uint32_t free_count;
+    uint32_t fail_count;
+    float fragmentation;        //  1 - largest_free / free_size, 0 = one free block
+} tlsf_stats;
+
+//  Create a heap with the control structure at heap and the blocks in pool
+bool tlsf_create(tlsf_heap *heap, void *pool, size_t pool_size);
+
+//  Create a heap with the control structure at the start of mem
+tlsf_heap *tlsf_create_in_place(void *mem, size_t mem_size);
+
+void *tlsf_malloc(tlsf_heap *heap, size_t size);
+void tlsf_free(tlsf_heap *heap, void *ptr);
+void *tlsf_realloc(tlsf_heap *heap, void *ptr, size_t size);
+
+//  align a power of two, e.g. a QMI page or a DMA ring
+void *tlsf_memalign(tlsf_heap *heap, size_t align, size_t size);
+
+//  Usable size of an allocated block (>= the requested size)
+size_t tlsf_block_size(void *ptr);
+
+//  Walks every block, O(number of blocks)
+void tlsf_get_stats(tlsf_heap *heap, tlsf_stats *stats);
+
+//  Walks every block and list and verifies the heap invariants
+bool tlsf_check(tlsf_heap *heap);
+
+#endif
@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "write_combine.h"
+#include "portable.h"
+
+#define WRITE_COMBINE_OFFSET_MASK   (~WRITE_COMBINE_ADD)
+#define RADIX_BITS                  8
+#define RADIX_SIZE                  (1u << RADIX_BITS)
+
+size_t write_combine_workspace_size(uint32_t capacity)
+{
+    return 2 * capacity * sizeof(write_combine_entry);
+}
+
+bool write_combine_init(write_combine *combine, uint32_t *target, uint32_t target_words, void *workspace, uint32_t capacity)
+{
+    if ((capacity == 0) || (workspace == NULL) || (target_words > WRITE_COMBINE_OFFSET_MASK))
+    {
+        return false;
+    }
+
+    write_combine_stats empty = { 0 };
+
+    combine->target = target;
+    combine->target_words = target_words;
+    combine->entries = (write_combine_entry *)workspace;
+    combine->scratch = combine->entries + capacity;
+    combine->capacity = capacity;
+    combine->count = 0;
+    combine->stats = empty;
+
+    return true;
+}
+
+//  Stable LSD radix sort on the offset bits the target actually uses
+static write_combine_entry *__time_critical_func(sort_entries)(write_combine *combine)
+{
+    uint32_t counts[RADIX_SIZE];
+    write_combine_entry *from = combine->entries;
+    write_combine_entry *to = combine->scratch;
+    uint32_t bits = 32 - __builtin_clz(combine->target_words | 1);
+
+    for (uint32_t shift = 0; shift < bits; shift += RADIX_BITS)
+    {
+        for (uint32_t i = 0; i < RADIX_SIZE; i++)
+        {
+            counts[i] = 0;
+        }
+        for (uint32_t i = 0; i < combine->count; i++)
+        {
+            counts[((from[i].offset & WRITE_COMBINE_OFFSET_MASK) >> shift) & (RADIX_SIZE - 1)]++;
+        }
+
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < RADIX_SIZE; i++)
+        {
+            uint32_t count = counts[i];
+            counts[i] = total;
+            total += count;
+        }
+
+        for (uint32_t i = 0; i < combine->count; i++)
+        {
+            to[counts[((from[i].offset & WRITE_COMBINE_OFFSET_MASK) >> shift) & (RADIX_SIZE - 1)]++] = from[i];
+        }
+
+        write_combine_entry *swap = from;
+        from = to;
+        to = swap;
+    }
+
+    return from;
+}
+
+void __time_critical_func(write_combine_flush)(write_combine *combine)
+{
+    if (combine->count == 0)
+    {
+        return;
+    }
+
+    write_combine_entry *sorted = sort_entries(combine);
+    uint32_t last_page = 0xFFFFFFFF;
+    uint32_t i = 0;
+
+    while (i < combine->count)
+    {
+        uint32_t offset = sorted[i].offset & WRITE_COMBINE_OFFSET_MASK;
+
+        //  Entries for one word are in log order, a store resets, an add accumulates
+        bool stored = false;
+        uint32_t value = 0;
+        for (; (i < combine->count) && ((sorted[i].offset & WRITE_COMBINE_OFFSET_MASK) == offset); i++)
+        {
+            if ((sorted[i].offset & WRITE_COMBINE_ADD) != 0)
+            {
+                value += sorted[i].value;
+            }
+            else
+            {
+                value = sorted[i].value;
+                stored = true;
+            }
+        }
+
+        if (offset < combine->target_words)
+        {
+            combine->target[offset] = stored ? value : (combine->target[offset] + value);
+            combine->stats.applied++;
+
+            uint32_t page = (offset * sizeof(uint32_t)) / WRITE_COMBINE_PAGE_SIZE;
+            if (page != last_page)
+            {
+                combine->stats.pages++;
+                last_page = page;
+            }
+        }
+    }
+
+    combine->count = 0;
+    combine->stats.flushes++;
+}
@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2025 Michael Neil, Far Left Lane
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  SRAM write-combining buffer for scattered PSRAM writes
+//
+//  Stores and increments are logged in SRAM and applied when the log fills
+//  (or on flush) after a stable radix sort by word offset, so each PSRAM page
+//  is visited once per flush, repeated writes to a word collapse into one and
+//  repeated increments (histograms) become one read-modify-write.  The target
+//  is plain memory so this also builds on the host.
+
+#ifndef WRITE_COMBINE_H
+#define WRITE_COMBINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define WRITE_COMBINE_ADD       0x80000000u     //  Entry adds value instead of storing it
+#define WRITE_COMBINE_PAGE_SIZE 1024            //  QMI M1 page break, only used for statistics
+
+typedef struct
+{
+    uint32_t offset;                            //  Word offset, WRITE_COMBINE_ADD for increments
+    uint32_t value;
+} write_combine_entry;
+
+typedef struct
+{
+    uint32_t writes;                            //  Logged stores / increments
+    uint32_t flushes;
+    uint32_t applied;                           //  Words actually written to the target
+    uint32_t pages;                             //  Page visits summed over flushes
+} write_combine_stats;
+
+typedef struct
+{
+    uint32_t *target;
+    uint32_t target_words;
+    write_combine_entry *entries;
+    write_combine_entry *scratch;               //  Radix sort ping-pong
+    uint32_t capacity;
+    uint32_t count;
+    write_combine_stats stats;
+} write_combine;
+
+//  Bytes of SRAM workspace needed for capacity entries
+size_t write_combine_workspace_size(uint32_t capacity);
+
+bool write_combine_init(write_combine *combine, uint32_t *target, uint32_t target_words, void *workspace, uint32_t capacity);
+
+//  Apply every logged entry to the target, in address order
+void write_combine_flush(write_combine *combine);
+
+static inline void write_combine_log(write_combine *combine, uint32_t offset, uint32_t value)
+{
+    combine->entries[combine->count].offset = offset;
+    combine->entries[combine->count].value = value;
+    combine->stats.writes++;
+    if (++combine->count == combine->capacity)
+    {
+        write_combine_flush(combine);
+    }
+}
+
+//  target[index] = value
+static inline void write_combine_store(write_combine *combine, uint32_t index, uint32_t value)
+{
+    write_combine_log(combine, index, value);
+}
+
+//  target[index] += value
+static inline void write_combine_add(write_combine *combine, uint32_t index, uint32_t value)
+{
+    write_combine_log(combine, index | WRITE_COMBINE_ADD, value);
+}
+
+#endif